@@ -43,6 +43,19 @@ void AbstractStringLayout::formatTo(const LoggingEvent &event, QByteArray &dest)
     dest += format(event).toUtf8();
 }
 
+void AbstractStringLayout::formatHeaderTo(QByteArray &dest, bool appending)
+{
+    if (appending)
+        return;
+    const QString text = header();
+    if (!text.isEmpty())
+        dest += text.toUtf8() + endOfLine().toUtf8();
+}
+
+void AbstractStringLayout::formatPendingTo(QByteArray & /*dest*/, qsizetype & /*written*/)
+{
+}
+
 QByteArray &AbstractStringLayout::threadLocalBuffer()
 {
     thread_local QByteArray buf;
@@ -106,6 +106,31 @@ public:
      */
     virtual void formatTo(const LoggingEvent &event, QByteArray &dest);
 
+    /*!
+     * Appends what starts a file to \a dest. \a appending is \c true when
+     * the file already holds output of an earlier run.
+     *
+     * The default implementation appends the header followed by
+     * \c endOfLine(), unless \a appending is \c true or the header is
+     * empty. Layouts with a file format of their own override it.
+     *
+     * \sa header(), RandomAccessFileAppender
+     */
+    virtual void formatHeaderTo(QByteArray &dest, bool appending);
+
+    /*!
+     * Appends what formatted events rely on but the file does not hold yet.
+     * \a written marks how far the file is served: the appender keeps one
+     * marker per file, sets it to 0 when it opens the file, and calls this
+     * under its lock before it writes output of formatTo(). The layout
+     * advances the marker.
+     *
+     * The default implementation appends nothing.
+     *
+     * \sa BinaryLayout, RandomAccessFileAppender
+     */
+    virtual void formatPendingTo(QByteArray &dest, qsizetype &written);
+
     /*!
      * Returns a reference to the calling thread's scratch buffer.
      *
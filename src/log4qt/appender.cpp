@@ -19,6 +19,7 @@
  ******************************************************************************/
 
 #include "appender.h"
+#include "loggingevent.h"
 
 namespace Log4Qt
 {
@@ -30,6 +31,12 @@ Appender::Appender(QObject *parent) :
 
 Appender::~Appender() = default;
 
+void Appender::doAppendBatch(std::span<const LoggingEvent> events)
+{
+    for (const auto &event : events)
+        doAppend(event);
+}
+
 Logger *Appender::logger() const
 {
     return mLog4QtClassLogger.logger(this);
@@ -26,6 +26,8 @@
 #include "spi/filter.h"
 #include "helpers/classlogger.h"
 
+#include <span>
+
 namespace Log4Qt
 {
 
@@ -83,6 +85,19 @@ public:
     virtual void close() = 0;
     virtual void doAppend(const LoggingEvent &event) = 0;
 
+    /*!
+     * Appends all \a events, in order, as if doAppend() was called for each
+     * of them.
+     *
+     * Producers that hand over several events at once (e.g. the AsyncAppender
+     * worker) call this so that an appender can amortise its per-call costs
+     * — entry checks, locking and flushing — over the whole batch. The
+     * default implementation calls doAppend() for every event.
+     *
+     * \sa AppenderSkeleton::doAppendBatch()
+     */
+    virtual void doAppendBatch(std::span<const LoggingEvent> events);
+
 protected:
     /*!
      * Returns a pointer to a Logger named after of the object.
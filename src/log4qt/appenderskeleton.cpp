@@ -25,7 +25,9 @@
 #include "spi/filter.h"
 #include "logger.h"
 
-#include <QScopeGuard>
+#include <QVarLengthArray>
+
+#include <memory>
 
 using namespace Qt::StringLiterals;
 
@@ -60,12 +62,30 @@ struct AppendStack
 };
 thread_local AppendStack s_appendStack {};
 
+// Walks the filter chain starting at filter. Filter::decide() is const, so
+// this runs outside mObjectGuard on a snapshot of the head filter.
+static bool isAcceptedByFilters(const Filter *filter, const LoggingEvent &event)
+{
+    while (filter)
+    {
+        const Filter::Decision decision = filter->decide(event);
+        if (decision == Filter::Accept)
+            return true;
+        else if (decision == Filter::Deny)
+            return false;
+        else
+            filter = filter->next().data();
+    }
+    return true;
+}
+
 AppenderSkeleton::AppenderSkeleton(QObject *parent)
     : Appender(parent)
     , mThreshold(Level::NULL_INT)
 {
     mIsActive.store(true, std::memory_order_relaxed);
     mIsClosed.store(false, std::memory_order_relaxed);
+    publishConfig();
 }
 
 AppenderSkeleton::AppenderSkeleton(bool isActive,
@@ -75,6 +95,7 @@ AppenderSkeleton::AppenderSkeleton(bool isActive,
 {
     mIsActive.store(isActive, std::memory_order_relaxed);
     mIsClosed.store(false, std::memory_order_relaxed);
+    publishConfig();
 }
 
 AppenderSkeleton::AppenderSkeleton(bool isActive,
@@ -86,6 +107,7 @@ AppenderSkeleton::AppenderSkeleton(bool isActive,
 {
     mIsActive.store(isActive, std::memory_order_relaxed);
     mIsClosed.store(false, std::memory_order_relaxed);
+    publishConfig();
 }
 
 AppenderSkeleton::~AppenderSkeleton()
@@ -110,6 +132,7 @@ void AppenderSkeleton::activateOptions()
     // overrides, so the closed flag must be cleared alongside setting active.
     mIsClosed.store(false, std::memory_order_relaxed);
     mIsActive.store(true, std::memory_order_relaxed);
+    publishConfig();
 }
 
 void AppenderSkeleton::addFilter(const FilterSharedPtr &filter)
@@ -134,6 +157,7 @@ void AppenderSkeleton::addFilter(const FilterSharedPtr &filter)
         mpTailFilter->setNext(filter);
         mpTailFilter = filter;
     }
+    publishConfig();
 }
 
 void AppenderSkeleton::clearFilters()
@@ -145,6 +169,7 @@ void AppenderSkeleton::clearFilters()
     // chain onto the orphaned old list while the head stays null, so filters
     // added after clearFilters() would never be evaluated.
     mpTailFilter.reset();
+    publishConfig();
 }
 
 void AppenderSkeleton::close()
@@ -158,6 +183,16 @@ void AppenderSkeleton::closeInternal()
 
     mIsClosed.store(true, std::memory_order_relaxed);
     mIsActive.store(false, std::memory_order_relaxed);
+    publishConfig();
+}
+
+void AppenderSkeleton::publishConfig()
+{
+    mConfig.store(std::make_shared<const Config>(Config{mThreshold.load(std::memory_order_relaxed),
+                                                        mpHeadFilter,
+                                                        mpLayout,
+                                                        isActive(),
+                                                        isClosed()}));
 }
 
 void AppenderSkeleton::customEvent(QEvent *event)
@@ -171,6 +206,36 @@ void AppenderSkeleton::customEvent(QEvent *event)
     QObject::customEvent(event);
 }
 
+AppenderSkeleton::AppendGuard::AppendGuard(const AppenderSkeleton *appender)
+    : mEntered(s_appendStack.depth < AppendStack::MaxDepth && !s_appendStack.contains(appender))
+{
+    if (mEntered)
+        s_appendStack.appenders[s_appendStack.depth++] = appender;
+}
+
+AppenderSkeleton::AppendGuard::~AppendGuard()
+{
+    if (mEntered)
+        --s_appendStack.depth;
+}
+
+bool AppenderSkeleton::isAccepted(const LoggingEvent &event) const
+{
+    // Phases 2 to 4 of doAppend(), without preAppend()
+    const auto config = mConfig.load();
+    if (!config->isActive || config->isClosed)
+        return false;
+    if (!(config->threshold <= event.level()))
+        return false;
+    if (!config->layout && requiresLayout())
+    {
+        QMutexLocker locker(&mObjectGuard);
+        checkEntryConditions();
+        return false;
+    }
+    return isAcceptedByFilters(config->headFilter.data(), event);
+}
+
 void AppenderSkeleton::doAppend(const LoggingEvent &event)
 {
     // Phase 1 — per-appender recursion guard (thread-local, no lock needed).
@@ -178,68 +243,103 @@ void AppenderSkeleton::doAppend(const LoggingEvent &event)
     // through a logger that routes back to an appender already appending on
     // this thread; every other appender still receives such diagnostics.
     // MaxDepth bounds pathological dispatch chains.
-    if (s_appendStack.depth >= AppendStack::MaxDepth || s_appendStack.contains(this))
+    const AppendGuard guard(this);
+    if (!guard)
         return;
 
-    s_appendStack.appenders[s_appendStack.depth++] = this;
-    const auto stackGuard = qScopeGuard([]{ --s_appendStack.depth; });
-
-    // Phase 2 — fast pre-checks via atomics (no lock needed).
-    if (!isActive() || isClosed())
+    // Phase 2 — configuration snapshot (no lock needed). The snapshot keeps
+    // the filter chain and layout alive even if the appender is reconfigured
+    // or closed while this event is being processed.
+    const auto config = mConfig.load();
+    if (!config->isActive || config->isClosed)
         return;
 
-    // Phase 3 — entry conditions + config snapshot (under lock, then release).
-    // mpHeadFilter and mpLayout are snapshots: they keep their objects alive
-    // even if the appender is reconfigured or closed after we drop the lock.
-    FilterSharedPtr headFilter;
-    LayoutSharedPtr layoutSnap;
+    // Phase 3 — threshold and layout.
+    if (!(config->threshold <= event.level()))
+        return;
+    if (!config->layout && requiresLayout())
     {
+        // Let the entry conditions report the missing layout
         QMutexLocker locker(&mObjectGuard);
-
-        if (!checkEntryConditions())
-            return;
-        if (!isAsSevereAsThreshold(event.level()))
-            return;
-
-        headFilter  = mpHeadFilter;
-        layoutSnap  = mpLayout;
-    } // mObjectGuard released — expensive work happens outside the lock
-
-    // Phase 4 — filter chain (outside lock, filter::decide() is const).
-    const auto *filter = headFilter.data();
-    while (filter)
-    {
-        const Filter::Decision decision = filter->decide(event);
-        if (decision == Filter::Accept)
-            break;
-        else if (decision == Filter::Deny)
-            return;
-        else
-            filter = filter->next().data();
+        checkEntryConditions();
+        return;
     }
 
-    // Phase 4b — pre-format hook (outside lock).
+    // Phase 4 — filter chain (filter::decide() is const).
+    if (!isAcceptedByFilters(config->headFilter.data(), event))
+        return;
+
+    // Phase 4b — pre-format hook.
     // Subclasses such as RandomAccessFileAppender override this to encode the
     // log message into a thread-local buffer while the lock is free, so that
     // multiple threads can format concurrently.
-    preAppend(event, layoutSnap);
+    preAppend(event, config->layout);
 
     // Phase 5 — actual I/O (under lock).
-    // Re-check the full entry conditions: close(), setWriter(nullptr) or a
-    // reconfiguration may have torn down the appender's resources while the
-    // lock was released during Phases 4–4b. isActive() alone does not cover
-    // subclass resources (writer, file, dispatcher thread).
+    // The full entry conditions are only checked here: close(),
+    // setWriter(nullptr) or a reconfiguration may tear down the appender's
+    // resources at any time before the lock is taken, and the snapshot does
+    // not cover subclass resources (writer, file, dispatcher thread).
     QMutexLocker locker(&mObjectGuard);
     if (checkEntryConditions())
         append(event);
 }
 
+void AppenderSkeleton::doAppendBatch(std::span<const LoggingEvent> events)
+{
+    if (events.empty())
+        return;
+
+    // Phases 1–3 as in doAppend(), but once for the whole batch.
+    const AppendGuard guard(this);
+    if (!guard)
+        return;
+
+    const auto config = mConfig.load();
+    if (!config->isActive || config->isClosed)
+        return;
+    if (!config->layout && requiresLayout())
+    {
+        QMutexLocker locker(&mObjectGuard);
+        checkEntryConditions();
+        return;
+    }
+
+    // Phases 3–4 — threshold and filter chain per event (no lock). The entry
+    // conditions are checked by appendBatch() under the lock.
+    QVarLengthArray<const LoggingEvent *, 128> accepted;
+    for (const auto &event : events)
+    {
+        if (config->threshold <= event.level() && isAcceptedByFilters(config->headFilter.data(), event))
+            accepted.append(&event);
+    }
+
+    if (!accepted.isEmpty())
+        appendBatch(std::span<const LoggingEvent *const>(accepted.constData(), static_cast<std::size_t>(accepted.size())),
+                    config->layout);
+}
+
 void AppenderSkeleton::preAppend(const LoggingEvent & /*event*/, const LayoutSharedPtr & /*layout*/)
 {
     // Default implementation: no-op.
     // Subclasses that want to pre-format outside the lock override this.
 }
 
+void AppenderSkeleton::appendBatch(std::span<const LoggingEvent *const> events, const LayoutSharedPtr &layout)
+{
+    // Default: Phases 4b and 5 of doAppend() per event, so preAppend() keeps
+    // running outside the lock and stays paired with its append().
+    for (const auto *event : events)
+    {
+        preAppend(*event, layout);
+
+        QMutexLocker locker(&mObjectGuard);
+        if (!checkEntryConditions())
+            return;
+        append(*event);
+    }
+}
+
 void AppenderSkeleton::forwardEvent(const AppenderSharedPtr &appender, const LoggingEvent &event)
 {
     if (!appender)
@@ -284,18 +384,24 @@ void Log4Qt::AppenderSkeleton::setLayout(const LayoutSharedPtr &layout)
 {
     QMutexLocker locker(&mObjectGuard);
     mpLayout = layout;
+    publishConfig();
 }
 
 LayoutSharedPtr Log4Qt::AppenderSkeleton::layout() const
 {
-    QMutexLocker locker(&mObjectGuard);
-    return mpLayout;
+    return mConfig.load()->layout;
 }
 
 FilterSharedPtr AppenderSkeleton::filter() const
+{
+    return mConfig.load()->headFilter;
+}
+
+void AppenderSkeleton::setThreshold(Level level)
 {
     QMutexLocker locker(&mObjectGuard);
-    return mpHeadFilter;
+    mThreshold = level;
+    publishConfig();
 }
 
 QString AppenderSkeleton::name() const
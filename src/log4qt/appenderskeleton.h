@@ -26,6 +26,7 @@
 #include "abstractlayout.h"
 #include "spi/filter.h"
 #include "logger.h"
+#include "helpers/atomicsharedptr.h"
 
 #include <QMutex>
 #include <atomic>
@@ -89,7 +90,7 @@ public:
     [[nodiscard]] Level threshold() const { return mThreshold; }
     void setLayout(const LayoutSharedPtr &layout) override;
     void setName(const QString &name) override;
-    void setThreshold(Level level) { mThreshold = level; }
+    void setThreshold(Level level);
 
     virtual void activateOptions();
     void addFilter(const FilterSharedPtr &filter) override;
@@ -104,30 +105,42 @@ public:
      *     infinite loops when an appender internally logs a message through
      *     a logger that routes back to an appender that is already appending
      *     on the same thread; other appenders still receive such messages.
-     * \li Phase 2 — Fast atomic pre-checks (\c isActive(), \c isClosed())
-     *     without acquiring the lock.
-     * \li Phase 3 — Entry conditions (\c checkEntryConditions()), threshold
-     *     and filter-chain/layout snapshot, all under \c mObjectGuard. The
-     *     lock is released at the end of this phase.
-     * \li Phase 4 — Filter chain evaluation and \c preAppend() call, both
-     *     \e outside \c mObjectGuard. Multiple threads may execute this phase
-     *     concurrently.
-     * \li Phase 5 — Re-check of the entry conditions followed by the
-     *     \c append() call, both under \c mObjectGuard. Serialises the
+     * \li Phase 2 — Load of the immutable configuration snapshot (active
+     *     and closed flags, threshold, head filter, layout) that the setters
+     *     republish. Inactive or closed appenders return here.
+     * \li Phase 3 — Threshold check against the snapshot. An appender that
+     *     requires a layout but has none reports the error through
+     *     \c checkEntryConditions() and returns.
+     * \li Phase 4 — Filter chain evaluation and \c preAppend() call.
+     *     Multiple threads may execute this phase concurrently.
+     * \li Phase 5 — Entry conditions (\c checkEntryConditions()) followed by
+     *     the \c append() call, both under \c mObjectGuard. Serialises the
      *     actual I/O across threads and guards against resources torn down
-     *     (\c close(), writer/file removal) while the lock was released
-     *     during Phase 4.
+     *     (\c close(), writer/file removal) concurrently.
+     *
+     * Phases 1 to 4 take no lock; \c mObjectGuard is acquired once per
+     * event, for Phase 5. Subclass specific entry conditions are therefore
+     * only checked after \c preAppend().
      *
      * \sa append(), preAppend(), checkEntryConditions(),
      *     isAsSevereAsThreshold(), Filter
      */
     void doAppend(const LoggingEvent &event) override;
 
-    FilterSharedPtr firstFilter() const
-    {
-        QMutexLocker locker(&mObjectGuard);
-        return filter();
-    }
+    /*!
+     * Batch counterpart of doAppend().
+     *
+     * Runs the recursion guard and loads the configuration snapshot
+     * (Phases 1–2) once for the whole batch. The threshold and the filter
+     * chain are still evaluated per event; the accepted events are passed to
+     * appendBatch() in their original order, which checks the entry
+     * conditions under the lock.
+     *
+     * \sa appendBatch(), doAppend()
+     */
+    void doAppendBatch(std::span<const LoggingEvent> events) override;
+
+    FilterSharedPtr firstFilter() const { return filter(); }
     bool isAsSevereAsThreshold(Level level) const { return (mThreshold <= level); }
 
 protected:
@@ -162,15 +175,15 @@ protected:
      * Optional hook called \e outside \c mObjectGuard, after all entry checks
      * have passed and the filter chain has accepted the event.
      *
-     * \c doAppend() calls this function between releasing the appender lock
-     * (after snapshotting the filter chain and layout) and re-acquiring it for
-     * the actual \c append() call. This window allows subclasses to perform
-     * expensive, purely read-only preparation work — most commonly layout
-     * formatting — while other threads are free to run their own \c preAppend()
-     * calls in parallel.
+     * \c doAppend() calls this function after the filter chain of the
+     * configuration snapshot accepted the event and before acquiring the
+     * appender lock for the actual \c append() call. This window allows
+     * subclasses to perform expensive, purely read-only preparation work —
+     * most commonly layout formatting — while other threads are free to run
+     * their own \c preAppend() calls in parallel.
      *
      * \par Contract
-     * \li \a layout is a \c QSharedPointer snapshot taken under the lock; it
+     * \li \a layout is a \c QSharedPointer snapshot of the configuration; it
      *     remains valid for the full duration of this call even if the
      *     appender's layout is replaced concurrently.
      * \li The function must be stateless with respect to shared appender data.
@@ -187,6 +200,22 @@ protected:
      */
     virtual void preAppend(const LoggingEvent &event, const LayoutSharedPtr &layout);
 
+    /*!
+     * Appends the \a events accepted by doAppendBatch(). Called \e outside
+     * \c mObjectGuard with the \a layout snapshot taken for the batch.
+     *
+     * The default implementation keeps the per-event contract of doAppend():
+     * for every event it calls preAppend() outside the lock, then re-checks
+     * the entry conditions and calls append() under \c mObjectGuard.
+     *
+     * Appenders that can write a whole batch at once override this to format
+     * outside the lock and then take \c mObjectGuard, re-check the entry
+     * conditions and write and flush only once.
+     *
+     * \sa doAppendBatch(), WriterAppender, RandomAccessFileAppender
+     */
+    virtual void appendBatch(std::span<const LoggingEvent *const> events, const LayoutSharedPtr &layout);
+
     /*!
      * Forwards \a event to \a appender via its \c doAppend() entry point.
      *
@@ -203,6 +232,35 @@ protected:
      */
     static void forwardEvent(const AppenderSharedPtr &appender, const LoggingEvent &event);
 
+    /*!
+     * \brief Phase 1 of doAppend() for subclasses that override it.
+     *
+     * Puts the appender on the calling thread's stack of appending appenders
+     * for the lifetime of the object. Converts to false, and does nothing,
+     * if the appender is already on the stack or the stack is full; the
+     * event must then be dropped.
+     */
+    class LOG4QT_EXPORT AppendGuard
+    {
+    public:
+        explicit AppendGuard(const AppenderSkeleton *appender);
+        ~AppendGuard();
+
+        explicit operator bool() const { return mEntered; }
+
+    private:
+        Q_DISABLE_COPY_MOVE(AppendGuard)
+        const bool mEntered;
+    };
+
+    /*!
+     * Phases 2 to 4 of doAppend() for subclasses that override it: returns
+     * true if the appender is active and not closed, \a event passes the
+     * threshold and the filter chain, and a required layout is set. Takes no
+     * lock, except to report a missing layout.
+     */
+    [[nodiscard]] bool isAccepted(const LoggingEvent &event) const;
+
 protected:
     /*!
      * Lock-free read of the layout snapshot. Callable only while \c mObjectGuard
@@ -223,6 +281,20 @@ private:
     FilterSharedPtr mpHeadFilter;
     FilterSharedPtr mpTailFilter;
     void closeInternal();
+
+    // Immutable copy of the state doAppend() needs before the I/O phase
+    struct Config
+    {
+        Level threshold;
+        FilterSharedPtr headFilter;
+        LayoutSharedPtr layout;
+        bool isActive;
+        bool isClosed;
+    };
+    // Republishes mConfig from the members above. Called with mObjectGuard
+    // held (or from a constructor) after every change to them.
+    void publishConfig();
+    AtomicSharedPtr<const Config> mConfig;
 };
 
 } // namespace Log4Qt
@@ -21,11 +21,13 @@
 #include "asyncappender.h"
 #include "helpers/asyncworker.h"
 #include "helpers/boundedblockingqueue.h"
+#include "helpers/mpscringqueue.h"
 #include "logger.h"
 #include "loggerrepository.h"
 #include "loggingevent.h"
 #include "logmanager.h"
 
+#include <QDeadlineTimer>
 #include <QReadLocker>
 
 using namespace Qt::StringLiterals;
@@ -61,6 +63,71 @@ void AsyncAppender::setBufferSize(int size)
     mBufferSize = size;
 }
 
+void AsyncAppender::setBatchSize(int size)
+{
+    if (size <= 0)
+    {
+        logger()->warn(u"AsyncAppender '%1': invalid batchSize %2, clamping to 1"_s
+                       .arg(name()).arg(size));
+        size = 1;
+    }
+    mBatchSize = size;
+}
+
+void AsyncAppender::setWorkerCount(int count)
+{
+    if (count <= 0)
+    {
+        logger()->warn(u"AsyncAppender '%1': invalid workerCount %2, clamping to 1"_s
+                       .arg(name()).arg(count));
+        count = 1;
+    }
+    mWorkerCount = count;
+}
+
+QString AsyncAppender::shardKey() const
+{
+    QMutexLocker locker(&mObjectGuard);
+    switch (mShardKey)
+    {
+    case ShardKey::Thread:  return QStringLiteral("Thread");
+    case ShardKey::Mdc:     return QStringLiteral("MDC:") + mShardMdcKey;
+    default:                return QStringLiteral("Logger");
+    }
+}
+
+void AsyncAppender::setShardKey(const QString &key)
+{
+    auto shardKey = ShardKey::Logger;
+    QString mdcKey;
+    bool valid = true;
+    if (key.compare(u"Thread", Qt::CaseInsensitive) == 0)
+    {
+        shardKey = ShardKey::Thread;
+    }
+    else if (key.startsWith(u"MDC:", Qt::CaseInsensitive) && !key.mid(4).trimmed().isEmpty())
+    {
+        shardKey = ShardKey::Mdc;
+        mdcKey = key.mid(4).trimmed();
+    }
+    else
+    {
+        valid = key.compare(u"Logger", Qt::CaseInsensitive) == 0;
+    }
+
+    {
+        QMutexLocker locker(&mObjectGuard);
+        // Not republished: moving a running key to another shard would
+        // break the per-key order. activateOptions() applies it.
+        mShardKey = shardKey;
+        mShardMdcKey = mdcKey;
+    }
+
+    if (!valid)
+        logger()->warn(u"AsyncAppender '%1': invalid shardKey '%2', using Logger"_s
+                       .arg(name(), key));
+}
+
 void AsyncAppender::setQueueFullPolicy(QueueFullPolicy policy)
 {
     mQueueFullPolicy = policy;
@@ -86,6 +153,21 @@ void AsyncAppender::setQueueFullPolicyString(const QString &policy)
         mQueueFullPolicy = QueueFullPolicy::Block;
 }
 
+QString AsyncAppender::queueImplementationString() const
+{
+    if (mQueueImplementation == QueueImplementation::LockFree)
+        return QStringLiteral("LockFree");
+    return QStringLiteral("Blocking");
+}
+
+void AsyncAppender::setQueueImplementationString(const QString &implementation)
+{
+    if (implementation.compare(u"LockFree", Qt::CaseInsensitive) == 0)
+        mQueueImplementation = QueueImplementation::LockFree;
+    else
+        mQueueImplementation = QueueImplementation::Blocking;
+}
+
 void AsyncAppender::setErrorAppender(const AppenderSharedPtr &appender)
 {
     QMutexLocker locker(&mObjectGuard);
@@ -148,14 +230,28 @@ void AsyncAppender::activateOptions()
     {
         QMutexLocker locker(&mObjectGuard);
 
-        if (mWorker)
+        if (!mWorkers.empty())
             return;
 
-        mQueue = std::make_unique<BoundedBlockingQueue<LoggingEvent>>(mBufferSize);
+        const int workerCount = mWorkerCount;
+        mQueues.reserve(static_cast<std::size_t>(workerCount));
+        mWorkers.reserve(static_cast<std::size_t>(workerCount));
+        for (int i = 0; i < workerCount; ++i)
+        {
+            if (mQueueImplementation == QueueImplementation::LockFree)
+                mQueues.push_back(std::make_shared<MpscRingQueue<LoggingEvent>>(mBufferSize));
+            else
+                mQueues.push_back(std::make_shared<BoundedBlockingQueue<LoggingEvent>>(mBufferSize));
 
-        mWorker = std::make_unique<AsyncWorker>(this, mQueue.get());
-        mWorker->setObjectName(QStringLiteral("Log4Qt-Async-%1").arg(name()));
-        mWorker->start();
+            auto worker = std::make_unique<AsyncWorker>(this, mQueues.back().get());
+            if (workerCount == 1)
+                worker->setObjectName(QStringLiteral("Log4Qt-Async-%1").arg(name()));
+            else
+                worker->setObjectName(QStringLiteral("Log4Qt-Async-%1-%2").arg(name()).arg(i));
+            worker->start();
+            mWorkers.push_back(std::move(worker));
+        }
+        publishDispatch();
     }
 
     // Outside the lock: the lookup takes repository and logger locks.
@@ -177,31 +273,41 @@ void AsyncAppender::closeInternal()
     if (isClosed())
         return;
 
-    if (mQueue)
-        mQueue->shutdown();
-
-    if (mWorker)
+    // Producers that loaded the dispatch before this see the queues shut
+    // down; an event that still slips into a lock-free queue after the
+    // worker's last drain is dropped with the queue, like one logged after
+    // close().
+    mDispatch.store(nullptr);
+    for (const auto &queue : mQueues)
+        queue->shutdown();
+
+    // One deadline for all shards: the workers drain in parallel
+    const QDeadlineTimer deadline = (mShutdownTimeout > 0)
+        ? QDeadlineTimer(mShutdownTimeout)
+        : QDeadlineTimer(QDeadlineTimer::Forever);
+
+    bool timedOut = false;
+    for (const auto &worker : mWorkers)
     {
-        const unsigned long timeout = (mShutdownTimeout > 0)
-            ? static_cast<unsigned long>(mShutdownTimeout)
-            : ULONG_MAX;
+        if (worker->wait(deadline))
+            continue;
 
-        if (!mWorker->wait(timeout))
+        if (!timedOut)
         {
             LogError e = LOG4QT_QCLASS_ERROR(
                 "Shutdown timeout expired for async appender '%1' with events still in queue",
                 AppenderAsyncShutdownTimeout);
             e << name();
             logger()->warn(e);
-
-            mWorker->terminate();
-            mWorker->wait();
+            timedOut = true;
         }
 
-        mWorker.reset();
+        worker->terminate();
+        worker->wait();
     }
 
-    mQueue.reset();
+    mWorkers.clear();
+    mQueues.clear();
 }
 
 // --- Appending ---------------------------------------------------------------
@@ -214,27 +320,94 @@ void AsyncAppender::callAppenders(const LoggingEvent &event) const
         forwardEvent(appender, event);
 }
 
-void AsyncAppender::append(const LoggingEvent &event)
+void AsyncAppender::callAppenders(std::span<const LoggingEvent> events) const
+{
+    QReadLocker locker(&mAppenderGuard);
+
+    for (const auto &appender : mAppenders)
+    {
+        if (appender)
+            appender->doAppendBatch(events);
+    }
+}
+
+void AsyncAppender::publishDispatch()
+{
+    mDispatch.store(std::make_shared<const Dispatch>(Dispatch{mQueues, mShardKey, mShardMdcKey}));
+}
+
+BlockingQueue<LoggingEvent> *AsyncAppender::queueFor(const Dispatch &dispatch, const LoggingEvent &event)
+{
+    if (dispatch.queues.size() == 1)
+        return dispatch.queues.front().get();
+
+    // Fixed seed: the shard of a key must not change while the appender runs
+    std::size_t hash;
+    switch (dispatch.shardKey)
+    {
+    case ShardKey::Thread:  hash = qHash(event.threadName(), 0); break;
+    case ShardKey::Mdc:     hash = qHash(event.property(dispatch.shardMdcKey), 0); break;
+    default:                hash = qHash(event.loggername(), 0); break;
+    }
+    return dispatch.queues[hash % dispatch.queues.size()].get();
+}
+
+void AsyncAppender::doAppend(const LoggingEvent &event)
+{
+    const AppendGuard guard(this);
+    if (!guard || !isAccepted(event))
+        return;
+
+    const auto dispatch = mDispatch.load();
+    if (!dispatch)
+    {
+        // Not activated yet, or closed since isAccepted()
+        QMutexLocker locker(&mObjectGuard);
+        checkEntryConditions();
+        return;
+    }
+    dispatchEvent(*dispatch, event);
+}
+
+void AsyncAppender::appendBatch(std::span<const LoggingEvent *const> events, const LayoutSharedPtr & /*layout*/)
 {
-    if (!mQueue)
+    const auto dispatch = mDispatch.load();
+    if (!dispatch)
+    {
+        QMutexLocker locker(&mObjectGuard);
+        checkEntryConditions();
         return;
+    }
+    for (const auto *event : events)
+        dispatchEvent(*dispatch, *event);
+}
+
+void AsyncAppender::append(const LoggingEvent &event)
+{
+    if (const auto dispatch = mDispatch.load())
+        dispatchEvent(*dispatch, event);
+}
+
+void AsyncAppender::dispatchEvent(const Dispatch &dispatch, const LoggingEvent &event)
+{
+    BlockingQueue<LoggingEvent> *queue = queueFor(dispatch, event);
 
     switch (mQueueFullPolicy)
     {
     case QueueFullPolicy::Block:
         if (mBlocking)
         {
-            mQueue->enqueue(event);
+            queue->enqueue(event);
         }
         else
         {
-            if (!mQueue->tryEnqueue(event))
+            if (!queue->tryEnqueue(event))
                 handleQueueFull(event);
         }
         break;
 
     case QueueFullPolicy::Discard:
-        if (!mQueue->tryEnqueue(event))
+        if (!queue->tryEnqueue(event))
         {
             if (event.level() <= mDiscardThreshold)
             {
@@ -243,13 +416,13 @@ void AsyncAppender::append(const LoggingEvent &event)
             else
             {
                 // Events above the discard threshold still block
-                mQueue->enqueue(event);
+                queue->enqueue(event);
             }
         }
         break;
 
     case QueueFullPolicy::Synchronous:
-        if (!mQueue->tryEnqueue(event))
+        if (!queue->tryEnqueue(event))
             callAppenders(event);
         break;
     }
@@ -257,24 +430,31 @@ void AsyncAppender::append(const LoggingEvent &event)
 
 void AsyncAppender::handleQueueFull(const LoggingEvent &event)
 {
-    // Deliberately no errorRef lookup here: this runs under mObjectGuard on
-    // the producing thread (doAppend() phase 5), so a repository search would
-    // serialise every producer for its duration — exactly when the appender is
-    // already saturated — and would invert the lock order of the logging path
-    // (see resolveErrorAppender()). The reference is resolved once, by the
-    // configurator after all appenders exist or in activateOptions().
-    if (mErrorAppender)
+    // Deliberately no errorRef lookup here: this runs on the producing
+    // thread, so a repository search would stall every producer that hits a
+    // full queue — exactly when the appender is already saturated. The
+    // reference is resolved once, by the configurator after all appenders
+    // exist or in activateOptions().
+    AppenderSharedPtr errorAppender;
+    QString errorRef;
+    {
+        QMutexLocker locker(&mObjectGuard);
+        errorAppender = mErrorAppender;
+        errorRef = mErrorRef;
+    }
+
+    if (errorAppender)
     {
-        forwardEvent(mErrorAppender, event);
+        forwardEvent(errorAppender, event);
         return;
     }
 
-    if (!mErrorRef.isEmpty())
+    if (!errorRef.isEmpty())
     {
         LogError e = LOG4QT_QCLASS_ERROR(
             "Async appender '%1' queue is full, event dropped: errorRef '%2' was never resolved to an appender",
             AppenderAsyncQueueFull);
-        e << name() << mErrorRef;
+        e << name() << errorRef;
         logger()->warn(e);
         return;
     }
@@ -289,14 +469,17 @@ void AsyncAppender::handleQueueFull(const LoggingEvent &event)
 bool AsyncAppender::checkEntryConditions() const
 {
     QMutexLocker locker(&mObjectGuard);
-    if (mWorker && !mWorker->isRunning())
+    for (const auto &worker : mWorkers)
     {
-        LogError e = LOG4QT_QCLASS_ERROR(
-            "Use of appender '%1' without a running dispatcher thread",
-            AppenderAsncDispatcherNotRunning);
-        e << name();
-        logger()->error(e);
-        return false;
+        if (!worker->isRunning())
+        {
+            LogError e = LOG4QT_QCLASS_ERROR(
+                "Use of appender '%1' without a running dispatcher thread",
+                AppenderAsncDispatcherNotRunning);
+            e << name();
+            logger()->error(e);
+            return false;
+        }
     }
 
     return AppenderSkeleton::checkEntryConditions();
@@ -27,13 +27,15 @@
 
 #include <atomic>
 #include <memory>
+#include <span>
+#include <vector>
 
 namespace Log4Qt
 {
 
 class AsyncWorker;
 class LoggingEvent;
-template<typename T> class BoundedBlockingQueue;
+template<typename T> class BlockingQueue;
 
 /*!
  * \brief The class AsyncAppender lets users log events asynchronously.
@@ -55,6 +57,20 @@ template<typename T> class BoundedBlockingQueue;
  *     thread, bypassing the queue.
  * \endlist
  *
+ * The queue itself is selected with the \l queueImplementation property:
+ * the default mutex-based BoundedBlockingQueue, or the lock-free
+ * MpscRingQueue, which keeps producers off a shared mutex when many threads
+ * log through the same AsyncAppender. Both honour every queue-full policy.
+ * Producers do not take the appender lock: doAppend() checks the event and
+ * enqueues it through a snapshot of the queues, so the queue is the only
+ * state logging threads share.
+ *
+ * Setting \l workerCount above 1 shards the appender: events are hashed by
+ * \l shardKey onto one of several queues, each drained by its own worker
+ * thread. Events with the same key keep their order; events with different
+ * keys may reach the attached appenders in any order and concurrently, so
+ * formatting and writing scale across cores.
+ *
  * The fallback appender used on overflow is either assigned directly with
  * setErrorAppender() or named through the \l errorRef property. A named
  * reference is resolved off the append path: a configurator resolves it once
@@ -83,6 +99,28 @@ class LOG4QT_EXPORT AsyncAppender final : public AppenderSkeleton, public Append
      */
     Q_PROPERTY(int bufferSize READ bufferSize WRITE setBufferSize)
 
+    /*!
+     * The maximum number of events the worker takes from the queue and
+     * hands to each attached appender in one doAppendBatch() call. 1
+     * dispatches event by event. The default is 64.
+     */
+    Q_PROPERTY(int batchSize READ batchSize WRITE setBatchSize)
+
+    /*!
+     * The number of queues and worker threads. Applied when
+     * activateOptions() is called. The default is 1.
+     */
+    Q_PROPERTY(int workerCount READ workerCount WRITE setWorkerCount)
+
+    /*!
+     * What selects the worker of an event when \l workerCount is above 1:
+     * "Logger", "Thread", or "MDC:<key>" for the value of an MDC entry.
+     * Applied when activateOptions() is called, so events with the same key
+     * never move to another shard while the appender runs. The default is
+     * "Logger".
+     */
+    Q_PROPERTY(QString shardKey READ shardKey WRITE setShardKey)
+
     /*!
      * If true (default), the calling thread blocks when the queue is
      * full (Block policy). If false, the event is routed to the error
@@ -108,6 +146,12 @@ class LOG4QT_EXPORT AsyncAppender final : public AppenderSkeleton, public Append
      */
     Q_PROPERTY(QString queueFullPolicy READ queueFullPolicyString WRITE setQueueFullPolicyString)
 
+    /*!
+     * The queue implementation as a string: "Blocking" or "LockFree".
+     * Applied when activateOptions() is called. The default is "Blocking".
+     */
+    Q_PROPERTY(QString queueImplementation READ queueImplementationString WRITE setQueueImplementationString)
+
     /*!
      * Name of a fallback appender that receives events when the queue
      * is full and the event cannot be enqueued. Resolved at
@@ -127,6 +171,16 @@ public:
     };
     Q_ENUM(QueueFullPolicy)
 
+    /*!
+     * Selects the queue between the logging threads and the worker.
+     */
+    enum class QueueImplementation
+    {
+        Blocking,     //!< Mutex and condition variables (BoundedBlockingQueue, default)
+        LockFree      //!< Lock-free MPSC ring buffer (MpscRingQueue)
+    };
+    Q_ENUM(QueueImplementation)
+
     AsyncAppender(QObject *parent = nullptr);
     ~AsyncAppender() override;
 
@@ -137,6 +191,15 @@ public:
     int bufferSize() const { return mBufferSize; }
     void setBufferSize(int size);
 
+    int batchSize() const { return mBatchSize; }
+    void setBatchSize(int size);
+
+    int workerCount() const { return mWorkerCount; }
+    void setWorkerCount(int count);
+
+    QString shardKey() const;
+    void setShardKey(const QString &key);
+
     bool blocking() const { return mBlocking; }
     void setBlocking(bool blocking) { mBlocking = blocking; }
 
@@ -152,6 +215,12 @@ public:
     QString queueFullPolicyString() const;
     void setQueueFullPolicyString(const QString &policy);
 
+    QueueImplementation queueImplementation() const { return mQueueImplementation; }
+    void setQueueImplementation(QueueImplementation implementation) { mQueueImplementation = implementation; }
+
+    QString queueImplementationString() const;
+    void setQueueImplementationString(const QString &implementation);
+
     QString errorRef() const
     {
         QMutexLocker locker(&mObjectGuard);
@@ -174,20 +243,31 @@ public:
 
     void activateOptions() override;
     void close() override;
+
+    /*!
+     * Runs the recursion guard, threshold and filter chain like
+     * AppenderSkeleton::doAppend() and enqueues \a event without taking
+     * \c mObjectGuard. The lock is only taken to report an appender that
+     * is not activated or was closed, and to read the error appender when
+     * the queue is full.
+     */
+    void doAppend(const LoggingEvent &event) override;
     void callAppenders(const LoggingEvent &event) const;
+    void callAppenders(std::span<const LoggingEvent> events) const;
 
     bool checkEntryConditions() const override;
 
 Q_SIGNALS:
     /*!
-     * Emitted on the worker thread when the queue becomes empty after
-     * dispatching. Downstream code can connect to this for batch-flush
-     * optimisation.
+     * Emitted on a worker thread when its queue becomes empty after
+     * dispatching. With several workers it is emitted once per shard.
+     * Downstream code can connect to this for batch-flush optimisation.
      */
     void batchComplete();
 
 protected:
     void append(const LoggingEvent &event) override;
+    void appendBatch(std::span<const LoggingEvent *const> events, const LayoutSharedPtr &layout) override;
 
 private:
     // Resolves mErrorRef into mErrorAppender by searching the repository's
@@ -203,19 +283,49 @@ private:
     void closeInternal();
     void handleQueueFull(const LoggingEvent &event);
 
+    enum class ShardKey
+    {
+        Logger,
+        Thread,
+        Mdc
+    };
+
+    // What producers need to enqueue an event. Published by
+    // activateOptions() and cleared by close(), both under mObjectGuard, and
+    // read by doAppend() without a lock.
+    struct Dispatch
+    {
+        std::vector<std::shared_ptr<BlockingQueue<LoggingEvent>>> queues;
+        ShardKey shardKey;
+        QString shardMdcKey;
+    };
+
+    // Republishes mDispatch from the members below. Called with mObjectGuard held.
+    void publishDispatch();
+    void dispatchEvent(const Dispatch &dispatch, const LoggingEvent &event);
+    static BlockingQueue<LoggingEvent> *queueFor(const Dispatch &dispatch, const LoggingEvent &event);
+
     // Atomics: read from append()/closeInternal() while the public setters
     // may run concurrently on other threads (documented thread-safety).
     std::atomic<int> mBufferSize{1024};
+    std::atomic<int> mBatchSize{64};
+    std::atomic<int> mWorkerCount{1};
     std::atomic<bool> mBlocking{true};
     std::atomic<int> mShutdownTimeout{0};
     std::atomic<Level> mDiscardThreshold{Level(Level::INFO_INT)};
     std::atomic<QueueFullPolicy> mQueueFullPolicy{QueueFullPolicy::Block};
+    std::atomic<QueueImplementation> mQueueImplementation{QueueImplementation::Blocking};
     // Guarded by mObjectGuard
     QString mErrorRef;
     AppenderSharedPtr mErrorAppender;
-
-    std::unique_ptr<BoundedBlockingQueue<LoggingEvent>> mQueue;
-    std::unique_ptr<AsyncWorker> mWorker;
+    ShardKey mShardKey{ShardKey::Logger};
+    QString mShardMdcKey;
+
+    // One queue and worker per shard; index i of both belong together.
+    // Guarded by mObjectGuard; producers use the copy in mDispatch.
+    std::vector<std::shared_ptr<BlockingQueue<LoggingEvent>>> mQueues;
+    std::vector<std::unique_ptr<AsyncWorker>> mWorkers;
+    AtomicSharedPtr<const Dispatch> mDispatch;
 
     std::atomic<qint64> mDiscardedCount{0};
 };
@@ -0,0 +1,584 @@
+/******************************************************************************
+ *
+ * This file is part of Log4Qt library.
+ *
+ * Copyright (C) 2007 - 2026 Log4Qt contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+#include "binarylayout.h"
+
+#include "logger.h"
+
+#include <QStringEncoder>
+#include <QVarLengthArray>
+
+#include <algorithm>
+
+using namespace Qt::StringLiterals;
+
+namespace Log4Qt
+{
+
+namespace
+{
+
+constexpr QByteArrayView fileSignature("L4QB");
+constexpr char formatVersion = 1;
+
+enum RecordType : char
+{
+    SessionRecord = 1,
+    DefineRecord = 2,
+    EventRecord = 3
+};
+
+// Caps the dictionary, so a process that keeps creating threads with new
+// names does not grow it without bounds
+constexpr qsizetype maxEntries = 65536;
+
+int varintSize(quint64 value)
+{
+    int size = 1;
+    for (; value >= 0x80; value >>= 7)
+        ++size;
+    return size;
+}
+
+char *writeVarint(char *out, quint64 value)
+{
+    for (; value >= 0x80; value >>= 7)
+        *out++ = static_cast<char>(value | 0x80);
+    *out++ = static_cast<char>(value);
+    return out;
+}
+
+// Writes \a value in exactly \a size bytes, which must be at least
+// varintSize(value); the extra bytes are continuation bytes of zero bits
+char *writeVarint(char *out, quint64 value, int size)
+{
+    for (; size > 1; --size, value >>= 7)
+        *out++ = static_cast<char>((value & 0x7f) | 0x80);
+    *out++ = static_cast<char>(value);
+    return out;
+}
+
+void appendVarint(QByteArray &dest, quint64 value)
+{
+    char buffer[10];
+    dest.append(buffer, writeVarint(buffer, value) - buffer);
+}
+
+quint64 zigzag(qint64 value)
+{
+    return (static_cast<quint64>(value) << 1) ^ static_cast<quint64>(value >> 63);
+}
+
+// Level::toString() asserts on values that are not a Level::Value
+bool isLevelValue(quint64 value)
+{
+    switch (value)
+    {
+    case Level::NULL_INT:
+    case Level::ALL_INT:
+    case Level::TRACE_INT:
+    case Level::DEBUG_INT:
+    case Level::INFO_INT:
+    case Level::WARN_INT:
+    case Level::ERROR_INT:
+    case Level::FATAL_INT:
+    case Level::OFF_INT:
+        return true;
+    default:
+        return false;
+    }
+}
+
+qint64 unzigzag(quint64 value)
+{
+    return static_cast<qint64>(value >> 1) ^ -static_cast<qint64>(value & 1);
+}
+
+void appendString(QByteArray &dest, QByteArrayView utf8)
+{
+    appendVarint(dest, static_cast<quint64>(utf8.size()));
+    dest.append(utf8);
+}
+
+// Encodes \a text behind a length as wide as its longest possible UTF-8
+// encoding needs, which saves measuring the UTF-8 size up front. A shorter
+// length is padded with continuation bytes.
+void appendString(QByteArray &dest, QStringView text)
+{
+    QStringEncoder encoder(QStringEncoder::Utf8, QStringEncoder::Flag::Stateless);
+    const qsizetype maxSize = encoder.requiredSpace(text.size());
+    const int width = varintSize(static_cast<quint64>(maxSize));
+    const qsizetype pos = dest.size();
+    dest.resize(pos + width + maxSize);
+    const char *out = encoder.appendToBuffer(dest.data() + pos + width, text);
+    dest.truncate(out - dest.constData());
+    writeVarint(dest.data() + pos, static_cast<quint64>(dest.size() - pos - width), width);
+}
+
+// A reference is 0 for an absent string, the dictionary id shifted left by
+// one, or, once the dictionary is full, the length shifted left by one with
+// the low bit set followed by the UTF-8 bytes
+void appendReference(QByteArray &dest, quint32 id, QByteArrayView utf8)
+{
+    if (id)
+    {
+        appendVarint(dest, quint64(id) << 1);
+        return;
+    }
+    appendVarint(dest, (static_cast<quint64>(utf8.size()) << 1) | 1);
+    dest.append(utf8);
+}
+
+void appendReference(QByteArray &dest, quint32 id, const QString &text)
+{
+    if (id)
+        appendVarint(dest, quint64(id) << 1);
+    else
+        appendReference(dest, 0, QByteArrayView(text.toUtf8()));
+}
+
+void appendRecordHeader(QByteArray &dest, RecordType type, qsizetype payloadSize)
+{
+    appendVarint(dest, static_cast<quint64>(payloadSize) + 1);
+    dest.append(type);
+}
+
+void appendDefinition(QByteArray &dest, quint32 id, QByteArrayView utf8)
+{
+    appendRecordHeader(dest, DefineRecord, varintSize(id) + varintSize(static_cast<quint64>(utf8.size())) + utf8.size());
+    appendVarint(dest, id);
+    appendString(dest, utf8);
+}
+
+// The fields of an Event record are encoded here first, so the record
+// length is known when it is written
+QByteArray &eventPayloadBuffer()
+{
+    thread_local QByteArray buffer;
+    return buffer;
+}
+
+// Reads varints and byte runs from a record, failing on the first one that
+// does not fit
+class Cursor
+{
+public:
+    explicit Cursor(QByteArrayView data)
+        : mData(data)
+    {}
+
+    [[nodiscard]] bool atEnd() const { return mPos == mData.size(); }
+    [[nodiscard]] qsizetype position() const { return mPos; }
+
+    bool readVarint(quint64 &value)
+    {
+        value = 0;
+        for (int shift = 0; shift < 64 && mPos < mData.size(); shift += 7)
+        {
+            const auto byte = static_cast<quint8>(mData[mPos++]);
+            value |= quint64(byte & 0x7f) << shift;
+            if (!(byte & 0x80))
+                return true;
+        }
+        return false;
+    }
+
+    bool readBytes(quint64 size, QByteArrayView &bytes)
+    {
+        if (size > static_cast<quint64>(mData.size() - mPos))
+            return false;
+        bytes = mData.sliced(mPos, static_cast<qsizetype>(size));
+        mPos += static_cast<qsizetype>(size);
+        return true;
+    }
+
+    bool readString(QByteArrayView &utf8)
+    {
+        quint64 size;
+        return readVarint(size) && readBytes(size, utf8);
+    }
+
+private:
+    QByteArrayView mData;
+    qsizetype mPos = 0;
+};
+
+} // namespace
+
+BinaryLayout::BinaryLayout(QObject *parent)
+    : AbstractStringLayout(parent)
+{
+}
+
+QString BinaryLayout::contentType() const
+{
+    return u"application/x-log4qt-binary"_s;
+}
+
+QString BinaryLayout::footer() const
+{
+    return QString();
+}
+
+QString BinaryLayout::header() const
+{
+    return QString();
+}
+
+QString BinaryLayout::format(const LoggingEvent &event)
+{
+    return event.level().toString() + u" - "_s + event.message() + AbstractLayout::endOfLine();
+}
+
+void BinaryLayout::formatTo(const LoggingEvent &event, QByteArray &dest)
+{
+    const Logger *logger = event.logger();
+    const QString threadName = event.threadName();
+    const QString categoryName = event.categoryName();
+    const MessageContext context = event.context();
+    const QHash<QString, QString> properties = event.properties();
+
+    // Dictionary ids; 0 for strings not in the dictionary
+    quint32 loggerId = 0;
+    quint32 threadId = 0;
+    quint32 categoryId = 0;
+    quint32 fileId = 0;
+    quint32 functionId = 0;
+    QVarLengthArray<quint32, 8> keyIds(properties.size());
+    std::fill(keyIds.begin(), keyIds.end(), 0);
+
+    bool complete = true;
+    {
+        QReadLocker locker(&mDictionaryLock);
+        const bool full = mEntries.size() >= maxEntries;
+        const auto find = [&](const auto &ids, const auto &key, quint32 &id) {
+            id = ids.value(key);
+            complete = complete && (id || full);
+        };
+        if (logger)
+            find(mLoggerIds, logger, loggerId);
+        if (!threadName.isEmpty())
+            find(mStringIds, threadName, threadId);
+        if (!categoryName.isEmpty())
+            find(mStringIds, categoryName, categoryId);
+        if (context.file)
+            find(mUtf8Ids, QByteArray::fromRawData(context.file, qstrlen(context.file)), fileId);
+        if (context.function)
+            find(mUtf8Ids, QByteArray::fromRawData(context.function, qstrlen(context.function)), functionId);
+        qsizetype i = 0;
+        for (auto it = properties.cbegin(); it != properties.cend(); ++it)
+            find(mStringIds, it.key(), keyIds[i++]);
+    }
+    if (!complete)
+    {
+        // No Define records here: the event may still be dropped or land in
+        // the next file. formatPendingTo() writes them under the appender lock.
+        QWriteLocker locker(&mDictionaryLock);
+        if (logger && !loggerId)
+            loggerId = define(logger);
+        if (!threadName.isEmpty() && !threadId)
+            threadId = define(threadName);
+        if (!categoryName.isEmpty() && !categoryId)
+            categoryId = define(categoryName);
+        if (context.file && !fileId)
+            fileId = define(context.file);
+        if (context.function && !functionId)
+            functionId = define(context.function);
+        qsizetype i = 0;
+        for (auto it = properties.cbegin(); it != properties.cend(); ++it, ++i)
+            if (!keyIds[i])
+                keyIds[i] = define(it.key());
+    }
+
+    QByteArray &payload = eventPayloadBuffer();
+    payload.clear();
+    appendVarint(payload, zigzag(event.timeStamp()));
+    appendVarint(payload, static_cast<quint64>(event.level().toInt()));
+    if (logger)
+        appendReference(payload, loggerId, QByteArrayView(logger->nameUtf8()));
+    else
+        appendVarint(payload, 0);
+    if (!threadName.isEmpty())
+        appendReference(payload, threadId, threadName);
+    else
+        appendVarint(payload, 0);
+    if (!categoryName.isEmpty())
+        appendReference(payload, categoryId, categoryName);
+    else
+        appendVarint(payload, 0);
+    if (context.file)
+        appendReference(payload, fileId, QByteArrayView(context.file));
+    else
+        appendVarint(payload, 0);
+    appendVarint(payload, context.line >= 0 ? static_cast<quint64>(context.line) + 1 : 0);
+    if (context.function)
+        appendReference(payload, functionId, QByteArrayView(context.function));
+    else
+        appendVarint(payload, 0);
+    appendString(payload, QStringView(event.message()));
+    appendString(payload, QStringView(event.ndc()));
+    appendVarint(payload, static_cast<quint64>(properties.size()));
+    qsizetype i = 0;
+    for (auto it = properties.cbegin(); it != properties.cend(); ++it)
+    {
+        appendReference(payload, keyIds[i++], it.key());
+        appendString(payload, QStringView(it.value()));
+    }
+    appendRecordHeader(dest, EventRecord, payload.size());
+    dest.append(payload);
+}
+
+void BinaryLayout::formatHeaderTo(QByteArray &dest, bool appending)
+{
+    if (!appending)
+    {
+        dest.append(fileSignature);
+        dest.append(formatVersion);
+    }
+    appendRecordHeader(dest, SessionRecord, 0);
+}
+
+void BinaryLayout::formatPendingTo(QByteArray &dest, qsizetype &written)
+{
+    QReadLocker locker(&mDictionaryLock);
+    for (; written < mEntries.size(); ++written)
+        appendDefinition(dest, static_cast<quint32>(written + 1), mEntries.at(written));
+}
+
+bool BinaryLayout::requiresLocation() const
+{
+    return true;
+}
+
+quint32 BinaryLayout::define(const Logger *logger)
+{
+    if (const quint32 id = mLoggerIds.value(logger))
+        return id;
+    const quint32 id = addEntry(logger->nameUtf8());
+    if (id)
+        mLoggerIds.insert(logger, id);
+    return id;
+}
+
+quint32 BinaryLayout::define(const char *utf8)
+{
+    const QByteArray text(utf8);
+    if (const quint32 id = mUtf8Ids.value(text))
+        return id;
+    const quint32 id = addEntry(text);
+    if (id)
+        mUtf8Ids.insert(text, id);
+    return id;
+}
+
+quint32 BinaryLayout::define(const QString &text)
+{
+    if (const quint32 id = mStringIds.value(text))
+        return id;
+    const quint32 id = addEntry(text.toUtf8());
+    if (id)
+        mStringIds.insert(text, id);
+    return id;
+}
+
+quint32 BinaryLayout::addEntry(QByteArrayView utf8)
+{
+    if (mEntries.size() >= maxEntries)
+        return 0;
+    mEntries.append(utf8.toByteArray());
+    return static_cast<quint32>(mEntries.size());
+}
+
+bool BinaryLogReader::read(const QByteArray &data)
+{
+    mErrorString.clear();
+    const qsizetype headerSize = fileSignature.size() + 1;
+    if (!data.startsWith(fileSignature) || data.size() < headerSize)
+        return fail(u"Missing binary log signature"_s, 0);
+    if (data.at(fileSignature.size()) != formatVersion)
+        return fail(u"Unsupported format version %1"_s.arg(int(data.at(fileSignature.size()))), fileSignature.size());
+
+    // First pass: collect the definitions of every session, so decoding does
+    // not depend on the order of Define and Event records
+    struct EventPayload
+    {
+        QByteArrayView payload;
+        qsizetype session;
+        qsizetype offset;
+    };
+    QList<EventPayload> events;
+    const qsizetype firstSession = mSessions.size();
+    bool ok = true;
+    Cursor records(QByteArrayView(data).sliced(headerSize));
+    while (ok && !records.atEnd())
+    {
+        const qsizetype offset = headerSize + records.position();
+        QByteArrayView payload;
+        if (!records.readString(payload) || payload.isEmpty())
+        {
+            ok = fail(u"Truncated record"_s, offset);
+            break;
+        }
+        const char type = payload.front();
+        if (type != SessionRecord && type != DefineRecord && type != EventRecord)
+            continue; // Added by a later version of the format
+        if (type == SessionRecord)
+        {
+            mSessions.append({});
+            continue;
+        }
+        if (mSessions.size() == firstSession)
+        {
+            ok = fail(u"Record outside a session"_s, offset);
+            break;
+        }
+        if (type == EventRecord)
+        {
+            events.append({payload.sliced(1), mSessions.size() - 1, offset});
+            continue;
+        }
+        Cursor definition(payload.sliced(1));
+        quint64 id;
+        QByteArrayView utf8;
+        if (!definition.readVarint(id) || !definition.readString(utf8))
+        {
+            ok = fail(u"Corrupt definition"_s, offset);
+            break;
+        }
+        // Keep the first copy of a repeated definition, events may point into it
+        if (!mSessions.last().contains(id))
+            mSessions.last().insert(id, utf8.toByteArray());
+    }
+
+    // Second pass: decode the events up to the first damaged record
+    for (const EventPayload &event : std::as_const(events))
+    {
+        if (!decodeEvent(event.payload, event.session))
+            return fail(u"Corrupt event"_s, event.offset);
+    }
+    return ok;
+}
+
+bool BinaryLogReader::decodeEvent(QByteArrayView payload, qsizetype session)
+{
+    const QHash<quint64, QByteArray> &dictionary = mSessions.at(session);
+    Cursor in(payload);
+
+    // File and function names are handed to MessageContext as pointers;
+    // inline strings are kept in mLiterals so they stay valid
+    const auto reference = [&](QByteArray &text, bool keep) {
+        quint64 ref;
+        if (!in.readVarint(ref))
+            return false;
+        if (ref == 0)
+            return true;
+        if (ref & 1)
+        {
+            QByteArrayView utf8;
+            if (!in.readBytes(ref >> 1, utf8))
+                return false;
+            text = utf8.toByteArray();
+            if (keep)
+                mLiterals.append(text);
+            return true;
+        }
+        const auto it = dictionary.constFind(ref >> 1);
+        if (it != dictionary.cend())
+        {
+            text = *it;
+            return true;
+        }
+        // The Define record is missing, e.g. lost with a damaged part of the
+        // file: flag the string and keep the rest of the event
+        text = "<unknown #" + QByteArray::number(ref >> 1) + '>';
+        if (keep)
+            mLiterals.append(text);
+        ++mUnknownIdCount;
+        return true;
+    };
+    const auto string = [&](QString &text) {
+        QByteArrayView utf8;
+        if (!in.readString(utf8))
+            return false;
+        text = QString::fromUtf8(utf8);
+        return true;
+    };
+
+    quint64 timeStamp;
+    quint64 level;
+    quint64 line;
+    quint64 propertyCount;
+    QByteArray loggerName;
+    QByteArray threadName;
+    QByteArray categoryName;
+    QByteArray file;
+    QByteArray function;
+    QString message;
+    QString ndc;
+    if (!in.readVarint(timeStamp) || !in.readVarint(level) || !isLevelValue(level)
+        || !reference(loggerName, false) || !reference(threadName, false)
+        || !reference(categoryName, false) || !reference(file, true)
+        || !in.readVarint(line) || !reference(function, true)
+        || !string(message) || !string(ndc) || !in.readVarint(propertyCount))
+        return false;
+
+    QHash<QString, QString> properties;
+    for (quint64 i = 0; i < propertyCount; ++i)
+    {
+        QByteArray key;
+        QString value;
+        if (!reference(key, false) || !string(value))
+            return false;
+        properties.insert(QString::fromUtf8(key), value);
+    }
+
+    const Logger *logger = nullptr;
+    if (!loggerName.isEmpty())
+    {
+        auto it = mLoggers.constFind(loggerName);
+        if (it == mLoggers.cend())
+            it = mLoggers.insert(loggerName, Logger::logger(QString::fromUtf8(loggerName)));
+        logger = *it;
+    }
+
+    const MessageContext context(file.isNull() ? nullptr : file.constData(),
+                                 line ? static_cast<int>(line - 1) : -1,
+                                 function.isNull() ? nullptr : function.constData());
+    mEvents.append(LoggingEvent(logger,
+                                Level(static_cast<Level::Value>(level)),
+                                message,
+                                ndc,
+                                properties,
+                                QString::fromUtf8(threadName),
+                                unzigzag(timeStamp),
+                                context,
+                                QString::fromUtf8(categoryName)));
+    return true;
+}
+
+bool BinaryLogReader::fail(const QString &message, qsizetype offset)
+{
+    mErrorString = u"%1 at offset %2"_s.arg(message).arg(offset);
+    return false;
+}
+
+} // namespace Log4Qt
+
+#include "moc_binarylayout.cpp"
@@ -0,0 +1,193 @@
+/******************************************************************************
+ *
+ * This file is part of Log4Qt library.
+ *
+ * Copyright (C) 2007 - 2026 Log4Qt contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+#ifndef LOG4QT_BINARYLAYOUT_H
+#define LOG4QT_BINARYLAYOUT_H
+
+#include "abstractstringlayout.h"
+#include "loggingevent.h"
+
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+#include <QReadWriteLock>
+
+namespace Log4Qt
+{
+
+class Logger;
+
+/*!
+ * \brief Layout that writes each log event as a compact binary record.
+ *
+ * BinaryLayout is meant for high-volume logging to a RandomAccessFileAppender,
+ * which writes the bytes of formatTo() and formatHeaderTo() as they are. It
+ * does not format timestamps or pad text on the logging threads and
+ * typically writes a fraction of the bytes a PatternLayout would. The files
+ * are turned back into text with the \c log4qt-decode tool or with
+ * BinaryLogReader.
+ *
+ * \par File format
+ * A file starts with the four bytes \c "L4QB" and a format version byte,
+ * followed by length-prefixed records: a varint payload length, a record
+ * type byte and the payload. Integers are unsigned LEB128 varints, which
+ * may be padded with continuation bytes, timestamps zigzag-encoded; strings
+ * are a varint length followed by UTF-8.
+ *
+ * \li \b Session — starts a dictionary scope. Written when the file is
+ *     opened, also when output is appended to a file of an earlier run.
+ * \li \b Define — assigns a dictionary id to a string.
+ * \li \b Event — timestamp, level, references to the logger, thread,
+ *     category, file and function, the line, the message and NDC, and the
+ *     properties as key references and value strings.
+ *
+ * Logger names, thread names, categories, file and function names and
+ * property keys are dictionary-encoded: events write only the id. Events
+ * are encoded outside the appender lock, so formatTo() just adds new
+ * strings to the dictionary; the appender writes their Define records
+ * through formatPendingTo() under its lock, in front of the first event of
+ * each file that may use them. Ids stay stable for the lifetime of the
+ * layout and every file can be decoded on its own, also after a rollover
+ * or when the event that added a string was dropped. Once the dictionary
+ * holds 65536 strings, new strings are written inline.
+ *
+ * The \c header and \c footer properties are ignored: header() and footer()
+ * return empty strings. format() returns a "LEVEL - message" line like
+ * SimpleLayout, for appenders that only write text.
+ *
+ * \note The ownership and lifetime of objects of this class are managed. See
+ *       \ref Ownership "Object ownership" for more details.
+ *
+ * \sa BinaryLogReader, RandomAccessFileAppender
+ */
+class LOG4QT_EXPORT BinaryLayout : public AbstractStringLayout
+{
+    Q_OBJECT
+
+public:
+    explicit BinaryLayout(QObject *parent = nullptr);
+
+private:
+    Q_DISABLE_COPY_MOVE(BinaryLayout)
+
+public:
+    /*!
+     * Returns \c "application/x-log4qt-binary".
+     */
+    [[nodiscard]] QString contentType() const override;
+    [[nodiscard]] QString footer() const override;
+    [[nodiscard]] QString header() const override;
+
+    [[nodiscard]] QString format(const LoggingEvent &event) override;
+
+    /*!
+     * Appends the Event record of \a event to \a dest and adds the strings
+     * the dictionary does not know yet.
+     */
+    void formatTo(const LoggingEvent &event, QByteArray &dest) override;
+
+    /*!
+     * Appends the file signature (unless \a appending) and a Session record
+     * to \a dest.
+     */
+    void formatHeaderTo(QByteArray &dest, bool appending) override;
+
+    /*!
+     * Appends the Define records of the dictionary entries from \a written
+     * on to \a dest and sets \a written to the size of the dictionary.
+     */
+    void formatPendingTo(QByteArray &dest, qsizetype &written) override;
+
+    /*!
+     * Returns \c true: the call site of every event is recorded.
+     */
+    [[nodiscard]] bool requiresLocation() const override;
+
+private:
+    // Return the id of a string, adding it if it is new. 0 when the
+    // dictionary is full. Called with the write lock held.
+    quint32 define(const Logger *logger);
+    quint32 define(const char *utf8);
+    quint32 define(const QString &text);
+    quint32 addEntry(QByteArrayView utf8);
+
+    mutable QReadWriteLock mDictionaryLock;
+    QHash<const Logger *, quint32> mLoggerIds;
+    // File and function names by content: the pointers Qt hands over for
+    // QML messages do not outlive the call
+    QHash<QByteArray, quint32> mUtf8Ids;
+    QHash<QString, quint32> mStringIds;
+    QList<QByteArray> mEntries;
+};
+
+/*!
+ * \brief The class BinaryLogReader decodes the output of BinaryLayout.
+ *
+ * The events of every session are decoded once all definitions of the
+ * session have been read, so the order of Define and Event records does not
+ * matter. A reference to an id the session never defines is decoded as
+ * \c "<unknown #id>" and counted in unknownIdCount(). Loggers are looked up
+ * by name and created if they do not exist yet.
+ *
+ * \note The file and function names of the decoded events point into the
+ *       reader. Keep it alive while the events are in use.
+ *
+ * \sa BinaryLayout
+ */
+class LOG4QT_EXPORT BinaryLogReader
+{
+public:
+    BinaryLogReader() = default;
+
+    /*!
+     * Decodes the contents of a file written with BinaryLayout and appends
+     * its events to events(). Returns \c false if \a data is not such a file
+     * or is corrupt; the events before the damaged record are still
+     * available. A record cut short at the end of \a data, as left by a
+     * process that crashed while writing, is treated as corrupt.
+     */
+    bool read(const QByteArray &data);
+
+    [[nodiscard]] const QList<LoggingEvent> &events() const { return mEvents; }
+    [[nodiscard]] QString errorString() const { return mErrorString; }
+
+    /*!
+     * Returns how many strings of the decoded events referred to an id
+     * without a Define record and were replaced by \c "<unknown #id>".
+     */
+    [[nodiscard]] qsizetype unknownIdCount() const { return mUnknownIdCount; }
+
+private:
+    Q_DISABLE_COPY_MOVE(BinaryLogReader)
+
+    bool decodeEvent(QByteArrayView payload, qsizetype session);
+    bool fail(const QString &message, qsizetype offset);
+
+    QList<LoggingEvent> mEvents;
+    QList<QHash<quint64, QByteArray>> mSessions;
+    QList<QByteArray> mLiterals;
+    QHash<QByteArray, const Logger *> mLoggers;
+    QString mErrorString;
+    qsizetype mUnknownIdCount = 0;
+};
+
+} // namespace Log4Qt
+
+#endif // LOG4QT_BINARYLAYOUT_H
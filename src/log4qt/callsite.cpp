@@ -0,0 +1,174 @@
+/******************************************************************************
+ *
+ * This file is part of Log4Qt library.
+ *
+ * Copyright (C) 2007 - 2026 Log4Qt contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+#include "callsite.h"
+
+#include <QMutex>
+#include <QMutexLocker>
+
+#include <charconv>
+#include <iterator>
+
+namespace Log4Qt
+{
+
+namespace
+{
+
+struct Rule
+{
+    QString file;
+    int line;
+    CallSite::Mode mode;
+};
+
+struct Registry
+{
+    QMutex mutex;
+    CallSite *first = nullptr;
+    CallSite *last = nullptr;
+    QList<Rule> rules;
+};
+
+// Created by the first call site, so it is destroyed after the last one
+Registry &registry()
+{
+    static Registry registry;
+    return registry;
+}
+
+qsizetype lineSize(int line)
+{
+    char digits[16];
+    return std::to_chars(std::begin(digits), std::end(digits), line).ptr - digits;
+}
+
+QByteArray siteText(QByteArrayView file, int line, QByteArrayView function)
+{
+    char digits[16];
+    const auto result = std::to_chars(std::begin(digits), std::end(digits), line);
+    QByteArray text;
+    text.reserve(2 * file.size() + 1 + (result.ptr - digits) + 3 + function.size());
+    text.append(file).append('\0');
+    text.append(file).append(':').append(digits, result.ptr - digits).append(" - ").append(function);
+    return text;
+}
+
+bool matches(const CallSite &site, const Rule &rule)
+{
+    if (rule.line > 0 && rule.line != site.line())
+        return false;
+    const QString file = QString::fromUtf8(site.fileUtf8());
+    if (!file.endsWith(rule.file))
+        return false;
+    if (file.size() == rule.file.size())
+        return true;
+    const QChar separator = file.at(file.size() - rule.file.size() - 1);
+    return separator == u'/' || separator == u'\\';
+}
+
+} // namespace
+
+CallSite::CallSite(Level level, const char *file, int line, const char *function)
+    : mLevel(level)
+    , mLine(line)
+    , mFileSize(qstrlen(file))
+    , mLineSize(lineSize(line))
+    , mText(siteText(QByteArrayView(file, mFileSize), line, QByteArrayView(function)))
+{
+    CallSiteRegistry::add(this);
+}
+
+CallSite::~CallSite()
+{
+    CallSiteRegistry::remove(this);
+}
+
+QList<CallSite *> CallSiteRegistry::callSites()
+{
+    Registry &r = registry();
+    QMutexLocker locker(&r.mutex);
+    QList<CallSite *> sites;
+    for (CallSite *site = r.first; site; site = site->mNext)
+        sites.append(site);
+    return sites;
+}
+
+int CallSiteRegistry::setMode(const QString &file, int line, CallSite::Mode mode)
+{
+    const Rule rule{file, line > 0 ? line : 0, mode};
+    Registry &r = registry();
+    QMutexLocker locker(&r.mutex);
+    r.rules.removeIf([&](const Rule &other) { return other.file == rule.file && other.line == rule.line; });
+    r.rules.append(rule);
+
+    int changed = 0;
+    for (CallSite *site = r.first; site; site = site->mNext)
+    {
+        if (matches(*site, rule))
+        {
+            site->setMode(mode);
+            ++changed;
+        }
+    }
+    return changed;
+}
+
+void CallSiteRegistry::resetModes()
+{
+    Registry &r = registry();
+    QMutexLocker locker(&r.mutex);
+    r.rules.clear();
+    for (CallSite *site = r.first; site; site = site->mNext)
+        site->setMode(CallSite::Mode::Default);
+}
+
+void CallSiteRegistry::add(CallSite *site)
+{
+    Registry &r = registry();
+    QMutexLocker locker(&r.mutex);
+    for (const Rule &rule : std::as_const(r.rules))
+    {
+        if (matches(*site, rule))
+            site->setMode(rule.mode);
+    }
+    site->mPrevious = r.last;
+    if (r.last)
+        r.last->mNext = site;
+    else
+        r.first = site;
+    r.last = site;
+}
+
+void CallSiteRegistry::remove(CallSite *site)
+{
+    Registry &r = registry();
+    QMutexLocker locker(&r.mutex);
+    if (site->mPrevious)
+        site->mPrevious->mNext = site->mNext;
+    else
+        r.first = site->mNext;
+    if (site->mNext)
+        site->mNext->mPrevious = site->mPrevious;
+    else
+        r.last = site->mPrevious;
+}
+
+} // namespace Log4Qt
@@ -0,0 +1,194 @@
+/******************************************************************************
+ *
+ * This file is part of Log4Qt library.
+ *
+ * Copyright (C) 2007 - 2026 Log4Qt contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+#ifndef LOG4QT_CALLSITE_H
+#define LOG4QT_CALLSITE_H
+
+#include "log4qtshared.h"
+#include "level.h"
+
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QList>
+#include <QString>
+
+#include <atomic>
+
+namespace Log4Qt
+{
+
+class Logger;
+
+/*!
+ * \brief The class CallSite describes one l4qFatal() ... l4qTrace()
+ *        statement.
+ *
+ * Every l4q* statement owns a CallSite, created and registered with
+ * CallSiteRegistry the first time the statement runs. It holds the level,
+ * file, line and function of the statement. The lengths of the file and
+ * function names and the "file:line - function" location text are computed
+ * once, so PatternLayout copies them per event instead of measuring and
+ * formatting the C strings again.
+ *
+ * The site copies the file and function names, and the macros allocate it
+ * on the heap and never delete it. Events refer to their site through
+ * MessageContext::callSite, so an event still queued in an AsyncAppender
+ * when the library or plugin of its statement is unloaded stays valid.
+ *
+ * The mode of a call site can override the level of its logger:
+ * Mode::Enabled logs the statement whatever the level of the logger and
+ * the threshold of the repository, Mode::Disabled silences it. Appender
+ * thresholds and filters still apply.
+ *
+ * \note All the functions declared in this class are thread-safe.
+ *
+ * \sa CallSiteRegistry, MessageContext
+ */
+class LOG4QT_EXPORT CallSite
+{
+public:
+    /*!
+     * Decides whether the statement logs.
+     */
+    enum class Mode : quint8
+    {
+        Default,  //!< Logs if the logger is enabled for the level (default)
+        Enabled,  //!< Always logs
+        Disabled  //!< Never logs
+    };
+
+    CallSite(Level level, const char *file, int line, const char *function);
+    ~CallSite();
+
+    [[nodiscard]] Level level() const { return mLevel; }
+    [[nodiscard]] const char *file() const { return mText.constData(); }
+    [[nodiscard]] int line() const { return mLine; }
+    [[nodiscard]] const char *function() const { return functionUtf8().data(); }
+
+    [[nodiscard]] QByteArrayView fileUtf8() const
+    {
+        return QByteArrayView(mText).first(mFileSize);
+    }
+    [[nodiscard]] QByteArrayView lineUtf8() const
+    {
+        return locationUtf8().sliced(mFileSize + 1, mLineSize);
+    }
+    [[nodiscard]] QByteArrayView functionUtf8() const
+    {
+        return locationUtf8().sliced(mFileSize + 1 + mLineSize + 3);
+    }
+
+    /*!
+     * Returns the location as written by the \c %l conversion character:
+     * "file:line - function".
+     */
+    [[nodiscard]] QByteArrayView locationUtf8() const
+    {
+        return QByteArrayView(mText).sliced(mFileSize + 1);
+    }
+
+    [[nodiscard]] Mode mode() const { return mMode.load(std::memory_order_relaxed); }
+    void setMode(Mode mode) { mMode.store(mode, std::memory_order_relaxed); }
+
+    /*!
+     * Returns whether the statement logs through \a logger: per the mode,
+     * or, in Mode::Default, per Logger::isEnabledFor(). Always \c false for
+     * a null \a logger.
+     *
+     * Inline, defined in callsiteimpl.h, which logger.h includes.
+     */
+    [[nodiscard]] inline bool isEnabledFor(const Logger *logger) const;
+
+private:
+    Q_DISABLE_COPY_MOVE(CallSite)
+
+    const Level mLevel;
+    const int mLine;
+    const qsizetype mFileSize;
+    const qsizetype mLineSize;
+    // The file name and the location, "file\0file:line - function"; both
+    // end in a '\0', so file() and function() point into it
+    const QByteArray mText;
+    std::atomic<Mode> mMode{Mode::Default};
+
+    // Registry list, guarded by the registry's mutex
+    CallSite *mPrevious = nullptr;
+    CallSite *mNext = nullptr;
+
+    friend class CallSiteRegistry;
+};
+
+/*!
+ * \brief The class CallSiteRegistry lists the l4q* call sites of the
+ *        process and sets their modes at runtime.
+ *
+ * A call site registers the first time its statement runs and unregisters
+ * when the library or executable that contains it is unloaded. A mode set
+ * with setMode() applies to the matching sites registered so far and to
+ * those registering later, so a statement can be enabled before it first
+ * runs. This turns on a single debug statement in production without
+ * lowering the level of its logger:
+ *
+ * \code
+ * CallSiteRegistry::setMode(u"connection.cpp"_s, 212, CallSite::Mode::Enabled);
+ * \endcode
+ *
+ * \note All the functions declared in this class are thread-safe.
+ *
+ * \sa CallSite
+ */
+class LOG4QT_EXPORT CallSiteRegistry
+{
+private:
+    CallSiteRegistry();
+
+public:
+    /*!
+     * Returns the registered call sites in the order they registered. The
+     * sites of the l4q* macros are never deleted, so the pointers stay
+     * valid; a site of an unloaded library stays listed.
+     */
+    static QList<CallSite *> callSites();
+
+    /*!
+     * Sets the mode of the call sites at \a line of \a file and returns the
+     * number of registered sites it changed. \a file matches a site whose
+     * file name equals it or ends with it after a path separator; a \a line
+     * of 0 matches every line. The rule is kept for sites registering
+     * later; of several matching rules the last one set wins.
+     */
+    static int setMode(const QString &file, int line, CallSite::Mode mode);
+
+    /*!
+     * Sets all registered call sites back to CallSite::Mode::Default and
+     * drops the rules of setMode().
+     */
+    static void resetModes();
+
+private:
+    static void add(CallSite *site);
+    static void remove(CallSite *site);
+
+    friend class CallSite;
+};
+
+} // namespace Log4Qt
+
+#endif // LOG4QT_CALLSITE_H
@@ -0,0 +1,49 @@
+/******************************************************************************
+ *
+ * This file is part of Log4Qt library.
+ *
+ * Copyright (C) 2007 - 2026 Log4Qt contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+#ifndef LOG4QT_CALLSITEIMPL_H
+#define LOG4QT_CALLSITEIMPL_H
+
+// The inline functions of CallSite that need the complete Logger. Included
+// at the end of logger.h, so every l4q* statement sees them.
+
+#include "callsite.h"
+#include "logger.h"
+
+namespace Log4Qt
+{
+
+inline bool CallSite::isEnabledFor(const Logger *logger) const
+{
+    switch (mode())
+    {
+    case Mode::Enabled:
+        return logger != nullptr;
+    case Mode::Disabled:
+        return false;
+    case Mode::Default:
+        break;
+    }
+    return logger && logger->isEnabledFor(mLevel);
+}
+
+} // namespace Log4Qt
+
+#endif // LOG4QT_CALLSITEIMPL_H
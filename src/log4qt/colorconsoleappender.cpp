@@ -245,14 +245,17 @@ ColorConsoleAppender::~ColorConsoleAppender()
 #ifdef Q_OS_WIN
 void ColorConsoleAppender::append(const LoggingEvent &event)
 {
-    QString message = layout()->format(event);
+    if (!layoutSnapshot())
+        return;
+
+    const QString message = formattedText(event);
 
     colorOutputString(hConsole, message);
 
     if (handleIoErrors())
         return;
 
-    if (immediateFlush())
+    if (flushAfterAppend())
     {
         writer()->flush();
         if (handleIoErrors())
@@ -141,11 +141,10 @@ void ConsoleAppender::append(const LoggingEvent &event)
     if (mUseOutputDebugString)
     {
         // If console is blocked by debugger use OutputDebugString.
-        const LayoutSharedPtr &layoutSnap = layoutSnapshot();
-        if (!layoutSnap)
+        if (!layoutSnapshot())
             return;
 
-        QString message(layoutSnap->format(event));
+        const QString message = formattedText(event);
 
         OutputDebugString(message.toStdWString().c_str());
     }
@@ -19,17 +19,18 @@
  ******************************************************************************/
 
 #include "helpers/asyncworker.h"
-#include "helpers/boundedblockingqueue.h"
+#include "helpers/blockingqueue.h"
 #include "asyncappender.h"
 #include "loggingevent.h"
 
+#include <algorithm>
 #include <vector>
 
 namespace Log4Qt
 {
 
 AsyncWorker::AsyncWorker(AsyncAppender *appender,
-                         BoundedBlockingQueue<LoggingEvent> *queue,
+                         BlockingQueue<LoggingEvent> *queue,
                          QObject *parent)
     : QThread(parent)
     , mAppender(appender)
@@ -40,10 +41,24 @@ AsyncWorker::AsyncWorker(AsyncAppender *appender,
 void AsyncWorker::run()
 {
     LoggingEvent event;
+    std::vector<LoggingEvent> batch;
 
+    // Block for the first event, then take whatever else is already queued
+    // (up to batchSize) and hand it to the appenders in one call.
     while (mQueue->dequeue(event))
     {
-        mAppender->callAppenders(event);
+        const int batchSize = mAppender->batchSize();
+        if (batchSize <= 1)
+        {
+            mAppender->callAppenders(event);
+        }
+        else
+        {
+            batch.push_back(std::move(event));
+            mQueue->drain(batch, batchSize - 1);
+            mAppender->callAppenders(std::span<const LoggingEvent>(batch));
+            batch.clear();
+        }
 
         if (mQueue->isEmpty())
             Q_EMIT mAppender->batchComplete();
@@ -52,11 +67,17 @@ void AsyncWorker::run()
     // Drain remaining events after shutdown signal
     std::vector<LoggingEvent> remaining;
     mQueue->drain(remaining, mQueue->capacity());
-    for (const auto &e : remaining)
-        mAppender->callAppenders(e);
-
     if (!remaining.empty())
+    {
+        const std::size_t batchSize = static_cast<std::size_t>((std::max)(mAppender->batchSize(), 1));
+        for (std::size_t i = 0; i < remaining.size(); i += batchSize)
+        {
+            const std::size_t count = (std::min)(batchSize, remaining.size() - i);
+            mAppender->callAppenders(std::span<const LoggingEvent>(remaining.data() + i, count));
+        }
+
         Q_EMIT mAppender->batchComplete();
+    }
 }
 
 } // namespace Log4Qt
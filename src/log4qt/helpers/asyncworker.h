@@ -28,10 +28,10 @@ namespace Log4Qt
 
 class AsyncAppender;
 class LoggingEvent;
-template<typename T> class BoundedBlockingQueue;
+template<typename T> class BlockingQueue;
 
 /*!
- * \brief Worker thread that drains events from a BoundedBlockingQueue
+ * \brief Worker thread that drains events from a BlockingQueue
  *        and dispatches them to the AsyncAppender's attached appenders.
  *
  * Replaces the event-loop-based Dispatcher for AsyncAppender with an
@@ -43,7 +43,7 @@ class AsyncWorker : public QThread
 
 public:
     AsyncWorker(AsyncAppender *appender,
-                BoundedBlockingQueue<LoggingEvent> *queue,
+                BlockingQueue<LoggingEvent> *queue,
                 QObject *parent = nullptr);
 
 protected:
@@ -53,7 +53,7 @@ private:
     Q_DISABLE_COPY_MOVE(AsyncWorker)
 
     AsyncAppender *mAppender;
-    BoundedBlockingQueue<LoggingEvent> *mQueue;
+    BlockingQueue<LoggingEvent> *mQueue;
 };
 
 } // namespace Log4Qt
@@ -0,0 +1,89 @@
+/******************************************************************************
+ *
+ * This file is part of Log4Qt library.
+ *
+ * Copyright (C) 2007 - 2026 Log4Qt contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+#ifndef LOG4QT_HELPERS_ATOMICSHAREDPTR_H
+#define LOG4QT_HELPERS_ATOMICSHAREDPTR_H
+
+#include <QtGlobal>
+
+#include <atomic>
+#include <memory>
+#include <utility>
+#include <version>
+
+namespace Log4Qt
+{
+
+/*!
+ * \brief A std::shared_ptr that can be loaded and replaced concurrently.
+ *
+ * Used to publish immutable snapshots read-copy-update style: readers
+ * load() the current snapshot without taking a lock and keep it alive for as
+ * long as they hold the returned pointer, writers build a new snapshot and
+ * store() it.
+ *
+ * Maps to std::atomic<std::shared_ptr<T>> where the standard library
+ * provides it, and to the atomic shared_ptr free functions otherwise.
+ *
+ * \tparam T The pointee type, usually const-qualified.
+ */
+template<typename T>
+class AtomicSharedPtr
+{
+public:
+    AtomicSharedPtr() = default;
+
+    [[nodiscard]] std::shared_ptr<T> load() const
+    {
+#if defined(__cpp_lib_atomic_shared_ptr)
+        return mPointer.load(std::memory_order_acquire);
+#else
+        QT_WARNING_PUSH
+        QT_WARNING_DISABLE_DEPRECATED
+        return std::atomic_load_explicit(&mPointer, std::memory_order_acquire);
+        QT_WARNING_POP
+#endif
+    }
+
+    void store(std::shared_ptr<T> pointer)
+    {
+#if defined(__cpp_lib_atomic_shared_ptr)
+        mPointer.store(std::move(pointer), std::memory_order_release);
+#else
+        QT_WARNING_PUSH
+        QT_WARNING_DISABLE_DEPRECATED
+        std::atomic_store_explicit(&mPointer, std::move(pointer), std::memory_order_release);
+        QT_WARNING_POP
+#endif
+    }
+
+private:
+    Q_DISABLE_COPY_MOVE(AtomicSharedPtr)
+
+#if defined(__cpp_lib_atomic_shared_ptr)
+    std::atomic<std::shared_ptr<T>> mPointer;
+#else
+    std::shared_ptr<T> mPointer;
+#endif
+};
+
+} // namespace Log4Qt
+
+#endif // LOG4QT_HELPERS_ATOMICSHAREDPTR_H
@@ -0,0 +1,87 @@
+/******************************************************************************
+ *
+ * This file is part of Log4Qt library.
+ *
+ * Copyright (C) 2007 - 2026 Log4Qt contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+#ifndef LOG4QT_HELPERS_BLOCKINGQUEUE_H
+#define LOG4QT_HELPERS_BLOCKINGQUEUE_H
+
+#include <vector>
+
+namespace Log4Qt
+{
+
+/*!
+ * \brief Interface of the bounded queues that feed an AsyncAppender worker.
+ *
+ * Implementations share the contract of BoundedBlockingQueue: enqueue()
+ * blocks while the queue is full, tryEnqueue() fails fast, dequeue() blocks
+ * until an item is available, and shutdown() releases every blocked caller.
+ * Items still queued at shutdown can be collected with drain().
+ *
+ * \sa BoundedBlockingQueue, MpscRingQueue
+ */
+template<typename T>
+class BlockingQueue
+{
+public:
+    virtual ~BlockingQueue() = default;
+
+    /*!
+     * Enqueues an item, blocking until space is available or shutdown.
+     * \return true if enqueued, false if the queue was shut down.
+     */
+    virtual bool enqueue(const T &item) = 0;
+
+    /*!
+     * Tries to enqueue an item without blocking.
+     * \return true if enqueued, false if the queue is full or shut down.
+     */
+    virtual bool tryEnqueue(const T &item) = 0;
+
+    /*!
+     * Dequeues an item, blocking until one is available or shutdown.
+     * \return true if an item was dequeued, false on shutdown with empty queue.
+     */
+    virtual bool dequeue(T &item) = 0;
+
+    /*!
+     * Drains up to \a maxItems into \a out without blocking.
+     * \return The number of items drained.
+     */
+    virtual int drain(std::vector<T> &out, int maxItems) = 0;
+
+    /*!
+     * Signals shutdown. All blocking enqueue/dequeue calls return false.
+     * Items already in the queue can still be drained.
+     */
+    virtual void shutdown() = 0;
+
+    [[nodiscard]] virtual int size() const = 0;
+    [[nodiscard]] virtual int capacity() const = 0;
+    [[nodiscard]] virtual bool isEmpty() const = 0;
+
+protected:
+    BlockingQueue() = default;
+    BlockingQueue(const BlockingQueue &) = delete;
+    BlockingQueue &operator=(const BlockingQueue &) = delete;
+};
+
+} // namespace Log4Qt
+
+#endif // LOG4QT_HELPERS_BLOCKINGQUEUE_H
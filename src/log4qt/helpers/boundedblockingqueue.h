@@ -21,6 +21,8 @@
 #ifndef LOG4QT_HELPERS_BOUNDEDBLOCKINGQUEUE_H
 #define LOG4QT_HELPERS_BOUNDEDBLOCKINGQUEUE_H
 
+#include "log4qt/helpers/blockingqueue.h"
+
 #include <QMutex>
 #include <QMutexLocker>
 #include <QWaitCondition>
@@ -39,9 +41,11 @@ namespace Log4Qt
  * is available or the queue is shut down.
  *
  * \tparam T Element type. Must be default-constructible and move-assignable.
+ *
+ * \sa MpscRingQueue
  */
 template<typename T>
-class BoundedBlockingQueue
+class BoundedBlockingQueue final : public BlockingQueue<T>
 {
 public:
     explicit BoundedBlockingQueue(int capacity)
@@ -54,7 +58,7 @@ public:
      * Enqueues an item, blocking until space is available or shutdown.
      * \return true if enqueued, false if the queue was shut down.
      */
-    bool enqueue(const T &item)
+    bool enqueue(const T &item) override
     {
         QMutexLocker locker(&mMutex);
         while (mSize == mCapacity && !mShutdown.load(std::memory_order_relaxed))
@@ -75,7 +79,7 @@ public:
      * Tries to enqueue an item without blocking.
      * \return true if enqueued, false if the queue is full or shut down.
      */
-    bool tryEnqueue(const T &item)
+    bool tryEnqueue(const T &item) override
     {
         QMutexLocker locker(&mMutex);
         if (mSize == mCapacity || mShutdown.load(std::memory_order_relaxed))
@@ -93,7 +97,7 @@ public:
      * Dequeues an item, blocking until one is available or shutdown.
      * \return true if an item was dequeued, false on shutdown with empty queue.
      */
-    bool dequeue(T &item)
+    bool dequeue(T &item) override
     {
         QMutexLocker locker(&mMutex);
         while (mSize == 0 && !mShutdown.load(std::memory_order_relaxed))
@@ -115,7 +119,7 @@ public:
      * Drains up to \a maxItems into \a out without blocking.
      * \return The number of items drained.
      */
-    int drain(std::vector<T> &out, int maxItems)
+    int drain(std::vector<T> &out, int maxItems) override
     {
         QMutexLocker locker(&mMutex);
         const int count = (std::min)(mSize, maxItems);
@@ -139,7 +143,7 @@ public:
      * Signals shutdown. All blocking enqueue/dequeue calls return false.
      * Items already in the queue can still be drained.
      */
-    void shutdown()
+    void shutdown() override
     {
         QMutexLocker locker(&mMutex);
         mShutdown.store(true, std::memory_order_relaxed);
@@ -147,15 +151,15 @@ public:
         mNotEmpty.wakeAll();
     }
 
-    [[nodiscard]] int size() const
+    [[nodiscard]] int size() const override
     {
         QMutexLocker locker(&mMutex);
         return mSize;
     }
 
-    [[nodiscard]] int capacity() const { return mCapacity; }
+    [[nodiscard]] int capacity() const override { return mCapacity; }
 
-    [[nodiscard]] bool isEmpty() const
+    [[nodiscard]] bool isEmpty() const override
     {
         QMutexLocker locker(&mMutex);
         return mSize == 0;
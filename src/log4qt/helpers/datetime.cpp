@@ -21,9 +21,14 @@
 #include "helpers/datetime.h"
 
 #include "helpers/initialisationhelper.h"
+#include "helpers/threadlocaldata.h"
 
-#include <atomic>
+#include <QHash>
 #include <QReadWriteLock>
+#include <QTime>
+
+#include <atomic>
+#include <optional>
 
 using namespace Qt::StringLiterals;
 
@@ -33,14 +38,6 @@ namespace Log4Qt
 namespace
 {
 
-// Thread-local cache for a single formatted timestamp.
-// epochMs == -1 means the cache is empty.
-struct TimestampCache
-{
-    qint64 epochMs = -1;
-    QString str;
-};
-
 // -----------------------------------------------------------------------
 // currentMSecsSinceEpoch() caching state
 // -----------------------------------------------------------------------
@@ -67,6 +64,71 @@ static QElapsedTimer s_elapsedTimer = []() {
 
 static QReadWriteLock s_providerLock;
 static DateTime::Provider s_globalProvider = []() { return QDateTime::currentDateTime(); };
+// Time zone of the provider, guarded by s_providerLock. Empty until
+// providerTimeZone() first asks an installed provider for it. The generation
+// is bumped on every setProvider() so DateTimeFormatter can drop its cached
+// second.
+static std::optional<QTimeZone> s_providerTimeZone{QTimeZone::LocalTime};
+static std::atomic<quint64> s_timeZoneGeneration{0};
+
+// -----------------------------------------------------------------------
+// DateTimeFormatter helpers
+// -----------------------------------------------------------------------
+
+// Stands in for the millisecond fields when the rest of a format is
+// rendered; a private use character no QDateTime field produces.
+constexpr char16_t millisMarker = u'\xE000';
+
+// Newer Qt versions render 'z' as the fraction of the second without
+// trailing zeroes, older ones as the millisecond count without leading zeroes.
+bool isMillisFraction()
+{
+    static const bool fraction = QTime(0, 0, 0, 20).toString(u"z"_s) == u"02"_s;
+    return fraction;
+}
+
+qint64 floorSecond(qint64 msecs)
+{
+    return msecs >= 0 ? msecs / 1000 : -((-msecs + 999) / 1000);
+}
+
+// Writes the millisecond field for ms (0 to 999) into buffer and returns its length
+int millisDigits(int ms, bool padded, char *buffer)
+{
+    if (!padded && !isMillisFraction())
+    {
+        int length = 0;
+        if (ms >= 100)
+            buffer[length++] = char('0' + ms / 100);
+        if (ms >= 10)
+            buffer[length++] = char('0' + ms / 10 % 10);
+        buffer[length++] = char('0' + ms % 10);
+        return length;
+    }
+    buffer[0] = char('0' + ms / 100);
+    buffer[1] = char('0' + ms / 10 % 10);
+    buffer[2] = char('0' + ms % 10);
+    int length = 3;
+    if (!padded)
+    {
+        if (buffer[length - 1] == '0')
+            --length;
+        if (buffer[length - 1] == '0')
+            --length;
+    }
+    return length;
+}
+
+QString namedFormat(const QString &format)
+{
+    if (format == u"ISO8601"_s)
+        return u"yyyy-MM-dd hh:mm:ss.zzz"_s;
+    if (format == u"ABSOLUTE"_s)
+        return u"HH:mm:ss.zzz"_s;
+    if (format == u"DATE"_s)
+        return u"dd MM yyyy HH:mm:ss.zzz"_s;
+    return format;
+}
 
 } // anonymous namespace
 
@@ -76,11 +138,9 @@ DateTime::~DateTime() = default;
 
 DateTime::DateTime(const DateTime &other) noexcept = default;
 
-// Static fast path: formats epoch ms without constructing a QDateTime for the
-// named formats. Named formats are cached thread-locally (keyed by epoch ms)
-// so that repeated calls within the same millisecond cost only a qint64
-// comparison and a string copy (~1 ns). On a cache miss, formatting is
-// delegated to QDateTime::toString() as usual.
+// Static fast path: formats epoch ms through a DateTimeFormatter compiled
+// once per format and thread. Repeated calls within the same second only
+// fill in the millisecond digits.
 QString DateTime::formatMsecs(qint64 msecs, const QString &format)
 {
     if (format.isEmpty())
@@ -91,40 +151,19 @@ QString DateTime::formatMsecs(qint64 msecs, const QString &format)
     if (format == u"RELATIVE"_s)
         return QString::number(msecs - InitialisationHelper::startTime());
 
-    if (format == u"ISO8601"_s)
-    {
-        thread_local TimestampCache cache;
-        if (cache.epochMs != msecs)
-        {
-            cache.epochMs = msecs;
-            cache.str = QDateTime::fromMSecsSinceEpoch(msecs).toString(u"yyyy-MM-dd hh:mm:ss.zzz"_s);
-        }
-        return cache.str;
-    }
-
-    if (format == u"ABSOLUTE"_s)
-    {
-        thread_local TimestampCache cache;
-        if (cache.epochMs != msecs)
-        {
-            cache.epochMs = msecs;
-            cache.str = QDateTime::fromMSecsSinceEpoch(msecs).toString(u"HH:mm:ss.zzz"_s);
-        }
-        return cache.str;
-    }
-
-    if (format == u"DATE"_s)
+    // Bounded, a caller cycling through generated formats must not grow it
+    // forever. Held by ThreadLocalData, formatting stays safe at thread exit.
+    constexpr qsizetype maxCachedFormats = 16;
+    using Formatters = QHash<QString, std::shared_ptr<const DateTimeFormatter>>;
+    Formatters &formatters = ThreadLocalData<DateTimeFormatter, Formatters>::get();
+    auto it = formatters.constFind(format);
+    if (it == formatters.cend())
     {
-        thread_local TimestampCache cache;
-        if (cache.epochMs != msecs)
-        {
-            cache.epochMs = msecs;
-            cache.str = QDateTime::fromMSecsSinceEpoch(msecs).toString(u"dd MM yyyy HH:mm:ss.zzz"_s);
-        }
-        return cache.str;
+        if (formatters.size() >= maxCachedFormats)
+            formatters.clear();
+        it = formatters.insert(format, std::make_shared<const DateTimeFormatter>(format));
     }
-
-    return QDateTime::fromMSecsSinceEpoch(msecs).toString(format);
+    return it.value()->format(msecs);
 }
 
 QString DateTime::toString(const QString &format) const
@@ -148,8 +187,41 @@ DateTime DateTime::currentDateTime()
 void DateTime::setProvider(Provider provider)
 {
     QWriteLocker lk(&s_providerLock);
-    s_globalProvider = provider ? std::move(provider)
-                                : []() { return QDateTime::currentDateTime(); };
+    if (provider)
+    {
+        s_globalProvider = std::move(provider);
+        s_providerTimeZone.reset();
+    }
+    else
+    {
+        s_globalProvider = []() { return QDateTime::currentDateTime(); };
+        s_providerTimeZone = QTimeZone(QTimeZone::LocalTime);
+    }
+    s_timeZoneGeneration.fetch_add(1, std::memory_order_release);
+}
+
+QTimeZone DateTime::providerTimeZone()
+{
+    Provider provider;
+    quint64 generation = 0;
+    {
+        QReadLocker lk(&s_providerLock);
+        if (s_providerTimeZone)
+            return *s_providerTimeZone;
+        provider = s_globalProvider;
+        generation = s_timeZoneGeneration.load(std::memory_order_relaxed);
+    }
+
+    // Sampled outside the lock, the provider may well read the clock itself
+    const QDateTime sample = provider();
+    const QTimeZone timeZone = sample.isValid() ? sample.timeRepresentation()
+                                                : QTimeZone(QTimeZone::LocalTime);
+
+    QWriteLocker lk(&s_providerLock);
+    // A provider installed meanwhile is sampled by its own first caller
+    if (!s_providerTimeZone && s_timeZoneGeneration.load(std::memory_order_relaxed) == generation)
+        s_providerTimeZone = timeZone;
+    return timeZone;
 }
 
 qint64 DateTime::currentMSecsSinceEpoch()
@@ -189,4 +261,179 @@ qint64 DateTime::cacheWindow()
     return s_cacheWindowMs.load(std::memory_order_relaxed);
 }
 
+// One rendered second: the text between the millisecond fields, as string
+// and as UTF-8. Without parts the format could not be split and every call
+// renders the complete timestamp.
+struct DateTimeFormatter::Second
+{
+    qint64 second = 0;
+    quint64 generation = 0;
+    QTimeZone timeZone;
+    QList<QString> parts;
+    QList<QByteArray> utf8Parts;
+    qsizetype length = 0;
+};
+
+DateTimeFormatter::DateTimeFormatter(const QString &format) :
+    mPattern(format),
+    mKind(Format),
+    mFormat(namedFormat(format))
+{
+    if (format.isEmpty() || format == u"NONE"_s)
+    {
+        mKind = Empty;
+        return;
+    }
+    if (format == u"RELATIVE"_s)
+    {
+        mKind = Relative;
+        return;
+    }
+
+    // Replace the millisecond fields outside quoted text with the marker.
+    // The quoting rules follow QDateTime::toString(): '' is a literal quote,
+    // within quotes as well as outside.
+    mMarkedFormat.reserve(mFormat.size());
+    const qsizetype size = mFormat.size();
+    qsizetype i = 0;
+    while (i < size)
+    {
+        const QChar c = mFormat.at(i);
+        if (c == u'\'')
+        {
+            const qsizetype start = i++;
+            if (i < size && mFormat.at(i) == u'\'')
+                ++i;
+            else
+            {
+                while (i < size)
+                {
+                    if (mFormat.at(i) == u'\'')
+                    {
+                        if (i + 1 < size && mFormat.at(i + 1) == u'\'')
+                        {
+                            i += 2;
+                            continue;
+                        }
+                        ++i;
+                        break;
+                    }
+                    ++i;
+                }
+            }
+            mMarkedFormat.append(QStringView(mFormat).sliced(start, i - start));
+            continue;
+        }
+        if (c == u'z')
+        {
+            qsizetype run = 0;
+            while (i < size && mFormat.at(i) == u'z')
+            {
+                ++run;
+                ++i;
+            }
+            // zzzz is zzz followed by z, as for QDateTime::toString()
+            for (; run >= 3; run -= 3)
+            {
+                mMarkedFormat.append(QChar(millisMarker));
+                mMillisPadded.append(true);
+            }
+            for (; run > 0; --run)
+            {
+                mMarkedFormat.append(QChar(millisMarker));
+                mMillisPadded.append(false);
+            }
+            continue;
+        }
+        mMarkedFormat.append(c);
+        ++i;
+    }
+}
+
+DateTimeFormatter::~DateTimeFormatter() = default;
+
+std::shared_ptr<const DateTimeFormatter::Second> DateTimeFormatter::second(qint64 msecs) const
+{
+    const qint64 secs = floorSecond(msecs);
+    const quint64 generation = s_timeZoneGeneration.load(std::memory_order_acquire);
+    auto cached = mSecond.load();
+    if (cached && cached->second == secs && cached->generation == generation)
+        return cached;
+
+    auto rendered = std::make_shared<Second>();
+    rendered->second = secs;
+    rendered->generation = generation;
+    rendered->timeZone = DateTime::providerTimeZone();
+
+    // A marker count that does not match means the format produced the
+    // marker itself; such a format is rendered in full on every call
+    const QString text = QDateTime::fromMSecsSinceEpoch(secs * 1000, rendered->timeZone)
+                             .toString(mMarkedFormat);
+    const QList<QString> parts = text.split(QChar(millisMarker));
+    if (parts.size() == mMillisPadded.size() + 1)
+    {
+        rendered->parts = parts;
+        rendered->utf8Parts.reserve(parts.size());
+        for (const auto &part : parts)
+        {
+            rendered->utf8Parts.append(part.toUtf8());
+            rendered->length += part.size();
+        }
+    }
+    mSecond.store(rendered);
+    return rendered;
+}
+
+QString DateTimeFormatter::format(qint64 msecs) const
+{
+    if (mKind == Empty)
+        return {};
+    if (mKind == Relative)
+        return QString::number(msecs - InitialisationHelper::startTime());
+
+    const auto rendered = second(msecs);
+    if (rendered->parts.isEmpty())
+        return QDateTime::fromMSecsSinceEpoch(msecs, rendered->timeZone).toString(mFormat);
+
+    const int ms = static_cast<int>(msecs - rendered->second * 1000);
+    QString result;
+    result.reserve(rendered->length + 3 * mMillisPadded.size());
+    result.append(rendered->parts.constFirst());
+    for (qsizetype i = 0; i < mMillisPadded.size(); ++i)
+    {
+        char digits[3];
+        const int length = millisDigits(ms, mMillisPadded.at(i), digits);
+        result.append(QLatin1StringView(digits, length));
+        result.append(rendered->parts.at(i + 1));
+    }
+    return result;
+}
+
+void DateTimeFormatter::formatTo(qint64 msecs, QByteArray &dest) const
+{
+    if (mKind == Empty)
+        return;
+    if (mKind == Relative)
+    {
+        dest.append(QByteArray::number(msecs - InitialisationHelper::startTime()));
+        return;
+    }
+
+    const auto rendered = second(msecs);
+    if (rendered->parts.isEmpty())
+    {
+        dest.append(QDateTime::fromMSecsSinceEpoch(msecs, rendered->timeZone).toString(mFormat).toUtf8());
+        return;
+    }
+
+    const int ms = static_cast<int>(msecs - rendered->second * 1000);
+    dest.append(rendered->utf8Parts.constFirst());
+    for (qsizetype i = 0; i < mMillisPadded.size(); ++i)
+    {
+        char digits[3];
+        dest.append(digits, millisDigits(ms, mMillisPadded.at(i), digits));
+        dest.append(rendered->utf8Parts.at(i + 1));
+    }
+}
+
 } // namespace Log4Qt
@@ -22,11 +22,15 @@
 #define LOG4QT_HELPERS_DATETIME_H
 
 #include "log4qt/log4qtshared.h"
+#include "log4qt/helpers/atomicsharedptr.h"
 
+#include <QByteArray>
 #include <QDateTime>
 #include <QElapsedTimer>
+#include <QList>
 #include <QTimeZone>
 #include <functional>
+#include <memory>
 
 namespace Log4Qt
 {
@@ -135,16 +139,13 @@ public:
      * This is the preferred fast path for callers that already hold a raw
      * \c qint64 timestamp (e.g. \c LoggingEvent::timeStamp()), because it avoids
      * the redundant \c toMSecsSinceEpoch() round-trip of the instance overload.
-     * Results for the named formats ISO8601, ABSOLUTE, and DATE are cached
-     * per calling thread (thread-local, keyed by epoch millisecond): repeated
-     * calls within the same millisecond cost only a \c qint64 comparison and a
-     * string copy (~1 ns). On a cache miss, formatting delegates to
-     * \c QDateTime::toString() as usual.
+     * Named and custom formats alike are compiled into a DateTimeFormatter
+     * kept per calling thread, so the date and time fields are rendered once
+     * per second and only the millisecond digits are filled in per call.
      *
-     * For custom (non-named) format strings the method always calls
-     * \c QDateTime::toString(), equivalent to the instance overload.
+     * The timestamp is shown in providerTimeZone().
      *
-     * \sa toString(const QString &format)
+     * \sa toString(const QString &format), DateTimeFormatter
      */
     static QString formatMsecs(qint64 msecs, const QString &format);
 
@@ -188,11 +189,22 @@ public:
      * Passing a null (default-constructed) \c Provider resets to the built-in
      * default of \c QDateTime::currentDateTime().
      *
+     * The provider is not called here. The time zone of the first datetime
+     * it returns to providerTimeZone() becomes the formatting time zone.
+     *
      * Thread-safe. Intended for use in tests — set once before any threads
      * start logging, reset in cleanup.
      */
     static void setProvider(Provider provider);
 
+    /*!
+     * Returns the time zone timestamps are formatted in by formatMsecs() and
+     * DateTimeFormatter: the time representation of the datetime returned by
+     * the provider passed to setProvider(), sampled on the first call after
+     * the provider was set. The default is local time.
+     */
+    static QTimeZone providerTimeZone();
+
     static DateTime fromMSecsSinceEpoch(qint64 msecs, QTimeZone timeZone)
     {
         return DateTime(QDateTime::fromMSecsSinceEpoch(msecs, timeZone));
@@ -207,6 +219,68 @@ private:
     QString formatDateTime(const QString &format) const;
 };
 
+/*!
+ * \brief The class DateTimeFormatter formats epoch millisecond timestamps
+ *        with a date format compiled once.
+ *
+ * The format is either a QDateTime format string or one of the named
+ * formats of DateTime::toString(). The millisecond fields (\c z and \c zzz)
+ * are located when the formatter is constructed. Everything else is rendered
+ * by QDateTime::toString() once per second and cached, so formatting a
+ * timestamp within the cached second only fills in the millisecond digits.
+ *
+ * Timestamps are shown in DateTime::providerTimeZone(); the cache is dropped
+ * when DateTime::setProvider() changes it.
+ *
+ * \note All the functions declared in this class are thread-safe.
+ */
+class LOG4QT_EXPORT DateTimeFormatter
+{
+public:
+    explicit DateTimeFormatter(const QString &format);
+    ~DateTimeFormatter();
+
+    /*!
+     * Returns the format the formatter was constructed with.
+     */
+    QString pattern() const
+    {
+        return mPattern;
+    }
+
+    /*!
+     * Returns the timestamp \a msecs formatted as string.
+     */
+    QString format(qint64 msecs) const;
+
+    /*!
+     * Appends the timestamp \a msecs formatted as UTF-8 to \a dest.
+     */
+    void formatTo(qint64 msecs, QByteArray &dest) const;
+
+private:
+    Q_DISABLE_COPY_MOVE(DateTimeFormatter)
+
+    struct Second;
+    std::shared_ptr<const Second> second(qint64 msecs) const;
+
+    enum Kind
+    {
+        Empty,
+        Relative,
+        Format
+    };
+
+    const QString mPattern;
+    Kind mKind;
+    // The Qt format, and the same with each millisecond field replaced by a marker
+    QString mFormat;
+    QString mMarkedFormat;
+    // One entry per millisecond field: true for zzz, false for z
+    QList<bool> mMillisPadded;
+    mutable AtomicSharedPtr<const Second> mSecond;
+};
+
 } // namespace Log4Qt
 
 Q_DECLARE_TYPEINFO(Log4Qt::DateTime, Q_MOVABLE_TYPE);
@@ -0,0 +1,218 @@
+/******************************************************************************
+ *
+ * This file is part of Log4Qt library.
+ *
+ * Copyright (C) 2007 - 2026 Log4Qt contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+#ifndef LOG4QT_HELPERS_DEFERREDMESSAGE_H
+#define LOG4QT_HELPERS_DEFERREDMESSAGE_H
+
+#include <QChar>
+#include <QString>
+
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace Log4Qt
+{
+
+/*!
+ * \brief A message text that may be formatted on first access.
+ *
+ * Holds either a ready QString or a format string plus the arguments for a
+ * chain of QString::arg() calls. The arguments are captured in a small
+ * inline buffer - a heap block only if they do not fit - and the text is
+ * built on the first call to text(), from whichever thread makes it. That
+ * is normally the AsyncAppender worker, which takes the formatting off the
+ * logging thread.
+ *
+ * Arithmetic values, QChar and QString are captured as they are; any other
+ * argument is converted with QString::arg() when it is captured, so nothing
+ * refers back into the caller's memory. The result equals formatting
+ * eagerly.
+ *
+ * \note text() may be called concurrently, the first caller formats and the
+ *       others wait for it. defer(), setText() and assignment must not race
+ *       with any other access.
+ */
+class DeferredMessage
+{
+public:
+    DeferredMessage() = default;
+    explicit DeferredMessage(QString text) noexcept
+        : mText(std::move(text))
+    {}
+    // Copies get the formatted text
+    DeferredMessage(const DeferredMessage &other)
+        : mText(other.text())
+    {}
+    DeferredMessage &operator=(const DeferredMessage &other)
+    {
+        if (this != &other)
+            setText(other.text());
+        return *this;
+    }
+    ~DeferredMessage()
+    {
+        reset();
+    }
+
+    /*!
+     * Replaces the message with \a format, to be completed with \a args
+     * on the first call to text().
+     */
+    template<typename ...Ts>
+    void defer(const QString &format, Ts &&...args)
+    {
+        using Capture = std::tuple<Argument<Ts>...>;
+
+        reset();
+        if constexpr (sizeof(Capture) <= InlineSize && alignof(Capture) <= alignof(std::max_align_t))
+        {
+            new (mCapture) Capture(capture(std::forward<Ts>(args))...);
+            mFormat = [](const QString &text, void *storage)
+            {
+                auto *arguments = std::launder(static_cast<Capture *>(storage));
+                QString result = formatWith(text, *arguments);
+                arguments->~Capture();
+                return result;
+            };
+            mDestroy = [](void *storage)
+            {
+                std::launder(static_cast<Capture *>(storage))->~Capture();
+            };
+        }
+        else
+        {
+            new (mCapture) Capture *(new Capture(capture(std::forward<Ts>(args))...));
+            mFormat = [](const QString &text, void *storage)
+            {
+                Capture *arguments = *std::launder(static_cast<Capture **>(storage));
+                QString result = formatWith(text, *arguments);
+                delete arguments;
+                return result;
+            };
+            mDestroy = [](void *storage)
+            {
+                delete *std::launder(static_cast<Capture **>(storage));
+            };
+        }
+        mText = format;
+        mState.store(Pending, std::memory_order_release);
+    }
+
+    void setText(QString text)
+    {
+        reset();
+        mText = std::move(text);
+    }
+
+    [[nodiscard]] const QString &text() const
+    {
+        if (mState.load(std::memory_order_acquire) != Ready)
+            materialise();
+        return mText;
+    }
+
+    [[nodiscard]] bool isDeferred() const
+    {
+        return mState.load(std::memory_order_acquire) != Ready;
+    }
+
+private:
+    enum State : int
+    {
+        Ready,
+        Pending,
+        Formatting
+    };
+
+    // Room for the format arguments of a typical statement, e.g. a QString
+    // and two numbers
+    static constexpr std::size_t InlineSize = 48;
+
+    // Formats the text and destroys the capture
+    using FormatFunction = QString (*)(const QString &format, void *capture);
+    using DestroyFunction = void (*)(void *capture);
+
+    template<typename T>
+    static constexpr bool capturedAsIs = std::is_arithmetic_v<std::decay_t<T>>
+                                         || std::is_enum_v<std::decay_t<T>>
+                                         || std::is_same_v<std::decay_t<T>, QChar>
+                                         || std::is_same_v<std::decay_t<T>, QString>;
+
+    template<typename T>
+    using Argument = std::conditional_t<capturedAsIs<T>, std::decay_t<T>, QString>;
+
+    template<typename T>
+    static Argument<T> capture(T &&value)
+    {
+        if constexpr (capturedAsIs<T>)
+            return std::forward<T>(value);
+        else
+            return QStringLiteral("%1").arg(std::forward<T>(value));
+    }
+
+    template<typename Capture>
+    static QString formatWith(const QString &format, const Capture &arguments)
+    {
+        return std::apply([&format](const auto &...values)
+        {
+            QString result = format;
+            ((result = result.arg(values)), ...);
+            return result;
+        }, arguments);
+    }
+
+    void materialise() const
+    {
+        int state = Pending;
+        if (mState.compare_exchange_strong(state, Formatting, std::memory_order_acquire))
+        {
+            mText = mFormat(mText, mCapture);
+            mState.store(Ready, std::memory_order_release);
+            mState.notify_all();
+            return;
+        }
+        while (state != Ready)
+        {
+            mState.wait(state, std::memory_order_acquire);
+            state = mState.load(std::memory_order_acquire);
+        }
+    }
+
+    void reset()
+    {
+        if (mState.load(std::memory_order_relaxed) == Pending)
+            mDestroy(mCapture);
+        mState.store(Ready, std::memory_order_relaxed);
+    }
+
+    mutable QString mText;                      // the format while deferred
+    mutable std::atomic<int> mState{Ready};
+    FormatFunction mFormat = nullptr;
+    DestroyFunction mDestroy = nullptr;
+    alignas(std::max_align_t) mutable std::byte mCapture[InlineSize];
+};
+
+} // namespace Log4Qt
+
+#endif // LOG4QT_HELPERS_DEFERREDMESSAGE_H
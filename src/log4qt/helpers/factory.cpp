@@ -20,6 +20,7 @@
 
 #include "helpers/factory.h"
 
+#include "binarylayout.h"
 #include "consoleappender.h"
 #include "fileappender.h"
 #include "helpers/logerror.h"
@@ -66,7 +67,10 @@ using namespace Qt::StringLiterals;
 #include "varia/levelmatchfilter.h"
 #include "varia/levelrangefilter.h"
 #include "varia/listappender.h"
+#include "varia/mdcmatchfilter.h"
+#include "varia/multistringmatchfilter.h"
 #include "varia/nullappender.h"
+#include "varia/regexfilter.h"
 #include "varia/stringmatchfilter.h"
 
 #include <QMetaObject>
@@ -182,6 +186,21 @@ Filter *create_string_match_filter()
     return new StringMatchFilter;
 }
 
+Filter *create_multi_string_match_filter()
+{
+    return new MultiStringMatchFilter;
+}
+
+Filter *create_regex_filter()
+{
+    return new RegexFilter;
+}
+
+Filter *create_mdc_match_filter()
+{
+    return new MdcMatchFilter;
+}
+
 // Layouts
 
 AbstractLayout *create_pattern_layout()
@@ -221,6 +240,11 @@ AbstractLayout *create_json_layout()
     return new JsonLayout;
 }
 
+AbstractLayout *create_binary_layout()
+{
+    return new BinaryLayout;
+}
+
 // TriggeringPolicies
 
 TriggeringPolicy *create_size_based_triggering_policy()
@@ -634,6 +658,12 @@ void Factory::registerDefaultFilters()
     mFilterRegistry.insert(u"org.apache.log4j.varia.StringMatchFilter"_s, create_string_match_filter);
     mFilterRegistry.insert(u"Log4Qt::StringMatchFilter"_s, create_string_match_filter);
     mFilterRegistry.insert(u"StringMatch"_s, create_string_match_filter);
+    mFilterRegistry.insert(u"Log4Qt::MultiStringMatchFilter"_s, create_multi_string_match_filter);
+    mFilterRegistry.insert(u"MultiStringMatch"_s, create_multi_string_match_filter);
+    mFilterRegistry.insert(u"Log4Qt::RegexFilter"_s, create_regex_filter);
+    mFilterRegistry.insert(u"Regex"_s, create_regex_filter);
+    mFilterRegistry.insert(u"Log4Qt::MdcMatchFilter"_s, create_mdc_match_filter);
+    mFilterRegistry.insert(u"MdcMatch"_s, create_mdc_match_filter);
 }
 
 
@@ -665,6 +695,9 @@ void Factory::registerDefaultLayouts()
 
     mLayoutRegistry.insert(u"Log4Qt::JsonLayout"_s, create_json_layout);
     mLayoutRegistry.insert(u"JsonLayout"_s, create_json_layout);
+
+    mLayoutRegistry.insert(u"Log4Qt::BinaryLayout"_s, create_binary_layout);
+    mLayoutRegistry.insert(u"BinaryLayout"_s, create_binary_layout);
 }
 
 
@@ -0,0 +1,95 @@
+/******************************************************************************
+ *
+ * This file is part of Log4Qt library.
+ *
+ * Copyright (C) 2007 - 2026 Log4Qt contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+#include "helpers/formatstring.h"
+
+#include <QLocale>
+
+#include <algorithm>
+#include <charconv>
+
+namespace Log4Qt
+{
+
+void FormatArgument::writeTo(char16_t *out) const
+{
+    if (mLatin1)
+    {
+        const auto *in = static_cast<const char *>(mData);
+        std::transform(in, in + mSize, out, [](char c) { return static_cast<char16_t>(static_cast<uchar>(c)); });
+    }
+    else
+    {
+        const auto *in = static_cast<const char16_t *>(mData);
+        std::copy(in, in + mSize, out);
+    }
+}
+
+QString FormatArgument::render(QStringView literal, const qsizetype *positions,
+                               const FormatArgument *arguments, qsizetype count)
+{
+    qsizetype size = literal.size();
+    for (qsizetype i = 0; i < count; ++i)
+        size += arguments[i].size();
+
+    QString result(size, Qt::Uninitialized);
+    auto *out = reinterpret_cast<char16_t *>(result.data());
+    const char16_t *text = literal.utf16();
+    qsizetype from = 0;
+    for (qsizetype i = 0; i < count; ++i)
+    {
+        out = std::copy(text + from, text + positions[i], out);
+        from = positions[i];
+        arguments[i].writeTo(out);
+        out += arguments[i].size();
+    }
+    std::copy(text + from, text + literal.size(), out);
+    return result;
+}
+
+void FormatArgument::setInteger(long long value)
+{
+    const auto result = std::to_chars(mBuffer, mBuffer + sizeof(mBuffer), value);
+    setLatin1(mBuffer, result.ptr - mBuffer);
+}
+
+void FormatArgument::setInteger(unsigned long long value)
+{
+    const auto result = std::to_chars(mBuffer, mBuffer + sizeof(mBuffer), value);
+    setLatin1(mBuffer, result.ptr - mBuffer);
+}
+
+void FormatArgument::setFloatingPoint(double value)
+{
+    setOwned(QString::number(value, 'g', QLocale::FloatingPointShortest));
+}
+
+void FormatArgument::setUtf8(const char *value)
+{
+    setOwned(QString::fromUtf8(value));
+}
+
+void FormatArgument::setOwned(QString value)
+{
+    mOwned = std::move(value);
+    setUtf16(QStringView(mOwned));
+}
+
+} // namespace Log4Qt
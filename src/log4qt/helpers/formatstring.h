@@ -0,0 +1,300 @@
+/******************************************************************************
+ *
+ * This file is part of Log4Qt library.
+ *
+ * Copyright (C) 2007 - 2026 Log4Qt contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+#ifndef LOG4QT_HELPERS_FORMATSTRING_H
+#define LOG4QT_HELPERS_FORMATSTRING_H
+
+#include "log4qt/log4qtshared.h"
+
+#include <QChar>
+#include <QLatin1StringView>
+#include <QString>
+#include <QStringView>
+
+#include <array>
+#include <cstddef>
+#include <type_traits>
+
+namespace Log4Qt
+{
+
+/*!
+ * \brief A string literal usable as a template argument of FormatString
+ * and StaticPatternLayout.
+ */
+template<std::size_t N>
+struct FormatLiteral
+{
+    consteval FormatLiteral(const char (&text)[N])
+    {
+        for (std::size_t i = 0; i < N; ++i)
+            value[i] = text[i];
+    }
+
+    char value[N] {};
+};
+
+/*!
+ * \brief One argument of a FormatString, converted to text.
+ *
+ * Strings are referenced, numbers are written into an inline buffer; only
+ * UTF-8 strings, floating point numbers and types that need QString::arg()
+ * are converted into an owned QString. Bool renders as "true"/"false", char
+ * as a Latin-1 character and enums as their underlying integer.
+ *
+ * The object may point into its own buffer and into the argument it was
+ * built from, so it is neither copyable nor movable and must not outlive
+ * the full-expression that created it.
+ */
+class LOG4QT_EXPORT FormatArgument
+{
+public:
+    template<typename T>
+    FormatArgument(const T &value)
+    {
+        using Type = std::remove_cvref_t<T>;
+        if constexpr (std::is_same_v<Type, QString> || std::is_same_v<Type, QStringView>)
+            setUtf16(QStringView(value));
+        else if constexpr (std::is_same_v<Type, QLatin1StringView>)
+            setLatin1(value.data(), value.size());
+        else if constexpr (std::is_same_v<Type, QChar>)
+            setChar(value.unicode());
+        else if constexpr (std::is_same_v<Type, bool>)
+            value ? setLatin1("true", 4) : setLatin1("false", 5);
+        else if constexpr (std::is_same_v<Type, char>)
+            setChar(static_cast<uchar>(value));
+        else if constexpr (std::is_enum_v<Type>)
+            setInteger(static_cast<std::underlying_type_t<Type>>(value));
+        else if constexpr (std::is_integral_v<Type>)
+            setInteger(value);
+        else if constexpr (std::is_floating_point_v<Type>)
+            setFloatingPoint(static_cast<double>(value));
+        else if constexpr (std::is_convertible_v<const T &, const char *>)
+            setUtf8(value);
+        else
+            setOwned(QStringLiteral("%1").arg(value));
+    }
+
+    [[nodiscard]] qsizetype size() const { return mSize; }
+
+    // Writes the text to out, which has room for size() characters
+    void writeTo(char16_t *out) const;
+
+    /*!
+     * Returns \a literal with \a arguments inserted at the ascending
+     * offsets \a positions, allocated once.
+     */
+    static QString render(QStringView literal, const qsizetype *positions,
+                          const FormatArgument *arguments, qsizetype count);
+
+private:
+    Q_DISABLE_COPY_MOVE(FormatArgument)
+
+    void setUtf16(QStringView text)
+    {
+        setUtf16(text.utf16(), text.size());
+    }
+    void setUtf16(const char16_t *data, qsizetype size)
+    {
+        mData = data;
+        mSize = size;
+        mLatin1 = false;
+    }
+    void setLatin1(const char *data, qsizetype size)
+    {
+        mData = data;
+        mSize = size;
+        mLatin1 = true;
+    }
+    void setChar(char16_t character)
+    {
+        mCharacter = character;
+        setUtf16(&mCharacter, 1);
+    }
+    void setInteger(long long value);
+    void setInteger(unsigned long long value);
+    template<typename I>
+    void setInteger(I value)
+    {
+        if constexpr (std::is_signed_v<I>)
+            setInteger(static_cast<long long>(value));
+        else
+            setInteger(static_cast<unsigned long long>(value));
+    }
+    void setFloatingPoint(double value);
+    void setUtf8(const char *value);
+    void setOwned(QString value);
+
+    const void *mData = nullptr;
+    qsizetype mSize = 0;
+    bool mLatin1 = false;
+    char16_t mCharacter = 0;
+    char mBuffer[24];                       // integers in decimal
+    QString mOwned;
+};
+
+/*!
+ * \brief A format string with {} placeholders, parsed at compile time.
+ *
+ * Created with the L4Q_FMT() macro and accepted by the Logger functions in
+ * place of a QString message:
+ *
+ * \code
+ * logger()->info(L4Q_FMT("user {} took {} ms"), id, elapsed);
+ * \endcode
+ *
+ * The literal is decoded from UTF-8 and split at its placeholders at
+ * compile time. Formatting measures every argument, allocates the result
+ * once and copies literal segments and arguments in one pass, where a
+ * chain of QString::arg() calls rescans and reallocates the whole string
+ * per argument. "{{" and "}}" produce literal braces; any other brace, and
+ * a call with more or fewer arguments than placeholders, does not compile.
+ *
+ * \sa FormatArgument
+ */
+template<FormatLiteral Literal>
+class FormatString
+{
+    static constexpr std::size_t Capacity = sizeof(Literal.value);
+
+    struct Parsed
+    {
+        std::array<char16_t, Capacity> text {};
+        qsizetype size = 0;
+        std::array<qsizetype, Capacity> positions {};  // insertion points in text
+        qsizetype placeholders = 0;
+    };
+
+    // Not constexpr: reaching it while parsing stops compilation
+    static void invalidFormatString(const char *) {}
+
+    static consteval Parsed parse()
+    {
+        Parsed parsed;
+        const char *in = Literal.value;
+        const std::size_t length = Capacity - 1;
+        for (std::size_t i = 0; i < length;)
+        {
+            const auto byte = static_cast<unsigned char>(in[i]);
+            if (byte == '{' || byte == '}')
+            {
+                const bool doubled = i + 1 < length && in[i + 1] == in[i];
+                if (byte == '{' && !doubled)
+                {
+                    if (i + 1 >= length || in[i + 1] != '}')
+                        invalidFormatString("unmatched '{', use '{{' for a literal brace");
+                    parsed.positions[static_cast<std::size_t>(parsed.placeholders++)] = parsed.size;
+                }
+                else if (!doubled)
+                {
+                    invalidFormatString("unmatched '}', use '}}' for a literal brace");
+                }
+                else
+                {
+                    parsed.text[static_cast<std::size_t>(parsed.size++)] = byte;
+                }
+                i += 2;
+                continue;
+            }
+
+            // UTF-8 to UTF-16
+            char32_t code = byte;
+            std::size_t extra = 0;
+            if (byte >= 0xF0)
+            {
+                code = byte & 0x07;
+                extra = 3;
+            }
+            else if (byte >= 0xE0)
+            {
+                code = byte & 0x0F;
+                extra = 2;
+            }
+            else if (byte >= 0xC0)
+            {
+                code = byte & 0x1F;
+                extra = 1;
+            }
+            else if (byte >= 0x80)
+            {
+                invalidFormatString("invalid UTF-8");
+            }
+            if (extra > 0 && i + extra >= length)
+                invalidFormatString("truncated UTF-8 sequence");
+            for (std::size_t k = 1; k <= extra; ++k)
+            {
+                const auto next = static_cast<unsigned char>(in[i + k]);
+                if ((next & 0xC0) != 0x80)
+                    invalidFormatString("invalid UTF-8");
+                code = (code << 6) | (next & 0x3F);
+            }
+            i += extra + 1;
+            if (code >= 0x10000)
+            {
+                code -= 0x10000;
+                parsed.text[static_cast<std::size_t>(parsed.size++)] = static_cast<char16_t>(0xD800 + (code >> 10));
+                parsed.text[static_cast<std::size_t>(parsed.size++)] = static_cast<char16_t>(0xDC00 + (code & 0x3FF));
+            }
+            else
+            {
+                parsed.text[static_cast<std::size_t>(parsed.size++)] = static_cast<char16_t>(code);
+            }
+        }
+        return parsed;
+    }
+
+    static constexpr Parsed parsed = parse();
+
+public:
+    //! The number of {} placeholders
+    static constexpr qsizetype argumentCount = parsed.placeholders;
+
+    //! The literal text, braces unescaped, without the placeholders
+    [[nodiscard]] static constexpr QStringView literal()
+    {
+        return QStringView(parsed.text.data(), parsed.size);
+    }
+
+    template<typename ...Ts>
+    [[nodiscard]] QString operator()(const Ts &...args) const
+    {
+        static_assert(sizeof...(Ts) == argumentCount,
+                      "L4Q_FMT: the number of arguments does not match the number of {} placeholders");
+        if constexpr (sizeof...(Ts) == 0)
+        {
+            return literal().toString();
+        }
+        else
+        {
+            const FormatArgument arguments[] = {args...};
+            return FormatArgument::render(literal(), parsed.positions.data(), arguments, argumentCount);
+        }
+    }
+};
+
+} // namespace Log4Qt
+
+/*!
+ * L4Q_FMT creates a Log4Qt::FormatString from the string literal \a text,
+ * see Log4Qt::FormatString.
+ */
+#define L4Q_FMT(text) ::Log4Qt::FormatString<text>{}
+
+#endif // LOG4QT_HELPERS_FORMATSTRING_H
@@ -0,0 +1,290 @@
+/******************************************************************************
+ *
+ * This file is part of Log4Qt library.
+ *
+ * Copyright (C) 2007 - 2026 Log4Qt contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+#ifndef LOG4QT_HELPERS_MPSCRINGQUEUE_H
+#define LOG4QT_HELPERS_MPSCRINGQUEUE_H
+
+#include "log4qt/helpers/blockingqueue.h"
+
+#include <QMutex>
+#include <QMutexLocker>
+#include <QThread>
+#include <QWaitCondition>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace Log4Qt
+{
+
+/*!
+ * \brief A bounded lock-free multi-producer / single-consumer ring buffer.
+ *
+ * Producers claim a slot with a single compare-and-swap on the tail
+ * counter and publish it through the slot's sequence number; the consumer
+ * never takes a lock on the fast path. Each slot carries its own sequence
+ * number (Vyukov's bounded queue), so a slot is only reused once the
+ * consumer has released it and producers never observe a half-written
+ * element. Head and tail live on separate cache lines so producers and the
+ * consumer do not false-share.
+ *
+ * Blocking is only used on the slow path: a consumer that finds the queue
+ * empty, or a producer that finds it full, spins briefly and then parks on
+ * a condition variable. The opposite side only touches the mutex when it
+ * sees that somebody is parked.
+ *
+ * The contract matches BoundedBlockingQueue, with one restriction: dequeue()
+ * and drain() must only ever be called from one thread at a time.
+ * shutdown() does not fence out a producer that is already past its
+ * shutdown check: an element such a producer pushes after the consumer's
+ * last drain stays in the ring. AsyncAppender enqueues without a lock and
+ * treats that element like one logged after close().
+ *
+ * \note The ring holds at least two slots: with a single slot the "published
+ *       at n" and "free for n + 1" sequence values coincide.
+ *
+ * \tparam T Element type. Must be default-constructible and move-assignable.
+ *
+ * \sa BoundedBlockingQueue
+ */
+template<typename T>
+class MpscRingQueue final : public BlockingQueue<T>
+{
+public:
+    explicit MpscRingQueue(int capacity)
+        : mCapacity(capacity > 1 ? capacity : 2)
+        , mSlots(std::make_unique<Slot[]>(static_cast<std::size_t>(mCapacity)))
+    {
+        for (std::size_t i = 0; i < static_cast<std::size_t>(mCapacity); ++i)
+            mSlots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    bool enqueue(const T &item) override
+    {
+        for (int spin = 0; ; ++spin)
+        {
+            if (mShutdown.load(std::memory_order_acquire))
+                return false;
+            if (tryPush(item))
+                return true;
+            if (spin < SpinCount)
+            {
+                QThread::yieldCurrentThread();
+                continue;
+            }
+
+            QMutexLocker locker(&mMutex);
+            mWaitingProducers.fetch_add(1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (isFull() && !mShutdown.load(std::memory_order_relaxed))
+                mNotFull.wait(&mMutex, ParkTimeoutMs);
+            mWaitingProducers.fetch_sub(1, std::memory_order_relaxed);
+        }
+    }
+
+    bool tryEnqueue(const T &item) override
+    {
+        if (mShutdown.load(std::memory_order_acquire))
+            return false;
+        return tryPush(item);
+    }
+
+    bool dequeue(T &item) override
+    {
+        for (int spin = 0; ; ++spin)
+        {
+            if (tryPop(item))
+                return true;
+            if (mShutdown.load(std::memory_order_acquire))
+                return tryPop(item);
+            if (spin < SpinCount)
+            {
+                QThread::yieldCurrentThread();
+                continue;
+            }
+
+            QMutexLocker locker(&mMutex);
+            mConsumerWaiting.store(true, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (!hasItem() && !mShutdown.load(std::memory_order_relaxed))
+                mNotEmpty.wait(&mMutex, ParkTimeoutMs);
+            mConsumerWaiting.store(false, std::memory_order_relaxed);
+        }
+    }
+
+    int drain(std::vector<T> &out, int maxItems) override
+    {
+        const int available = (std::min)(size(), maxItems);
+        out.reserve(out.size() + static_cast<std::size_t>(available > 0 ? available : 0));
+
+        int count = 0;
+        T item;
+        while (count < maxItems && tryPop(item))
+        {
+            out.push_back(std::move(item));
+            ++count;
+        }
+        return count;
+    }
+
+    void shutdown() override
+    {
+        QMutexLocker locker(&mMutex);
+        mShutdown.store(true, std::memory_order_release);
+        mNotFull.wakeAll();
+        mNotEmpty.wakeAll();
+    }
+
+    [[nodiscard]] int size() const override
+    {
+        // Read head first: tail only grows, so the difference can overshoot
+        // while producers race but never goes negative.
+        const std::size_t head = mHead.value.load(std::memory_order_acquire);
+        const std::size_t tail = mTail.value.load(std::memory_order_acquire);
+        const std::size_t used = tail - head;
+        return used > static_cast<std::size_t>(mCapacity) ? mCapacity : static_cast<int>(used);
+    }
+
+    [[nodiscard]] int capacity() const override { return mCapacity; }
+
+    [[nodiscard]] bool isEmpty() const override
+    {
+        return size() == 0;
+    }
+
+private:
+    Q_DISABLE_COPY_MOVE(MpscRingQueue)
+
+    static constexpr std::size_t CacheLineSize = 64;
+    static constexpr int SpinCount = 64;
+    // Upper bound for a parked thread; the fences below make lost wake-ups
+    // impossible, the timeout only caps the damage of a missed shutdown.
+    static constexpr unsigned long ParkTimeoutMs = 100;
+
+    struct Slot
+    {
+        std::atomic<std::size_t> sequence{0};
+        T value{};
+    };
+
+    struct alignas(CacheLineSize) PaddedCounter
+    {
+        std::atomic<std::size_t> value{0};
+    };
+
+    Slot &slotAt(std::size_t pos) const
+    {
+        return mSlots[pos % static_cast<std::size_t>(mCapacity)];
+    }
+
+    bool tryPush(const T &item)
+    {
+        std::size_t pos = mTail.value.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            Slot &slot = slotAt(pos);
+            const std::size_t seq = slot.sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::ptrdiff_t>(seq - pos);
+            if (diff == 0)
+            {
+                if (mTail.value.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    slot.value = item;
+                    slot.sequence.store(pos + 1, std::memory_order_release);
+                    break;
+                }
+            }
+            else if (diff < 0)
+            {
+                return false; // full: the consumer has not released this slot yet
+            }
+            else
+            {
+                pos = mTail.value.load(std::memory_order_relaxed);
+            }
+        }
+
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (mConsumerWaiting.load(std::memory_order_relaxed))
+        {
+            QMutexLocker locker(&mMutex);
+            mNotEmpty.wakeOne();
+        }
+        return true;
+    }
+
+    bool tryPop(T &item)
+    {
+        const std::size_t pos = mHead.value.load(std::memory_order_relaxed);
+        Slot &slot = slotAt(pos);
+        if (slot.sequence.load(std::memory_order_acquire) != pos + 1)
+            return false;
+
+        item = std::move(slot.value);
+        slot.value = T{};
+        slot.sequence.store(pos + static_cast<std::size_t>(mCapacity), std::memory_order_release);
+        mHead.value.store(pos + 1, std::memory_order_release);
+
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (mWaitingProducers.load(std::memory_order_relaxed) > 0)
+        {
+            QMutexLocker locker(&mMutex);
+            mNotFull.wakeAll();
+        }
+        return true;
+    }
+
+    [[nodiscard]] bool hasItem() const
+    {
+        const std::size_t pos = mHead.value.load(std::memory_order_relaxed);
+        return slotAt(pos).sequence.load(std::memory_order_acquire) == pos + 1;
+    }
+
+    [[nodiscard]] bool isFull() const
+    {
+        // As in tryPush(): a sequence ahead of pos means another producer has
+        // already taken the slot and the tail moved on; only a sequence behind
+        // pos is a slot the consumer has not released yet.
+        const std::size_t pos = mTail.value.load(std::memory_order_relaxed);
+        const std::size_t seq = slotAt(pos).sequence.load(std::memory_order_acquire);
+        return static_cast<std::ptrdiff_t>(seq - pos) < 0;
+    }
+
+    const int mCapacity;
+    std::unique_ptr<Slot[]> mSlots;
+
+    PaddedCounter mTail;    // next position claimed by a producer
+    PaddedCounter mHead;    // next position read by the consumer
+
+    alignas(CacheLineSize) std::atomic<bool> mShutdown{false};
+    std::atomic<bool> mConsumerWaiting{false};
+    std::atomic<int> mWaitingProducers{0};
+
+    mutable QMutex mMutex;
+    QWaitCondition mNotFull;
+    QWaitCondition mNotEmpty;
+};
+
+} // namespace Log4Qt
+
+#endif // LOG4QT_HELPERS_MPSCRINGQUEUE_H
@@ -29,7 +29,10 @@
 
 #include <QString>
 #include <QStringBuilder>
+#include <QStringEncoder>
 
+#include <charconv>
+#include <iterator>
 #include <utility>
 
 using namespace Qt::StringLiterals;
@@ -37,29 +40,6 @@ using namespace Qt::StringLiterals;
 namespace Log4Qt
 {
 
-/*!
- * \brief The class FormattingInfo stores the formatting modifier for a
- * pattern converter.
- *
- * \sa PatternConverter
- */
-class FormattingInfo
-{
-public:
-    FormattingInfo()
-    {
-        clear();
-    }
-
-    void clear();
-    static QString intToString(int i);
-
-public:
-    int mMinLength;
-    int mMaxLength;
-    bool mLeftAligned;
-};
-
 /*!
  * \brief The class PatternConverter is the abstract base class for all
  * pattern converters.
@@ -153,9 +133,9 @@ class DatePatternConverter : public PatternConverter
 {
 public:
     DatePatternConverter(Log4Qt::FormattingInfo formattingInfo,
-                         const QString &format) :
+                         std::shared_ptr<const DateTimeFormatter> formatter) :
         PatternConverter(formattingInfo),
-        mFormat(format)
+        mFormatter(std::move(formatter))
     {}
 
 private:
@@ -165,7 +145,7 @@ protected:
     void convert(QString &format, const LoggingEvent &loggingEvent) const override;
 
 private:
-    QString mFormat;
+    std::shared_ptr<const DateTimeFormatter> mFormatter;
 };
 
 
@@ -304,6 +284,49 @@ private:
     const QObject * const *mSourceRef;
 };
 
+/*!
+ * \brief The struct Instruction is one step of the UTF-8 program run by
+ *        PatternFormatter::formatTo().
+ *
+ * Each conversion character and each literal of the pattern yields one
+ * instruction. Conversions that have no direct UTF-8 implementation (%X
+ * without a key, %P) delegate to their PatternConverter.
+ */
+struct PatternFormatter::Instruction
+{
+    enum Op
+    {
+        Literal,
+        Message,
+        Ndc,
+        LevelName,
+        Thread,
+        LoggerName,
+        Mdc,
+        Date,
+        Filename,
+        FunctionName,
+        LineNumber,
+        Location,
+        Converter
+    };
+
+    // Every member has a default, so instructions are built with designated
+    // initializers and a new member cannot shift the others.
+    Op op = Literal;
+    FormattingInfo formattingInfo{};
+    // Literal: the encoded text
+    QByteArray literal{};
+    // Mdc: the key
+    QString option{};
+    // Date: the compiled date format, shared with the converter
+    std::shared_ptr<const DateTimeFormatter> dateFormatter{};
+    // LoggerName: the number of trailing name sections, 0 for all
+    int precision = 0;
+    // Converter: the converter to delegate to
+    const PatternConverter *converter = nullptr;
+};
+
 LOG4QT_DECLARE_STATIC_LOGGER(logger, Log4Qt::PatternFormatter)
 
 PatternFormatter::PatternFormatter(const QString &pattern) :
@@ -333,6 +356,263 @@ QString PatternFormatter::format(const LoggingEvent &loggingEvent) const
 }
 
 
+namespace
+{
+
+// Appends \a string to \a dest as UTF-8. ASCII, the common case, is copied
+// unit by unit; the rest goes through Qt's encoder, which replaces invalid
+// surrogates the same way QString::toUtf8() does.
+void appendUtf8(QByteArray &dest, QStringView string)
+{
+    const qsizetype start = dest.size();
+    const qsizetype size = string.size();
+    dest.resize(start + size);
+    char *out = dest.data() + start;
+    const char16_t *in = string.utf16();
+    qsizetype i = 0;
+    for (; i < size && in[i] < 0x80; ++i)
+        out[i] = static_cast<char>(in[i]);
+    if (i == size)
+        return;
+
+    QStringEncoder encoder(QStringEncoder::Utf8, QStringEncoder::Flag::Stateless);
+    const QStringView rest = string.sliced(i);
+    dest.resize(start + i + encoder.requiredSpace(rest.size()));
+    const char *end = encoder.appendToBuffer(dest.data() + start + i, rest);
+    dest.truncate(end - dest.constData());
+}
+
+bool isPlain(const FormattingInfo &formattingInfo)
+{
+    return formattingInfo.mMinLength == 0 && formattingInfo.mMaxLength == INT_MAX;
+}
+
+// The number of UTF-16 code units the UTF-8 text \a utf8 decodes to
+qsizetype utf16Length(QByteArrayView utf8)
+{
+    qsizetype length = 0;
+    for (const char c : utf8)
+    {
+        const auto byte = static_cast<unsigned char>(c);
+        if ((byte & 0xC0) != 0x80)
+            length += byte >= 0xF0 ? 2 : 1;
+    }
+    return length;
+}
+
+// The start of the last \a precision "::" separated sections of \a name,
+// for names that are not a Logger's (see Logger::abbreviatedName())
+qsizetype sectionStart(QStringView name, int precision)
+{
+    if (precision <= 0)
+        return 0;
+    qsizetype begin = name.size();
+    for (int i = precision; i > 0 && begin >= 0; --i)
+        begin = begin > 0 ? name.lastIndexOf(u"::", begin - 1) : -1;
+    return begin < 0 ? 0 : begin + 2;
+}
+
+void appendNumber(QByteArray &dest, int value)
+{
+    char buffer[16];
+    const auto result = std::to_chars(std::begin(buffer), std::end(buffer), value);
+    dest.append(buffer, result.ptr - buffer);
+}
+
+} // namespace
+
+
+void PatternFormatter::formatTo(const LoggingEvent &loggingEvent, QByteArray &dest) const
+{
+    for (const auto &instruction : mInstructions)
+    {
+        const FormattingInfo &formattingInfo = instruction.formattingInfo;
+        switch (instruction.op)
+        {
+        case Instruction::Literal:
+            dest.append(instruction.literal);
+            break;
+        case Instruction::Message:
+            appendFormatted(dest, loggingEvent.message(), formattingInfo);
+            break;
+        case Instruction::Ndc:
+            appendFormatted(dest, loggingEvent.ndc(), formattingInfo);
+            break;
+        case Instruction::LevelName:
+            appendFormatted(dest, levelName(loggingEvent.level()), formattingInfo);
+            break;
+        case Instruction::Thread:
+            appendFormatted(dest, loggingEvent.threadName(), formattingInfo);
+            break;
+        case Instruction::LoggerName:
+            appendLoggerName(dest, loggingEvent, instruction.precision, formattingInfo);
+            break;
+        case Instruction::Mdc:
+            appendFormatted(dest, loggingEvent.property(instruction.option), formattingInfo);
+            break;
+        case Instruction::Date:
+            if (isPlain(formattingInfo))
+                instruction.dateFormatter->formatTo(loggingEvent.timeStamp(), dest);
+            else
+                appendFormatted(dest, instruction.dateFormatter->format(loggingEvent.timeStamp()),
+                                formattingInfo);
+            break;
+        case Instruction::Filename:
+            appendFormatted(dest, fileName(loggingEvent.context()), formattingInfo);
+            break;
+        case Instruction::FunctionName:
+            appendFormatted(dest, functionName(loggingEvent.context()), formattingInfo);
+            break;
+        case Instruction::LineNumber:
+            appendLineNumber(dest, loggingEvent.context(), formattingInfo);
+            break;
+        case Instruction::Location:
+            appendLocation(dest, loggingEvent.context(), formattingInfo);
+            break;
+        case Instruction::Converter:
+        {
+            QString converted;
+            instruction.converter->format(converted, loggingEvent);
+            appendUtf8(dest, converted);
+            break;
+        }
+        default:
+            Q_ASSERT_X(false, "PatternFormatter::formatTo()", "Unknown instruction");
+        }
+    }
+}
+
+QString PatternFormatter::dateFormat(const QString &option)
+{
+    if (option.isEmpty())
+        return u"ISO8601"_s;
+    if (option == QLatin1String("locale:long"))
+        return QLocale().dateTimeFormat(QLocale::LongFormat);
+    if (option == QLatin1String("locale:short") || option == QLatin1String("locale"))
+        return QLocale().dateTimeFormat(QLocale::ShortFormat);
+    if (option == QLatin1String("locale:narrow"))
+        return QLocale().dateTimeFormat(QLocale::NarrowFormat);
+    return option;
+}
+
+void PatternFormatter::appendFormatted(QByteArray &dest, QStringView string, const FormattingInfo &formattingInfo)
+{
+    if (string.size() > formattingInfo.mMaxLength)
+        string = string.last(formattingInfo.mMaxLength);
+    const qsizetype padding = formattingInfo.mMinLength - string.size();
+    if (padding > 0 && !formattingInfo.mLeftAligned)
+        dest.append(padding, ' ');
+    appendUtf8(dest, string);
+    if (padding > 0 && formattingInfo.mLeftAligned)
+        dest.append(padding, ' ');
+}
+
+void PatternFormatter::appendFormatted(QByteArray &dest, QByteArrayView utf8, const FormattingInfo &formattingInfo)
+{
+    if (isPlain(formattingInfo))
+    {
+        dest.append(utf8);
+        return;
+    }
+    const qsizetype length = utf16Length(utf8);
+    if (length > formattingInfo.mMaxLength)
+    {
+        appendFormatted(dest, QString::fromUtf8(utf8), formattingInfo);
+        return;
+    }
+    const qsizetype padding = formattingInfo.mMinLength - length;
+    if (padding > 0 && !formattingInfo.mLeftAligned)
+        dest.append(padding, ' ');
+    dest.append(utf8);
+    if (padding > 0 && formattingInfo.mLeftAligned)
+        dest.append(padding, ' ');
+}
+
+QByteArrayView PatternFormatter::levelName(Level level)
+{
+    switch (level.toInt())
+    {
+    case Level::ALL_INT:    return "ALL";
+    case Level::TRACE_INT:  return "TRACE";
+    case Level::DEBUG_INT:  return "DEBUG";
+    case Level::INFO_INT:   return "INFO";
+    case Level::WARN_INT:   return "WARN";
+    case Level::ERROR_INT:  return "ERROR";
+    case Level::FATAL_INT:  return "FATAL";
+    case Level::OFF_INT:    return "OFF";
+    default:                return "NULL";
+    }
+}
+
+void PatternFormatter::appendLoggerName(QByteArray &dest, const LoggingEvent &loggingEvent, int precision,
+                                        const FormattingInfo &formattingInfo)
+{
+    const Logger *eventLogger = loggingEvent.logger();
+    if (!eventLogger)
+    {
+        appendFormatted(dest, QByteArrayView(), formattingInfo);
+        return;
+    }
+    Logger *qtLogger = LogManager::instance()->qtLogger();
+    if (eventLogger == qtLogger)
+    {
+        // The Qt logger is named after the category of the message
+        QString name = loggingEvent.categoryName();
+        if (name.isEmpty())
+            name = qtLogger->name();
+        const QStringView view(name);
+        appendFormatted(dest, view.sliced(sectionStart(view, precision)), formattingInfo);
+        return;
+    }
+    appendFormatted(dest, eventLogger->abbreviatedNameUtf8(precision), formattingInfo);
+}
+
+// Events of l4q* statements carry their location pre-encoded by the call site
+QByteArrayView PatternFormatter::fileName(const MessageContext &context)
+{
+    return context.callSite ? context.callSite->fileUtf8() : QByteArrayView(context.file);
+}
+
+QByteArrayView PatternFormatter::functionName(const MessageContext &context)
+{
+    return context.callSite ? context.callSite->functionUtf8() : QByteArrayView(context.function);
+}
+
+void PatternFormatter::appendLineNumber(QByteArray &dest, const MessageContext &context,
+                                        const FormattingInfo &formattingInfo)
+{
+    if (context.callSite)
+        appendFormatted(dest, context.callSite->lineUtf8(), formattingInfo);
+    else if (isPlain(formattingInfo))
+        appendNumber(dest, context.line);
+    else
+        appendFormatted(dest, QByteArray::number(context.line), formattingInfo);
+}
+
+void PatternFormatter::appendLocation(QByteArray &dest, const MessageContext &context,
+                                      const FormattingInfo &formattingInfo)
+{
+    if (context.callSite)
+    {
+        appendFormatted(dest, context.callSite->locationUtf8(), formattingInfo);
+        return;
+    }
+    if (isPlain(formattingInfo))
+    {
+        dest.append(QByteArrayView(context.file));
+        dest.append(':');
+        appendNumber(dest, context.line);
+        dest.append(" - ");
+        dest.append(QByteArrayView(context.function));
+        return;
+    }
+    QByteArray location;
+    location.append(QByteArrayView(context.file)).append(':');
+    appendNumber(location, context.line);
+    location.append(" - ").append(QByteArrayView(context.function));
+    appendFormatted(dest, location, formattingInfo);
+}
+
 bool PatternFormatter::requiresLocation() const
 {
     return mRequiresLocation;
@@ -368,50 +648,54 @@ void PatternFormatter::createConverter(QChar character,
       << option;
     logger()->trace(e);
 
+    Instruction instruction{.op = Instruction::Converter, .formattingInfo = formattingInfo};
     switch (character.toLatin1())
     {
     case 'c':
+        instruction.op = Instruction::LoggerName;
+        instruction.precision = parseIntegerOption(option);
         mPatternConverters.push_back(std::make_unique<LoggepatternConverter>(formattingInfo,
-                           parseIntegerOption(option)));
+                           instruction.precision));
         break;
     case 'd':
-    {
-        QString format = option;
-        if (option.isEmpty())
-            format = u"ISO8601"_s;
-        else if (option == QLatin1String("locale:long"))
-            format = QLocale().dateTimeFormat(QLocale::LongFormat);
-        else if (option == QLatin1String("locale:short"))
-            format = QLocale().dateTimeFormat(QLocale::ShortFormat);
-        else if (option == QLatin1String("locale:narrow"))
-            format = QLocale().dateTimeFormat(QLocale::NarrowFormat);
-        else if (option == QLatin1String("locale"))
-            format = QLocale().dateTimeFormat(QLocale::ShortFormat);
+        instruction.op = Instruction::Date;
+        instruction.dateFormatter = std::make_shared<const DateTimeFormatter>(dateFormat(option));
         mPatternConverters.push_back(std::make_unique<DatePatternConverter>(formattingInfo,
-                                                       format));
+                                                       instruction.dateFormatter));
         break;
-    }
     case 'm':
+        instruction.op = Instruction::Message;
         mPatternConverters.push_back(std::make_unique<BasicPatternConverter>(formattingInfo,
                                                         BasicPatternConverter::MessageConverter));
         break;
     case 'p':
+        instruction.op = Instruction::LevelName;
         mPatternConverters.push_back(std::make_unique<BasicPatternConverter>(formattingInfo,
                                                         BasicPatternConverter::LevelConverter));
         break;
     case 'r':
+        instruction.op = Instruction::Date;
+        instruction.dateFormatter = std::make_shared<const DateTimeFormatter>(u"RELATIVE"_s);
         mPatternConverters.push_back(std::make_unique<DatePatternConverter>(formattingInfo,
-                                                       u"RELATIVE"_s));
+                                                       instruction.dateFormatter));
         break;
     case 't':
+        instruction.op = Instruction::Thread;
         mPatternConverters.push_back(std::make_unique<BasicPatternConverter>(formattingInfo,
                                                         BasicPatternConverter::ThreadConverter));
         break;
     case 'x':
+        instruction.op = Instruction::Ndc;
         mPatternConverters.push_back(std::make_unique<BasicPatternConverter>(formattingInfo,
                                                         BasicPatternConverter::NdcConverter));
         break;
     case 'X':
+        // A bare %X renders the whole MDC; that stays with the converter
+        if (!option.isEmpty())
+        {
+            instruction.op = Instruction::Mdc;
+            instruction.option = option;
+        }
         mPatternConverters.push_back(std::make_unique<MDCPatternConverter>(formattingInfo,
                                                       option));
         break;
@@ -423,28 +707,35 @@ void PatternFormatter::createConverter(QChar character,
                 formattingInfo, option.toLatin1(), &mPropertySource));
         break;
     case 'F':
+        instruction.op = Instruction::Filename;
         mPatternConverters.push_back(std::make_unique<BasicPatternConverter>(formattingInfo,
                                                         BasicPatternConverter::FilenameConverter));
         mRequiresLocation = true;
         break;
     case 'M':
+        instruction.op = Instruction::FunctionName;
         mPatternConverters.push_back(std::make_unique<BasicPatternConverter>(formattingInfo,
                                                         BasicPatternConverter::FunctionNameConverter));
         mRequiresLocation = true;
         break;
     case 'L':
+        instruction.op = Instruction::LineNumber;
         mPatternConverters.push_back(std::make_unique<BasicPatternConverter>(formattingInfo,
                                                         BasicPatternConverter::LineNumberConverter));
         mRequiresLocation = true;
         break;
     case 'l':
+        instruction.op = Instruction::Location;
         mPatternConverters.push_back(std::make_unique<BasicPatternConverter>(formattingInfo,
                                                         BasicPatternConverter::LocationConverter));
         mRequiresLocation = true;
         break;
     default:
         Q_ASSERT_X(false, "PatternFormatter::createConverter", "Unknown pattern character");
+        return;
     }
+    instruction.converter = mPatternConverters.back().get();
+    mInstructions.push_back(std::move(instruction));
 }
 
 
@@ -453,6 +744,7 @@ void PatternFormatter::createLiteralConverter(const QString &literal)
     logger()->trace(u"Creating literal LiteralConverter with Literal '%1'"_s,
                     literal);
     mPatternConverters.push_back(std::make_unique<LiteralPatternConverter>(literal));
+    mInstructions.push_back({.op = Instruction::Literal, .literal = literal.toUtf8()});
 }
 
 
@@ -665,14 +957,6 @@ int PatternFormatter::parseIntegerOption(QStringView option)
     return result;
 }
 
-void FormattingInfo::clear()
-{
-    mMinLength = 0;
-    mMaxLength = INT_MAX;
-    mLeftAligned = false;
-}
-
-
 QString FormattingInfo::intToString(int i)
 {
     if (i == INT_MAX)
@@ -726,8 +1010,14 @@ void BasicPatternConverter::convert(QString &format, const LoggingEvent &logging
             format.append(loggingEvent.context().file);
         break;
     case LineNumberConverter:
-        format.append(QString::number(loggingEvent.context().line));
+    {
+        const auto &ctx = loggingEvent.context();
+        if (ctx.callSite)
+            format.append(QLatin1String(ctx.callSite->lineUtf8()));
+        else
+            format.append(QString::number(ctx.line));
         break;
+    }
     case FunctionNameConverter:
         if (loggingEvent.context().function)
             format.append(loggingEvent.context().function);
@@ -735,13 +1025,18 @@ void BasicPatternConverter::convert(QString &format, const LoggingEvent &logging
     case LocationConverter:
     {
         const auto &ctx = loggingEvent.context();
+        if (ctx.callSite)
+        {
+            format += QString::fromUtf8(ctx.callSite->locationUtf8());
+            break;
+        }
         // QStringBuilder avoids the per-event arg()-parser and produces a
-        // single allocation; QLatin1String wraps the stable __FILE__ /
-        // Q_FUNC_INFO C-strings without a UTF-8 conversion pass.
-        format += QLatin1String(ctx.file ? ctx.file : "")
+        // single allocation. The C-strings concatenate as UTF-8, the same
+        // decoding %F, %M and the byte path of formatTo() use.
+        format += (ctx.file ? ctx.file : "")
                   % QLatin1Char(':') % QString::number(ctx.line)
                   % QLatin1String(" - ")
-                  % QLatin1String(ctx.function ? ctx.function : "");
+                  % (ctx.function ? ctx.function : "");
         break;
     }
     case CategoryNameConverter:
@@ -754,7 +1049,7 @@ void BasicPatternConverter::convert(QString &format, const LoggingEvent &logging
 
 void DatePatternConverter::convert(QString &format, const LoggingEvent &loggingEvent) const
 {
-    format.append(DateTime::formatMsecs(loggingEvent.timeStamp(), mFormat));
+    format.append(mFormatter->format(loggingEvent.timeStamp()));
 }
 
 void LiteralPatternConverter::convert(QString &format, [[maybe_unused]] const LoggingEvent &loggingEvent) const
@@ -764,38 +1059,23 @@ void LiteralPatternConverter::convert(QString &format, [[maybe_unused]] const Lo
 
 void LoggepatternConverter::convert(QString &format, const LoggingEvent &loggingEvent) const
 {
-    if (!loggingEvent.logger())
+    const Logger *eventLogger = loggingEvent.logger();
+    if (!eventLogger)
         return;
-    QString name;
-
-    if (loggingEvent.logger() == LogManager::instance()->qtLogger())   // is qt logger
-        if (loggingEvent.categoryName().isEmpty())
-            name = LogManager::instance()->qtLogger()->name();
-        else
-            name = loggingEvent.categoryName();
-    else
-        name = loggingEvent.logger()->name();
 
-    if (mPrecision <= 0 || (name.isEmpty()))
+    Logger *qtLogger = LogManager::instance()->qtLogger();
+    if (eventLogger != qtLogger)
     {
-        format.append(name);
+        format.append(eventLogger->abbreviatedName(mPrecision));
         return;
     }
 
-    const QString separator(u"::"_s);
-
-    int i = mPrecision;
-    int begin = name.size();
-    while ((i > 0) && (begin >= 0))
-    {
-        begin = name.lastIndexOf(separator, begin - name.size() - 1);
-        i--;
-    }
-    if (begin < 0)
-        begin = 0;
-    else
-        begin += 2;
-    format.append(name.mid(begin));
+    // The Qt logger is named after the category of the message
+    QString name = loggingEvent.categoryName();
+    if (name.isEmpty())
+        name = qtLogger->name();
+    const QStringView view(name);
+    format.append(view.sliced(sectionStart(view, mPrecision)));
 }
 
 void MDCPatternConverter::convert(QString &format, const LoggingEvent &loggingEvent) const
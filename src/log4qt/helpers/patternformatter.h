@@ -22,10 +22,15 @@
 #define LOG4QT_PATTERNFORMATTER_H
 
 #include "log4qt/log4qtshared.h"
+#include "log4qt/level.h"
 
+#include <QByteArray>
+#include <QByteArrayView>
 #include <QList>
 #include <QString>
+#include <QStringView>
 
+#include <climits>
 #include <memory>
 #include <vector>
 
@@ -34,9 +39,38 @@ class QObject;
 namespace Log4Qt
 {
 
-class FormattingInfo;
 class PatternConverter;
 class LoggingEvent;
+class MessageContext;
+
+/*!
+ * \brief The class FormattingInfo stores the formatting modifier for a
+ * pattern converter.
+ *
+ * \sa PatternConverter
+ */
+class LOG4QT_EXPORT FormattingInfo
+{
+public:
+    constexpr FormattingInfo() = default;
+    constexpr FormattingInfo(int minLength, int maxLength, bool leftAligned) :
+        mMinLength(minLength),
+        mMaxLength(maxLength),
+        mLeftAligned(leftAligned)
+    {}
+
+    constexpr void clear()
+    {
+        *this = FormattingInfo();
+    }
+
+    static QString intToString(int i);
+
+public:
+    int mMinLength = 0;
+    int mMaxLength = INT_MAX;
+    bool mLeftAligned = false;
+};
 
 /*!
  * \brief The class PatternFormatter formats a logging event based on a
@@ -50,6 +84,9 @@ class LoggingEvent;
  * the information found a chain of PatternConverter is created. Each
  * PatternConverter handles a certain member of a LoggingEvent.
  *
+ * Alongside the converter chain the pattern is compiled into a flat list of
+ * instructions that formatTo() runs to write UTF-8 directly.
+ *
  * \sa PatternLayout::format()
  * \sa TTCCLayout::format()
  */
@@ -77,6 +114,17 @@ public:
      */
     QString format(const LoggingEvent &loggingEvent) const;
 
+    /*!
+     * Formats the given \a loggingEvent like format() and appends the
+     * result, encoded as UTF-8, to \a dest.
+     *
+     * Literals and level names are encoded when the pattern is parsed and
+     * logger names come encoded from Logger::nameUtf8(). All other values
+     * are encoded straight into \a dest, and padding and truncation are
+     * applied there, so no intermediate QString is built for the event.
+     */
+    void formatTo(const LoggingEvent &loggingEvent, QByteArray &dest) const;
+
     /*!
      * Returns true if the pattern contains at least one location-sensitive
      * conversion character (\c %F, \c %L, \c %M, \c %l).
@@ -106,6 +154,64 @@ public:
      */
     void setPropertySource(const QObject *source);
 
+    // The functions below write single conversions for formatTo(). They are
+    // public for StaticPatternLayout, which calls them from the code it
+    // generates for its pattern.
+
+    /*!
+     * Returns the date format of a \c %d conversion with the option
+     * \a option: "ISO8601" for none, the QLocale formats for "locale",
+     * "locale:long", "locale:short" and "locale:narrow", else \a option.
+     */
+    static QString dateFormat(const QString &option);
+
+    /*!
+     * Appends \a utf8 to \a dest, padded and truncated as specified by
+     * \a formattingInfo. Lengths are counted in UTF-16 code units, as in
+     * format().
+     */
+    static void appendFormatted(QByteArray &dest, QByteArrayView utf8, const FormattingInfo &formattingInfo);
+
+    /*!
+     * Appends \a string encoded as UTF-8 to \a dest, padded and truncated as
+     * specified by \a formattingInfo.
+     */
+    static void appendFormatted(QByteArray &dest, QStringView string, const FormattingInfo &formattingInfo);
+
+    /*!
+     * Returns the name of \a level as written by \c %p.
+     */
+    static QByteArrayView levelName(Level level);
+
+    /*!
+     * Appends the logger name of \a loggingEvent as written by
+     * \c %c{precision}.
+     */
+    static void appendLoggerName(QByteArray &dest, const LoggingEvent &loggingEvent, int precision,
+                                 const FormattingInfo &formattingInfo);
+
+    /*!
+     * Returns the file name of \a context as written by \c %F.
+     */
+    static QByteArrayView fileName(const MessageContext &context);
+
+    /*!
+     * Returns the function name of \a context as written by \c %M.
+     */
+    static QByteArrayView functionName(const MessageContext &context);
+
+    /*!
+     * Appends the line number of \a context as written by \c %L.
+     */
+    static void appendLineNumber(QByteArray &dest, const MessageContext &context,
+                                 const FormattingInfo &formattingInfo);
+
+    /*!
+     * Appends the location of \a context as written by \c %l.
+     */
+    static void appendLocation(QByteArray &dest, const MessageContext &context,
+                               const FormattingInfo &formattingInfo);
+
 private:
     bool addDigit(QChar digit,
                   int &value) const;
@@ -120,6 +226,8 @@ private:
 
     int parseIntegerOption(QStringView option);
 
+    struct Instruction;
+
 private:
     const QString mIgnoreCharacters;
     const QString mConversionCharacters;
@@ -127,6 +235,7 @@ private:
     QString mPattern;
     const QObject *mPropertySource = nullptr;
     std::vector<std::unique_ptr<PatternConverter>> mPatternConverters;
+    std::vector<Instruction> mInstructions;
     bool mRequiresLocation = false;
 };
 
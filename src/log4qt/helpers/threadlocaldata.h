@@ -0,0 +1,79 @@
+/******************************************************************************
+ *
+ * This file is part of Log4Qt library.
+ *
+ * Copyright (C) 2007 - 2026 Log4Qt contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+#ifndef LOG4QT_HELPERS_THREADLOCALDATA_H
+#define LOG4QT_HELPERS_THREADLOCALDATA_H
+
+#include <QtGlobal>
+
+#include <utility>
+
+namespace Log4Qt
+{
+
+/*!
+ * \brief A per-thread T that stays usable while the thread exits.
+ *
+ * A thread_local T registers a TLS destructor, and logging from another
+ * thread_local or QThreadStorage destructor at thread exit may then reach
+ * the destroyed T. Here the thread only holds a trivially destructible
+ * pointer, like the appender stack of AppenderSkeleton. The T is created on
+ * first use and deleted at thread exit by a cleanup hook that also resets
+ * the pointer. A T needed after that hook ran is created again and not
+ * deleted; only logging during thread teardown gets there.
+ *
+ * \tparam Tag Keeps the data of different owners of the same T apart.
+ * \tparam T The per-thread data, default constructible.
+ */
+template<typename Tag, typename T>
+class ThreadLocalData
+{
+public:
+    [[nodiscard]] static T &get()
+    {
+        if (Q_UNLIKELY(!tData))
+        {
+            tData = new T;
+            if (!tReleased)
+            {
+                static thread_local Cleanup cleanup;
+                Q_UNUSED(cleanup)
+            }
+        }
+        return *tData;
+    }
+
+private:
+    struct Cleanup
+    {
+        ~Cleanup()
+        {
+            tReleased = true;
+            delete std::exchange(tData, nullptr);
+        }
+    };
+
+    static inline thread_local T *tData = nullptr;
+    static inline thread_local bool tReleased = false;
+};
+
+} // namespace Log4Qt
+
+#endif // LOG4QT_HELPERS_THREADLOCALDATA_H
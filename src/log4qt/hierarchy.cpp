@@ -36,7 +36,7 @@ LOG4QT_DECLARE_STATIC_LOGGER(static_logger, ::LoggerRepository)
 Hierarchy::Hierarchy()
     : mObjectGuard(QReadWriteLock::Recursive)
     , mThreshold(Level::NULL_INT)
-    , mRootLogger(createLogger(QString()))
+    , mRootLogger(registerLogger(QString()))
 {}
 
 Hierarchy::~Hierarchy()
@@ -44,6 +44,8 @@ Hierarchy::~Hierarchy()
     static_logger()->warn(u"Unexpected destruction of Hierarchy"_s);
 
     QWriteLocker locker(&mObjectGuard);
+    mLookup.store(nullptr);
+    mLookupNames.clear();
     // Hierarchy is a friend of Logger, so we can reach the protected destructor.
     for (Logger *logger : std::as_const(mLoggers))
         delete logger;
@@ -60,7 +62,15 @@ bool Hierarchy::exists(const QString &name) const
 
 Logger *Hierarchy::logger(const QString &name)
 {
-    // A single write lock is used deliberately instead of a read-lock
+    // Loggers are only destroyed with the Hierarchy, so a pointer found in a
+    // snapshot stays valid after the snapshot has been replaced.
+    if (const auto lookup = mLookup.load())
+    {
+        if (Logger *logger = lookup->value(name, nullptr))
+            return logger;
+    }
+
+    // Creation path. A single write lock is used deliberately instead of a read-lock
     // fast-path followed by a write-lock on miss. mObjectGuard is a
     // *recursive* QReadWriteLock, and logger() is called re-entrantly while
     // the write lock is already held: resetConfiguration() holds the write
@@ -69,10 +79,20 @@ Logger *Hierarchy::logger(const QString &name)
     // Qt's recursive QReadWriteLock only recognizes recursion within the same
     // lock mode — acquiring a read lock while the thread holds the write lock
     // deadlocks. A recursive write-acquire is safe, so we take the write lock
-    // directly. Logger lookups are cached at every call site (see the
-    // LOG4QT_DECLARE_*_LOGGER macros), so this is not a hot path.
+    // directly.
     QWriteLocker writeLocker(&mObjectGuard);
-    return createLogger(name);
+
+    // Creating a logger does not republish the snapshot: copying it for
+    // every new logger would make startup quadratic in the number of
+    // loggers. A miss for a name registered since publishes instead, so the
+    // loggers created in a row cost one copy, made when one of them is
+    // looked up again.
+    if (Logger *logger = mLookupNames.value(name, nullptr))
+    {
+        mLookup.store(std::make_shared<const QHash<QString, Logger *>>(mLookupNames));
+        return logger;
+    }
+    return registerLogger(name);
 }
 
 QList<Logger *> Hierarchy::loggers() const
@@ -96,8 +116,8 @@ void Hierarchy::resetConfiguration()
 
     {
         QWriteLocker locker(&mObjectGuard);
-        p_logging_logger = createLogger(u""_s);
-        p_qt_logger = createLogger(u"Qt"_s);
+        p_logging_logger = registerLogger(u""_s);
+        p_qt_logger = registerLogger(u"Qt"_s);
         p_root_logger = mRootLogger;
         loggers = mLoggers.values();
     }
@@ -132,6 +152,10 @@ void Hierarchy::resetConfiguration()
     resetLogger(p_qt_logger, Level::NULL_INT);
     resetLogger(p_logging_logger, Level::NULL_INT);
     resetLogger(p_root_logger, Level::DEBUG_INT);
+
+    // setLevel() only bumps the generation for loggers whose level changed;
+    // bump once more so the reset is never missed by a cached effective level.
+    bumpLevelGeneration();
 }
 
 void Hierarchy::shutdown()
@@ -154,6 +178,7 @@ Logger *Hierarchy::createLogger(const QString &orgName)
     {
         logger = new Logger(this, Level::DEBUG_INT, u"root"_s, nullptr);
         mLoggers.insert(QString(), logger);
+        mLookupNames.insert(QString(), logger);
         return logger;
     }
     QString parent_name;
@@ -163,6 +188,19 @@ Logger *Hierarchy::createLogger(const QString &orgName)
 
     logger = new Logger(this, Level::NULL_INT, name, createLogger(parent_name));
     mLoggers.insert(name, logger);
+    mLookupNames.insert(name, logger);
+    return logger;
+}
+
+Logger *Hierarchy::registerLogger(const QString &name)
+{
+    // Called with the write lock held (or from the constructor).
+    Logger *logger = createLogger(name);
+
+    // Record the requested spelling next to the canonical names createLogger()
+    // added, so once published a later logger(name) is answered from the
+    // snapshot without converting the name again.
+    mLookupNames.insert(name, logger);
     return logger;
 }
 
@@ -22,6 +22,7 @@
 #define LOG4QT_HIERARCHY_H
 
 #include "loggerrepository.h"
+#include "helpers/atomicsharedptr.h"
 
 #include <QHash>
 #include <QReadWriteLock>
@@ -34,6 +35,13 @@ namespace Log4Qt
 /*!
  * \brief The class Hierarchy implements a logger repository.
  *
+ * Looking up a logger that already exists takes no lock: logger() first
+ * consults an immutable name to logger snapshot. The snapshot is keyed by
+ * the names callers actually pass, so a hit also skips the Java to C++ name
+ * conversion. Creating a logger takes the repository write lock but does
+ * not republish the snapshot; the first lookup that misses it for a logger
+ * created since does, once for all loggers created meanwhile.
+ *
  * \note All the functions declared in this class are thread-safe.
  */
 class LOG4QT_EXPORT Hierarchy : public LoggerRepository
@@ -57,11 +65,16 @@ public:
 
 private:
     Logger *createLogger(const QString &name);
+    Logger *registerLogger(const QString &name);
     void resetLogger(Logger *logger, Level level) const;
 
 private:
     mutable QReadWriteLock mObjectGuard;
     QHash<QString, Logger *> mLoggers;
+    // Guarded by mObjectGuard: mLoggers plus every name logger() was asked
+    // for, published through mLookup on a lookup miss for a known name.
+    QHash<QString, Logger *> mLookupNames;
+    AtomicSharedPtr<const QHash<QString, Logger *>> mLookup;
     std::atomic<Level> mThreshold;
     Logger *mRootLogger;
 };
@@ -23,14 +23,208 @@
 #include "loggingevent.h"
 #include "logger.h"
 
-#include <QJsonDocument>
-#include <QJsonObject>
+#include <QStringEncoder>
+#include <QVarLengthArray>
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <iterator>
 
 using namespace Qt::StringLiterals;
 
 namespace Log4Qt
 {
 
+namespace
+{
+
+enum Field
+{
+    TimestampField,
+    LevelField,
+    LoggerField,
+    ThreadField,
+    MessageField,
+    NdcField,
+    MdcField,
+    FileField,
+    LineField,
+    FunctionField,
+    FieldCount
+};
+
+// The pre-rendered structure of an object: everything but the values.
+// Indented output follows QJsonDocument::Indented.
+struct Fragments
+{
+    QByteArrayView open;
+    QByteArrayView separator;
+    QByteArrayView close;
+    QByteArrayView empty;
+    QByteArrayView keys[FieldCount];
+    // Nested MDC object
+    QByteArrayView mdcIndent;
+    QByteArrayView mdcKeySeparator;
+    QByteArrayView mdcClose;
+};
+
+constexpr Fragments compactFragments{
+    "{", ",", "}", "{}",
+    {"\"timestamp\":", "\"level\":", "\"logger\":", "\"thread\":", "\"message\":",
+     "\"ndc\":", "\"mdc\":", "\"file\":", "\"line\":", "\"function\":"},
+    "", ":", "}"
+};
+
+constexpr Fragments indentedFragments{
+    "{\n", ",\n", "\n}\n", "{\n}\n",
+    {"    \"timestamp\": ", "    \"level\": ", "    \"logger\": ", "    \"thread\": ",
+     "    \"message\": ", "    \"ndc\": ", "    \"mdc\": ", "    \"file\": ",
+     "    \"line\": ", "    \"function\": "},
+    "        ", ": ", "\n    }"
+};
+
+// AbstractLayout::endOfLine(), encoded once
+const QByteArray &endOfLineUtf8()
+{
+    static const QByteArray endOfLine = AbstractLayout::endOfLine().toUtf8();
+    return endOfLine;
+}
+
+// True if one of the four UTF-16 units in \a word is not printable ASCII or
+// needs escaping: >= 0x80, < 0x20, '"' or '\\'. Any lane that is zero in
+// word ^ pattern makes hasZero() true.
+bool needsAttention(quint64 word)
+{
+    constexpr quint64 ones = 0x0001000100010001ULL;
+    constexpr quint64 highs = 0x8000800080008000ULL;
+    const auto hasZero = [](quint64 v) { return ((v - ones) & ~v & highs) != 0; };
+    return (word & 0xFF80FF80FF80FF80ULL) != 0
+           || ((word - 0x20 * ones) & ~word & highs) != 0
+           || hasZero(word ^ (0x22 * ones))
+           || hasZero(word ^ (0x5C * ones));
+}
+
+bool isPlainAscii(char16_t c)
+{
+    return c >= 0x20 && c < 0x80 && c != u'"' && c != u'\\';
+}
+
+// Returns the end of the run of printable ASCII starting at \a p, scanning
+// four code units per step
+const char16_t *plainAsciiEnd(const char16_t *p, const char16_t *end)
+{
+    while (end - p >= 4)
+    {
+        quint64 word;
+        std::memcpy(&word, p, sizeof(word));
+        if (needsAttention(word))
+            break;
+        p += 4;
+    }
+    while (p < end && isPlainAscii(*p))
+        ++p;
+    return p;
+}
+
+void appendEscape(QByteArray &dest, unsigned char c)
+{
+    switch (c)
+    {
+    case '"':  dest.append("\\\"", 2); break;
+    case '\\': dest.append("\\\\", 2); break;
+    case '\b': dest.append("\\b", 2); break;
+    case '\f': dest.append("\\f", 2); break;
+    case '\n': dest.append("\\n", 2); break;
+    case '\r': dest.append("\\r", 2); break;
+    case '\t': dest.append("\\t", 2); break;
+    default:
+    {
+        constexpr char hex[] = "0123456789abcdef";
+        const char escape[6] = {'\\', 'u', '0', '0', hex[c >> 4], hex[c & 0xF]};
+        dest.append(escape, 6);
+    }
+    }
+}
+
+// Appends \a string as a quoted JSON string in UTF-8
+void appendJsonString(QByteArray &dest, QStringView string)
+{
+    dest.append('"');
+    const char16_t *p = string.utf16();
+    const char16_t *const end = p + string.size();
+    while (p < end)
+    {
+        const char16_t *const run = p;
+        p = plainAsciiEnd(p, end);
+        if (p != run)
+        {
+            const qsizetype start = dest.size();
+            dest.resize(start + (p - run));
+            char *out = dest.data() + start;
+            for (const char16_t *in = run; in != p; ++in)
+                *out++ = static_cast<char>(*in);
+        }
+        if (p == end)
+            break;
+
+        if (*p < 0x80)
+        {
+            appendEscape(dest, static_cast<unsigned char>(*p++));
+            continue;
+        }
+
+        // Non-ASCII never needs escaping, encode the whole run at once
+        const char16_t *const wide = p;
+        while (p < end && *p >= 0x80)
+            ++p;
+        const QStringView text(wide, p);
+        QStringEncoder encoder(QStringEncoder::Utf8, QStringEncoder::Flag::Stateless);
+        const qsizetype start = dest.size();
+        dest.resize(start + encoder.requiredSpace(text.size()));
+        const char *out = encoder.appendToBuffer(dest.data() + start, text);
+        dest.truncate(out - dest.constData());
+    }
+    dest.append('"');
+}
+
+// Appends \a bytes as a quoted JSON string. UTF-8 input is copied as is,
+// Latin-1 input is converted.
+template<bool latin1>
+void appendJsonString(QByteArray &dest, QByteArrayView bytes)
+{
+    dest.append('"');
+    qsizetype plain = 0;
+    for (qsizetype i = 0; i < bytes.size(); ++i)
+    {
+        const auto c = static_cast<unsigned char>(bytes[i]);
+        const bool escape = c < 0x20 || c == '"' || c == '\\';
+        if (!escape && !(latin1 && c >= 0x80))
+            continue;
+        dest.append(bytes.sliced(plain, i - plain));
+        plain = i + 1;
+        if (escape)
+            appendEscape(dest, c);
+        else
+        {
+            dest.append(static_cast<char>(0xC0 | (c >> 6)));
+            dest.append(static_cast<char>(0x80 | (c & 0x3F)));
+        }
+    }
+    dest.append(bytes.sliced(plain));
+    dest.append('"');
+}
+
+template<typename Integer>
+void appendNumber(QByteArray &dest, Integer value)
+{
+    char digits[24];
+    const auto result = std::to_chars(std::begin(digits), std::end(digits), value);
+    dest.append(digits, result.ptr - digits);
+}
+
+} // namespace
+
 JsonLayout::JsonLayout(QObject *parent)
     : AbstractStringLayout(parent)
 {
@@ -48,33 +242,63 @@ bool JsonLayout::requiresLocation() const
 
 QString JsonLayout::format(const LoggingEvent &event)
 {
-    QJsonObject obj;
+    QByteArray utf8;
+    formatTo(event, utf8);
+    return QString::fromUtf8(utf8);
+}
+
+void JsonLayout::formatTo(const LoggingEvent &event, QByteArray &dest)
+{
+    const Fragments &fragments = mPrettyPrint ? indentedFragments : compactFragments;
+    const qsizetype start = dest.size();
+    bool first = true;
+    const auto key = [&](Field field) {
+        dest.append(first ? fragments.open : fragments.separator);
+        dest.append(fragments.keys[field]);
+        first = false;
+    };
 
     if (mIncludeTimestamp)
-        obj[u"timestamp"_s] = event.timeStamp();
+    {
+        key(TimestampField);
+        appendNumber(dest, event.timeStamp());
+    }
 
     if (mIncludeLevel)
-        obj[u"level"_s] = event.level().toString();
+    {
+        key(LevelField);
+        appendJsonString(dest, event.level().toString());
+    }
 
     if (mIncludeLogger)
     {
-        const QString loggerName = event.logger()
-                                   ? event.logger()->name()
-                                   : event.categoryName();
-        obj[u"logger"_s] = loggerName;
+        key(LoggerField);
+        if (const Logger *logger = event.logger())
+            appendJsonString<false>(dest, logger->nameUtf8());
+        else
+            appendJsonString(dest, event.categoryName());
     }
 
     if (mIncludeThread)
-        obj[u"thread"_s] = event.threadName();
+    {
+        key(ThreadField);
+        appendJsonString(dest, event.threadName());
+    }
 
     if (mIncludeMessage)
-        obj[u"message"_s] = event.message();
+    {
+        key(MessageField);
+        appendJsonString(dest, event.message());
+    }
 
     if (mIncludeNdc)
     {
         const QString ndc = event.ndc();
         if (!ndc.isEmpty())
-            obj[u"ndc"_s] = ndc;
+        {
+            key(NdcField);
+            appendJsonString(dest, ndc);
+        }
     }
 
     if (mIncludeMdc)
@@ -82,10 +306,26 @@ QString JsonLayout::format(const LoggingEvent &event)
         const QHash<QString, QString> mdc = event.mdc();
         if (!mdc.isEmpty())
         {
-            QJsonObject mdcObj;
+            key(MdcField);
+            // Sorted by key, like a bare %X, so the output does not depend
+            // on the hash order
+            QVarLengthArray<QHash<QString, QString>::const_iterator, 16> entries;
             for (auto it = mdc.cbegin(); it != mdc.cend(); ++it)
-                mdcObj[it.key()] = it.value();
-            obj[u"mdc"_s] = mdcObj;
+                entries.append(it);
+            std::sort(entries.begin(), entries.end(), [](const auto &a, const auto &b) {
+                return a.key() < b.key();
+            });
+            bool firstEntry = true;
+            for (const auto &it : std::as_const(entries))
+            {
+                dest.append(firstEntry ? fragments.open : fragments.separator);
+                dest.append(fragments.mdcIndent);
+                appendJsonString(dest, it.key());
+                dest.append(fragments.mdcKeySeparator);
+                appendJsonString(dest, it.value());
+                firstEntry = false;
+            }
+            dest.append(fragments.mdcClose);
         }
     }
 
@@ -93,15 +333,21 @@ QString JsonLayout::format(const LoggingEvent &event)
     {
         const MessageContext ctx = event.context();
         if (ctx.file)
-            obj[u"file"_s] = QString::fromLatin1(ctx.file);
-        obj[u"line"_s] = ctx.line;
+        {
+            key(FileField);
+            appendJsonString<true>(dest, QByteArrayView(ctx.file));
+        }
+        key(LineField);
+        appendNumber(dest, ctx.line);
         if (ctx.function)
-            obj[u"function"_s] = QString::fromLatin1(ctx.function);
+        {
+            key(FunctionField);
+            appendJsonString<true>(dest, QByteArrayView(ctx.function));
+        }
     }
 
-    const QJsonDocument doc(obj);
-    return doc.toJson(mPrettyPrint ? QJsonDocument::Indented : QJsonDocument::Compact)
-           + AbstractLayout::endOfLine();
+    dest.append(dest.size() == start ? fragments.empty : fragments.close);
+    dest.append(endOfLineUtf8());
 }
 
 } // namespace Log4Qt
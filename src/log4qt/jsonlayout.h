@@ -48,6 +48,13 @@ namespace Log4Qt
  * \c prettyPrint if human readability is required. A rolling appender will
  * then write one valid JSON array per file.
  *
+ * \par Writing
+ * The object is written directly as UTF-8 by formatTo(): the keys and the
+ * punctuation between them are pre-rendered for compact and indented
+ * output, strings go through an escaper that copies runs of printable ASCII
+ * in one step. Fields appear in the order of the properties below; MDC
+ * entries in no particular order.
+ *
  * \par Timestamp
  * The \c "timestamp" field contains the Unix epoch in milliseconds
  * (a JSON number). This is intentionally a raw number rather than a
@@ -151,6 +158,12 @@ public:
 
     [[nodiscard]] QString format(const LoggingEvent &event) override;
 
+    /*!
+     * Writes the event as UTF-8 JSON, without building the QString that
+     * format() returns.
+     */
+    void formatTo(const LoggingEvent &event, QByteArray &dest) override;
+
     /*!
      * Returns \c true when \c includeLocation is \c true.
      */
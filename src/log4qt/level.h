@@ -27,6 +27,33 @@
 #include <QStringView>
 #include <QMetaType>
 
+/*!
+ * Numeric values of the levels for use in preprocessor conditions. They
+ * equal the values of Log4Qt::Level::Value.
+ */
+#define LOG4QT_LEVEL_ALL 32
+#define LOG4QT_LEVEL_TRACE 64
+#define LOG4QT_LEVEL_DEBUG 96
+#define LOG4QT_LEVEL_INFO 128
+#define LOG4QT_LEVEL_WARN 150
+#define LOG4QT_LEVEL_ERROR 182
+#define LOG4QT_LEVEL_FATAL 214
+#define LOG4QT_LEVEL_OFF 255
+
+/*!
+ * LOG4QT_COMPILE_TIME_MIN_LEVEL removes logging statements below the given
+ * level at compile time, e.g. -DLOG4QT_COMPILE_TIME_MIN_LEVEL=LOG4QT_LEVEL_INFO.
+ * The stripped l4qTrace() ... l4qFatal() macros generate no code and do not
+ * evaluate their arguments; the variadic Logger templates return without
+ * formatting. The default LOG4QT_LEVEL_ALL keeps everything.
+ *
+ * The CMake cache variable of the same name sets it for the log4qt target
+ * and everything linking against it.
+ */
+#ifndef LOG4QT_COMPILE_TIME_MIN_LEVEL
+#define LOG4QT_COMPILE_TIME_MIN_LEVEL LOG4QT_LEVEL_ALL
+#endif
+
 namespace Log4Qt
 {
 
@@ -110,6 +137,23 @@ LOG4QT_EXPORT QDataStream &operator>>(QDataStream &in,
                         Level &level);
 #endif // QT_NO_DATASTREAM
 
+static_assert(Level::TRACE_INT == LOG4QT_LEVEL_TRACE && Level::DEBUG_INT == LOG4QT_LEVEL_DEBUG
+              && Level::INFO_INT == LOG4QT_LEVEL_INFO && Level::WARN_INT == LOG4QT_LEVEL_WARN
+              && Level::ERROR_INT == LOG4QT_LEVEL_ERROR && Level::FATAL_INT == LOG4QT_LEVEL_FATAL
+              && Level::ALL_INT == LOG4QT_LEVEL_ALL && Level::OFF_INT == LOG4QT_LEVEL_OFF,
+              "LOG4QT_LEVEL_* must match Level::Value");
+
+/*!
+ * \relates Level
+ *
+ * Returns true if statements at \a level are compiled in, see
+ * LOG4QT_COMPILE_TIME_MIN_LEVEL.
+ */
+[[nodiscard]] constexpr bool isCompiledIn(Level level) noexcept
+{
+    return level.toInt() >= LOG4QT_COMPILE_TIME_MIN_LEVEL;
+}
+
 } // namespace Log4Qt
 
 Q_DECLARE_METATYPE(Log4Qt::Level)
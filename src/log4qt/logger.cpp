@@ -36,10 +36,35 @@ using namespace Qt::StringLiterals;
 namespace Log4Qt
 {
 
+namespace
+{
+
+// The start of every section that follows a "::". Searched backwards, as
+// %c{n} always did, so that ":::" splits the same way.
+template<typename View, typename Separator>
+QList<qsizetype> sectionStarts(View name, Separator separator)
+{
+    QList<qsizetype> starts;
+    qsizetype begin = name.size();
+    while (begin > 0)
+    {
+        begin = name.lastIndexOf(separator, begin - 1);
+        if (begin < 0)
+            break;
+        starts.prepend(begin + 2);
+    }
+    return starts;
+}
+
+} // namespace
+
 Logger::Logger(LoggerRepository *loggerRepository, Level level,
                const QString &name, Logger *parent) :
     QObject(nullptr),
-    mName(name), mLoggerRepository(loggerRepository), mAdditivity(true),
+    mName(name), mNameUtf8(name.toUtf8()),
+    mSectionStarts(sectionStarts(QStringView(mName), u"::")),
+    mSectionStartsUtf8(sectionStarts(QByteArrayView(mNameUtf8), "::")),
+    mLoggerRepository(loggerRepository), mAdditivity(true),
     mLevel(level), mParentLogger(parent)
 {
     Q_ASSERT_X(loggerRepository, "Logger::Logger()",
@@ -63,44 +88,108 @@ void Logger::setLevel(Level level)
     }
     const Level previous = mLevel.exchange(level, std::memory_order_release);
     if (previous != level)
+    {
+        // After the store: a reader that sees the new generation also sees
+        // the new level, and a cache stamped with the old one is discarded.
+        mLoggerRepository->bumpLevelGeneration();
         Q_EMIT levelChanged(level);
+    }
 }
 
 // Note: use MainThreadAppender if you want write the log from non-main threads
 // within the main trhead
 void Logger::callAppenders(const LoggingEvent &event) const
 {
-    // Snapshot the appender list under the read lock, then release it before
-    // doing the (potentially slow) appender I/O. The shared-pointer copies keep
-    // the appenders alive even if one is removed concurrently, and not holding
-    // the lock across I/O (or across the ancestor chain) means a concurrent
-    // addAppender()/removeAppender() no longer blocks for the dispatch duration.
-    QList<AppenderSharedPtr> appenders;
+    // The plan holds shared pointers, so the appenders stay alive even if
+    // one is removed concurrently, and no lock is held across appender I/O.
+    const auto plan = dispatchPlan();
+    for (const auto &appender : plan->appenders)
+        appender->doAppend(event);
+}
+
+std::shared_ptr<const Logger::DispatchPlan> Logger::dispatchPlan() const
+{
+    // Read the generation before collecting: a plan built while appenders
+    // change is stamped with the outdated generation and rebuilt next time.
+    const quint64 generation = mLoggerRepository->dispatchGeneration();
+    auto plan = mDispatchPlan.load();
+    if (plan && plan->generation == generation)
+        return plan;
+
+    auto rebuilt = std::make_shared<DispatchPlan>();
+    rebuilt->generation = generation;
+    // additivity() is atomic and parentLogger() is fixed at construction, so
+    // only the appender lists need their locks.
+    for (const Logger *logger = this; logger != nullptr; logger = logger->parentLogger())
     {
-        QReadLocker locker(&mAppenderGuard);
-        appenders = mAppenders;
+        {
+            QReadLocker locker(&logger->mAppenderGuard);
+            for (const auto &appender : logger->mAppenders)
+            {
+                if (!rebuilt->appenders.contains(appender))
+                    rebuilt->appenders.append(appender);
+            }
+        }
+        if (!logger->additivity())
+            break;
     }
 
-    for (const auto &appender : std::as_const(appenders))
-        appender->doAppend(event);
+    plan = std::move(rebuilt);
+    mDispatchPlan.store(plan);
+    return plan;
+}
 
-    // additivity() is atomic and parentLogger() is fixed at construction, so
-    // neither needs the appender lock.
-    if (additivity() && (parentLogger() != nullptr))
-        parentLogger()->callAppenders(event);
+void Logger::invalidateDispatchPlan()
+{
+    // Drop this logger's plan right away so removed appenders are released;
+    // descendants rebuild theirs on their next event.
+    mDispatchPlan.store(nullptr);
+    mLoggerRepository->bumpDispatchGeneration();
+}
+
+void Logger::addAppender(const AppenderSharedPtr &appender)
+{
+    AppenderAttachable::addAppender(appender);
+    invalidateDispatchPlan();
+}
+
+void Logger::removeAllAppenders()
+{
+    AppenderAttachable::removeAllAppenders();
+    invalidateDispatchPlan();
+}
+
+void Logger::removeAppender(const AppenderSharedPtr &appender)
+{
+    AppenderAttachable::removeAppender(appender);
+    invalidateDispatchPlan();
 }
 
 Level Logger::effectiveLevel() const
 {
+    // Read the generation before walking the chain: if a level changes
+    // during the walk, the result is stamped with the outdated generation
+    // and resolved again on the next call.
+    const quint64 generation = mLoggerRepository->levelGeneration();
+    const quint64 cached = mEffectiveLevelCache.load(std::memory_order_relaxed);
+    if ((cached >> 8) == generation)
+        return Level(static_cast<Level::Value>(cached & 0xFF));
+
     Q_ASSERT_X(LogManager::rootLogger()->level() != Level::NULL_INT,
                "Logger::effectiveLevel()", "Root logger level must not be NULL_INT");
 
-    QReadLocker locker(&mAppenderGuard);
-
+    // No lock: parent loggers are fixed at construction and levels are atomic
     const Logger *logger = this;
-    while (logger->level() == Level::NULL_INT)
+    Level level = logger->level();
+    while (level == Level::NULL_INT)
+    {
         logger = logger->parentLogger();
-    return logger->level();
+        level = logger->level();
+    }
+
+    mEffectiveLevelCache.store((generation << 8) | static_cast<quint64>(level.toInt()),
+                               std::memory_order_relaxed);
+    return level;
 }
 
 bool Logger::isEnabledFor(Level level) const
@@ -131,11 +220,22 @@ void Logger::forcedLog(Level level, const QString &message) const
     forcedLog(event);
 }
 
+void Logger::forcedLog(Level level, const MessageContext &context, const QString &message) const
+{
+    LoggingEvent event(this, level, message, context, QString());
+    forcedLog(event);
+}
+
 void Logger::forcedLog(const LoggingEvent &logEvent) const
 {
     callAppenders(logEvent);
 }
 
+bool Logger::deferredFormatting()
+{
+    return LogManager::deferredFormatting();
+}
+
 bool Logger::additivity() const
 {
     return mAdditivity;
@@ -165,7 +265,10 @@ void Logger::setAdditivity(bool additivity)
 {
     const bool previous = mAdditivity.exchange(additivity, std::memory_order_release);
     if (previous != additivity)
+    {
+        mLoggerRepository->bumpDispatchGeneration();
         Q_EMIT additivityChanged(additivity);
+    }
 }
 
 // Level operations
@@ -298,14 +401,8 @@ void Logger::log(const LoggingEvent &logEvent) const
 
 void Logger::logWithLocation(Level level, const char *file, int line, const char *function, const QString &message) const
 {
-    if (!isEnabledFor(level))
-        return;
-    LoggingEvent loggingEvent = LoggingEvent(this,
-                                             level,
-                                             message,
-                                             MessageContext(file, line, function),
-                                             QString());
-    forcedLog(loggingEvent);
+    if (isEnabledFor(level))
+        forcedLog(level, MessageContext(file, line, function), message);
 }
 
 #ifdef __cpp_lib_source_location
@@ -369,11 +466,16 @@ void Logger::warn(const LogError &logError) const
 
 void MessageLogger::log(const QString &message) const
 {
-    mLogger->logWithLocation(mLevel, mContext.file, mContext.line, mContext.function, message);
+    if (mContext.callSite)
+        mLogger->forcedLog(mLevel, mContext, message);
+    else
+        mLogger->logWithLocation(mLevel, mContext.file, mContext.line, mContext.function, message);
 }
 
 LogStream MessageLogger::log() const
 {
+    if (mContext.callSite)
+        return LogStream(*mLogger.data(), *mContext.callSite);
     return LogStream(*mLogger.data(), mLevel);
 }
 
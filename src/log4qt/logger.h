@@ -26,6 +26,9 @@
 #include "helpers/logerror.h"
 #include "helpers/classlogger.h"
 #include "helpers/appenderattachable.h"
+#include "helpers/atomicsharedptr.h"
+#include "helpers/formatstring.h"
+#include "callsite.h"
 #include "level.h"
 #include "logstream.h"
 #include "loggingevent.h"
@@ -163,6 +166,9 @@ public:
     explicit MessageLogger(Logger *logger, Level level) : mLogger(logger), mLevel(level) {}
     explicit MessageLogger(Logger *logger, Level level, const char *file, int line, const char *function)
         : mLogger(logger), mLevel(level), mContext(file, line, function) {}
+    // For a statement that \a site has already let through
+    explicit MessageLogger(Logger *logger, const CallSite &site)
+        : mLogger(logger), mLevel(site.level()), mContext(site) {}
 #ifdef __cpp_lib_source_location
     explicit MessageLogger(Logger *logger, Level level, const std::source_location &loc)
         : mLogger(logger), mLevel(level), mContext(loc) {}
@@ -170,11 +176,11 @@ public:
 
     void log(const QString &message) const;
     template <typename ...Ts>
-    void log(const QString &message, Ts &&...ts) const
+    void log(const QString &message, Ts &&...ts) const;
+    template <FormatLiteral Format, typename ...Ts>
+    void log(FormatString<Format> format, const Ts &...ts) const
     {
-        auto msg = message;
-        ((msg = msg.arg(std::forward<Ts>(ts))), ...);
-        log(msg);
+        log(format(ts...));
     }
     LogStream log() const;
 
@@ -185,24 +191,58 @@ private:
 };
 
 // Macros to log with location information, the logger must have the name
-#define l4qFatal(...) \
-    for (Log4Qt::Logger *l4q_p_logger = logger(); l4q_p_logger && l4q_p_logger->isEnabledFor(Log4Qt::Level::FATAL_INT); l4q_p_logger = nullptr) \
-        Log4Qt::MessageLogger(l4q_p_logger, Log4Qt::Level::FATAL_INT, __FILE__, __LINE__, Q_FUNC_INFO).log(__VA_ARGS__)
-#define l4qError(...) \
-    for (Log4Qt::Logger *l4q_p_logger = logger(); l4q_p_logger && l4q_p_logger->isEnabledFor(Log4Qt::Level::ERROR_INT); l4q_p_logger = nullptr) \
-        Log4Qt::MessageLogger(l4q_p_logger, Log4Qt::Level::ERROR_INT, __FILE__, __LINE__, Q_FUNC_INFO).log(__VA_ARGS__)
-#define l4qWarn(...) \
-    for (Log4Qt::Logger *l4q_p_logger = logger(); l4q_p_logger && l4q_p_logger->isEnabledFor(Log4Qt::Level::WARN_INT); l4q_p_logger = nullptr) \
-        Log4Qt::MessageLogger(l4q_p_logger, Log4Qt::Level::WARN_INT, __FILE__, __LINE__, Q_FUNC_INFO).log(__VA_ARGS__)
-#define l4qInfo(...) \
-    for (Log4Qt::Logger *l4q_p_logger = logger(); l4q_p_logger && l4q_p_logger->isEnabledFor(Log4Qt::Level::INFO_INT); l4q_p_logger = nullptr) \
-        Log4Qt::MessageLogger(l4q_p_logger, Log4Qt::Level::INFO_INT, __FILE__, __LINE__, Q_FUNC_INFO).log(__VA_ARGS__)
-#define l4qDebug(...) \
-    for (Log4Qt::Logger *l4q_p_logger = logger(); l4q_p_logger && l4q_p_logger->isEnabledFor(Log4Qt::Level::DEBUG_INT); l4q_p_logger = nullptr) \
-        Log4Qt::MessageLogger(l4q_p_logger, Log4Qt::Level::DEBUG_INT, __FILE__, __LINE__, Q_FUNC_INFO).log(__VA_ARGS__)
-#define l4qTrace(...) \
-    for (Log4Qt::Logger *l4q_p_logger = logger(); l4q_p_logger && l4q_p_logger->isEnabledFor(Log4Qt::Level::TRACE_INT); l4q_p_logger = nullptr) \
-        Log4Qt::MessageLogger(l4q_p_logger, Log4Qt::Level::TRACE_INT, __FILE__, __LINE__, Q_FUNC_INFO).log(__VA_ARGS__)
+// logger(). Levels below LOG4QT_COMPILE_TIME_MIN_LEVEL use
+// LOG4QT_L4Q_STRIPPED, all others LOG4QT_L4Q_LOG.
+
+// Each statement owns a CallSite, which decides whether it logs and carries
+// its location; the inner loop ends once the logger pointer is cleared. The
+// site is never deleted, so queued events may outlive the statement's
+// library. A following else binds to the caller's if, as there is no if
+// here to take it.
+#define LOG4QT_L4Q_LOG(LEVEL, ...) \
+    for (Log4Qt::Logger *l4q_p_logger = logger(); l4q_p_logger; l4q_p_logger = nullptr) \
+        for (static Log4Qt::CallSite &l4q_site = \
+                 *new Log4Qt::CallSite(Log4Qt::Level::LEVEL, __FILE__, __LINE__, Q_FUNC_INFO); \
+             l4q_site.isEnabledFor(l4q_p_logger); l4q_p_logger = nullptr) \
+            Log4Qt::MessageLogger(l4q_p_logger, l4q_site).log(__VA_ARGS__)
+
+// A discarded else branch: the statement is still type checked, but
+// generates no code and neither the arguments nor a trailing "<< ..." are
+// evaluated. Its if already has an else, so a following else binds to the
+// caller's if.
+#define LOG4QT_L4Q_STRIPPED(LEVEL, ...) \
+    if constexpr (true) {} else LOG4QT_L4Q_LOG(LEVEL, __VA_ARGS__)
+
+#if LOG4QT_COMPILE_TIME_MIN_LEVEL > LOG4QT_LEVEL_FATAL
+#define l4qFatal(...) LOG4QT_L4Q_STRIPPED(FATAL_INT, __VA_ARGS__)
+#else
+#define l4qFatal(...) LOG4QT_L4Q_LOG(FATAL_INT, __VA_ARGS__)
+#endif
+#if LOG4QT_COMPILE_TIME_MIN_LEVEL > LOG4QT_LEVEL_ERROR
+#define l4qError(...) LOG4QT_L4Q_STRIPPED(ERROR_INT, __VA_ARGS__)
+#else
+#define l4qError(...) LOG4QT_L4Q_LOG(ERROR_INT, __VA_ARGS__)
+#endif
+#if LOG4QT_COMPILE_TIME_MIN_LEVEL > LOG4QT_LEVEL_WARN
+#define l4qWarn(...) LOG4QT_L4Q_STRIPPED(WARN_INT, __VA_ARGS__)
+#else
+#define l4qWarn(...) LOG4QT_L4Q_LOG(WARN_INT, __VA_ARGS__)
+#endif
+#if LOG4QT_COMPILE_TIME_MIN_LEVEL > LOG4QT_LEVEL_INFO
+#define l4qInfo(...) LOG4QT_L4Q_STRIPPED(INFO_INT, __VA_ARGS__)
+#else
+#define l4qInfo(...) LOG4QT_L4Q_LOG(INFO_INT, __VA_ARGS__)
+#endif
+#if LOG4QT_COMPILE_TIME_MIN_LEVEL > LOG4QT_LEVEL_DEBUG
+#define l4qDebug(...) LOG4QT_L4Q_STRIPPED(DEBUG_INT, __VA_ARGS__)
+#else
+#define l4qDebug(...) LOG4QT_L4Q_LOG(DEBUG_INT, __VA_ARGS__)
+#endif
+#if LOG4QT_COMPILE_TIME_MIN_LEVEL > LOG4QT_LEVEL_TRACE
+#define l4qTrace(...) LOG4QT_L4Q_STRIPPED(TRACE_INT, __VA_ARGS__)
+#else
+#define l4qTrace(...) LOG4QT_L4Q_LOG(TRACE_INT, __VA_ARGS__)
+#endif
 
 class Appender;
 class LoggerRepository;
@@ -279,11 +319,76 @@ public:
     [[nodiscard]] QString name() const;
     [[nodiscard]] Logger *parentLogger() const;
 
+    /*!
+     * Returns the name of the logger encoded as UTF-8. It is encoded once,
+     * when the logger is created, for layouts that write bytes.
+     *
+     * \sa AbstractStringLayout::formatTo()
+     */
+    [[nodiscard]] const QByteArray &nameUtf8() const { return mNameUtf8; }
+
+    /*!
+     * Returns a view of name(). The name never changes, so the view stays
+     * valid for the lifetime of the logger and no QString is copied.
+     *
+     * \sa abbreviatedName()
+     */
+    [[nodiscard]] QStringView nameView() const { return mName; }
+
+    /*!
+     * Returns the last \a precision "::" separated sections of the name, as
+     * the conversion \c %c{precision} of PatternLayout shows them. The whole
+     * name is returned if \a precision is 0 or less or exceeds the number of
+     * sections.
+     *
+     * The section boundaries are located once, when the logger is created,
+     * so the call only selects a view into name(); it stays valid for the
+     * lifetime of the logger.
+     *
+     * \sa abbreviatedNameUtf8()
+     */
+    [[nodiscard]] QStringView abbreviatedName(int precision) const
+    {
+        return QStringView(mName).sliced(sectionStart(mSectionStarts, precision));
+    }
+
+    /*!
+     * Returns abbreviatedName() as a view into nameUtf8().
+     */
+    [[nodiscard]] QByteArrayView abbreviatedNameUtf8(int precision) const
+    {
+        return QByteArrayView(mNameUtf8).sliced(sectionStart(mSectionStartsUtf8, precision));
+    }
+
     void setAdditivity(bool additivity);
     virtual void setLevel(Level level);
 
+    void addAppender(const AppenderSharedPtr &appender) override;
+    void removeAllAppenders() override;
+    void removeAppender(const AppenderSharedPtr &appender) override;
+    using AppenderAttachable::removeAppender;
+
+    /*!
+     * Passes \a event to every appender reachable from this logger: its own
+     * appenders and, while additivity holds, those of its ancestors. Each
+     * appender receives the event once, even if it is attached at several
+     * levels of the chain.
+     *
+     * The appenders are taken from an immutable dispatch plan that is built
+     * on first use and rebuilt only after appenders or additivity changed
+     * somewhere in the repository, so dispatching takes no lock.
+     *
+     * \sa LoggerRepository::dispatchGeneration()
+     */
     void callAppenders(const LoggingEvent &event) const;
 
+    /*!
+     * Returns the level of this logger, or of its nearest ancestor with a
+     * level set. The result is cached until a level anywhere in the
+     * repository changes, so repeated calls do not walk the hierarchy.
+     *
+     * \sa LoggerRepository::levelGeneration()
+     */
     [[nodiscard]] Level effectiveLevel() const;
     [[nodiscard]] bool isDebugEnabled() const;
 
@@ -313,12 +418,19 @@ public:
     template<typename ...Ts>
     void debug(const QString &message, Ts &&...ts) const
     {
-        if (isEnabledFor(Level::DEBUG_INT))
-        {
-            auto msg = message;
-            ((msg = msg.arg(std::forward<Ts>(ts))), ...);
-            forcedLog(Level::DEBUG_INT, msg);
-        }
+        if constexpr (!isCompiledIn(Level::DEBUG_INT))
+            return;
+        else if (isEnabledFor(Level::DEBUG_INT))
+            formatAndLog(Level::DEBUG_INT, message, std::forward<Ts>(ts)...);
+    }
+
+    template<FormatLiteral Format, typename ...Ts>
+    void debug(FormatString<Format> format, const Ts &...ts) const
+    {
+        if constexpr (!isCompiledIn(Level::DEBUG_INT))
+            return;
+        else if (isEnabledFor(Level::DEBUG_INT))
+            forcedLog(Level::DEBUG_INT, format(ts...));
     }
 
 
@@ -329,12 +441,19 @@ public:
     template<typename ...Ts>
     void error(const QString &message, Ts &&...ts) const
     {
-        if (isEnabledFor(Level::ERROR_INT))
-        {
-            auto msg = message;
-            ((msg = msg.arg(std::forward<Ts>(ts))), ...);
-            forcedLog(Level::ERROR_INT, msg);
-        }
+        if constexpr (!isCompiledIn(Level::ERROR_INT))
+            return;
+        else if (isEnabledFor(Level::ERROR_INT))
+            formatAndLog(Level::ERROR_INT, message, std::forward<Ts>(ts)...);
+    }
+
+    template<FormatLiteral Format, typename ...Ts>
+    void error(FormatString<Format> format, const Ts &...ts) const
+    {
+        if constexpr (!isCompiledIn(Level::ERROR_INT))
+            return;
+        else if (isEnabledFor(Level::ERROR_INT))
+            forcedLog(Level::ERROR_INT, format(ts...));
     }
 
     LogStream fatal() const;
@@ -344,12 +463,19 @@ public:
     template<typename ...Ts>
     void fatal(const QString &message, Ts &&...ts) const
     {
-        if (isEnabledFor(Level::FATAL_INT))
-        {
-            auto msg = message;
-            ((msg = msg.arg(std::forward<Ts>(ts))), ...);
-            forcedLog(Level::FATAL_INT, msg);
-        }
+        if constexpr (!isCompiledIn(Level::FATAL_INT))
+            return;
+        else if (isEnabledFor(Level::FATAL_INT))
+            formatAndLog(Level::FATAL_INT, message, std::forward<Ts>(ts)...);
+    }
+
+    template<FormatLiteral Format, typename ...Ts>
+    void fatal(FormatString<Format> format, const Ts &...ts) const
+    {
+        if constexpr (!isCompiledIn(Level::FATAL_INT))
+            return;
+        else if (isEnabledFor(Level::FATAL_INT))
+            forcedLog(Level::FATAL_INT, format(ts...));
     }
 
     LogStream info() const;
@@ -359,12 +485,19 @@ public:
     template<typename ...Ts>
     void info(const QString &message, Ts &&...ts) const
     {
-        if (isEnabledFor(Level::INFO_INT))
-        {
-            auto msg = message;
-            ((msg = msg.arg(std::forward<Ts>(ts))), ...);
-            forcedLog(Level::INFO_INT, msg);
-        }
+        if constexpr (!isCompiledIn(Level::INFO_INT))
+            return;
+        else if (isEnabledFor(Level::INFO_INT))
+            formatAndLog(Level::INFO_INT, message, std::forward<Ts>(ts)...);
+    }
+
+    template<FormatLiteral Format, typename ...Ts>
+    void info(FormatString<Format> format, const Ts &...ts) const
+    {
+        if constexpr (!isCompiledIn(Level::INFO_INT))
+            return;
+        else if (isEnabledFor(Level::INFO_INT))
+            forcedLog(Level::INFO_INT, format(ts...));
     }
 
     LogStream log(Level level) const;
@@ -375,22 +508,22 @@ public:
     template<typename ...Ts>
     void log(Level level, const QString &message, Ts &&...ts) const
     {
-        if (isEnabledFor(level))        {
-            auto msg = message;
-            ((msg = msg.arg(std::forward<Ts>(ts))), ...);
-            forcedLog(level, msg);
-        }
+        if (isEnabledFor(level))
+            formatAndLog(level, message, std::forward<Ts>(ts)...);
+    }
+    template<FormatLiteral Format, typename ...Ts>
+    void log(Level level, FormatString<Format> format, const Ts &...ts) const
+    {
+        if (isEnabledFor(level))
+            forcedLog(level, format(ts...));
     }
 
     void logWithLocation(Level level, const char *file, int line, const char *function, const QString &message) const;
     template<typename ...Ts>
     void logWithLocation(Level level, const char *file, int line, const char *function, const QString &message, Ts &&...ts) const
     {
-        if (isEnabledFor(level))        {
-            auto msg = message;
-            ((msg = msg.arg(std::forward<Ts>(ts))), ...);
-            logWithLocation(level, file, line, function, msg);
-        }
+        if (isEnabledFor(level))
+            formatAndLog(level, MessageContext(file, line, function), message, std::forward<Ts>(ts)...);
     }
 
 #ifdef __cpp_lib_source_location
@@ -404,12 +537,19 @@ public:
     template<typename ...Ts>
     void trace(const QString &message, Ts &&...ts) const
     {
-        if (isEnabledFor(Level::TRACE_INT))
-        {
-            auto msg = message;
-            ((msg = msg.arg(std::forward<Ts>(ts))), ...);
-            forcedLog(Level::TRACE_INT, msg);
-        }
+        if constexpr (!isCompiledIn(Level::TRACE_INT))
+            return;
+        else if (isEnabledFor(Level::TRACE_INT))
+            formatAndLog(Level::TRACE_INT, message, std::forward<Ts>(ts)...);
+    }
+
+    template<FormatLiteral Format, typename ...Ts>
+    void trace(FormatString<Format> format, const Ts &...ts) const
+    {
+        if constexpr (!isCompiledIn(Level::TRACE_INT))
+            return;
+        else if (isEnabledFor(Level::TRACE_INT))
+            forcedLog(Level::TRACE_INT, format(ts...));
     }
 
     LogStream warn() const;
@@ -419,12 +559,19 @@ public:
     template<typename ...Ts>
     void warn(const QString &message, Ts &&...ts) const
     {
-        if (isEnabledFor(Level::WARN_INT))
-        {
-            auto msg = message;
-            ((msg = msg.arg(std::forward<Ts>(ts))), ...);
-            forcedLog(Level::WARN_INT, msg);
-        }
+        if constexpr (!isCompiledIn(Level::WARN_INT))
+            return;
+        else if (isEnabledFor(Level::WARN_INT))
+            formatAndLog(Level::WARN_INT, message, std::forward<Ts>(ts)...);
+    }
+
+    template<FormatLiteral Format, typename ...Ts>
+    void warn(FormatString<Format> format, const Ts &...ts) const
+    {
+        if constexpr (!isCompiledIn(Level::WARN_INT))
+            return;
+        else if (isEnabledFor(Level::WARN_INT))
+            forcedLog(Level::WARN_INT, format(ts...));
     }
 
     // LogManager operations
@@ -438,19 +585,94 @@ Q_SIGNALS:
 
 protected:
     void forcedLog(Level level, const QString &message) const;
+    void forcedLog(Level level, const MessageContext &context, const QString &message) const;
     void forcedLog(const LoggingEvent &logEvent) const;
 
+    // Formats with QString::arg() and logs, or leaves the formatting to
+    // the first reader of the event if LogManager::deferredFormatting() is set
+    template<typename ...Ts>
+    void formatAndLog(Level level, const QString &message, Ts &&...ts) const
+    {
+        if (deferredFormatting())
+        {
+            LoggingEvent event(this, level, QString());
+            event.setDeferredMessage(message, std::forward<Ts>(ts)...);
+            forcedLog(event);
+            return;
+        }
+        auto msg = message;
+        ((msg = msg.arg(std::forward<Ts>(ts))), ...);
+        forcedLog(level, msg);
+    }
+
+    // As above, for an event with a location
+    template<typename ...Ts>
+    void formatAndLog(Level level, const MessageContext &context, const QString &message, Ts &&...ts) const
+    {
+        if (deferredFormatting())
+        {
+            LoggingEvent event(this, level, QString(), context, QString());
+            event.setDeferredMessage(message, std::forward<Ts>(ts)...);
+            forcedLog(event);
+            return;
+        }
+        auto msg = message;
+        ((msg = msg.arg(std::forward<Ts>(ts))), ...);
+        forcedLog(level, context, msg);
+    }
+
 private:
+    [[nodiscard]] static bool deferredFormatting();
+
+    [[nodiscard]] static qsizetype sectionStart(const QList<qsizetype> &sectionStarts, int precision)
+    {
+        if (precision <= 0 || precision > sectionStarts.size())
+            return 0;
+        return sectionStarts.at(sectionStarts.size() - precision);
+    }
+
     const QString mName;
+    const QByteArray mNameUtf8;
+    // Where each section but the first starts in mName and mNameUtf8
+    const QList<qsizetype> mSectionStarts;
+    const QList<qsizetype> mSectionStartsUtf8;
     LoggerRepository *mLoggerRepository;
     std::atomic<bool> mAdditivity;
     std::atomic<Level> mLevel;
     Logger *mParentLogger;
+    // Effective level in the low 8 bits, the repository's level generation
+    // it was resolved at in the upper 56 bits
+    mutable std::atomic<quint64> mEffectiveLevelCache{0};
+
+    // Appenders reachable through additivity, deduplicated in dispatch order
+    struct DispatchPlan
+    {
+        quint64 generation;
+        QList<AppenderSharedPtr> appenders;
+    };
+    std::shared_ptr<const DispatchPlan> dispatchPlan() const;
+    void invalidateDispatchPlan();
+    mutable AtomicSharedPtr<const DispatchPlan> mDispatchPlan;
 
     // Needs to be friend to create Logger objects
     friend class Hierarchy;
+    // Need to be friends to log statements their call site has let through
+    friend class LogStream;
+    friend class MessageLogger;
 };
 
+template <typename ...Ts>
+void MessageLogger::log(const QString &message, Ts &&...ts) const
+{
+    if (mContext.callSite)
+        mLogger->formatAndLog(mLevel, mContext, message, std::forward<Ts>(ts)...);
+    else
+        mLogger->logWithLocation(mLevel, mContext.file, mContext.line, mContext.function,
+                                 message, std::forward<Ts>(ts)...);
+}
+
 } // namespace Log4Qt
 
+#include "callsiteimpl.h"
+
 #endif // LOG4QT_LOGGER_H
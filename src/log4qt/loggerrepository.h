@@ -25,6 +25,8 @@
 
 #include <QList>
 
+#include <atomic>
+
 namespace Log4Qt
 {
 
@@ -53,6 +55,55 @@ public:
     virtual bool isDisabled(Level level) const = 0;
     virtual void resetConfiguration() = 0;
     virtual void shutdown() = 0;
+
+    /*!
+     * Returns the level generation of the repository. It changes whenever
+     * the level of one of its loggers changes, so a logger can cache its
+     * effective level and only walk the hierarchy again once the generation
+     * it cached no longer matches.
+     *
+     * \sa bumpLevelGeneration(), Logger::effectiveLevel()
+     */
+    [[nodiscard]] quint64 levelGeneration() const
+    {
+        return mLevelGeneration.load(std::memory_order_acquire);
+    }
+
+    /*!
+     * Invalidates the effective level cached by every logger of the
+     * repository. Called by Logger::setLevel() and resetConfiguration().
+     */
+    void bumpLevelGeneration()
+    {
+        mLevelGeneration.fetch_add(1, std::memory_order_acq_rel);
+    }
+
+    /*!
+     * Returns the dispatch generation of the repository. It changes whenever
+     * appenders are added to or removed from one of its loggers or the
+     * additivity of a logger changes, so a logger can keep the appenders
+     * reachable from it as a precomputed dispatch plan.
+     *
+     * \sa bumpDispatchGeneration(), Logger::callAppenders()
+     */
+    [[nodiscard]] quint64 dispatchGeneration() const
+    {
+        return mDispatchGeneration.load(std::memory_order_acquire);
+    }
+
+    /*!
+     * Invalidates the dispatch plan of every logger of the repository.
+     * Called by Logger when its appenders or its additivity change.
+     */
+    void bumpDispatchGeneration()
+    {
+        mDispatchGeneration.fetch_add(1, std::memory_order_acq_rel);
+    }
+
+private:
+    // Start at 1 so that a logger's zero-initialised cache never matches
+    std::atomic<quint64> mLevelGeneration{1};
+    std::atomic<quint64> mDispatchGeneration{1};
 };
 
 } // namespace Log4Qt
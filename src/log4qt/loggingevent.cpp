@@ -34,13 +34,166 @@
 #include <QThread>
 
 #include <atomic>
+#include <cstddef>
 #include <memory>
+#include <utility>
 
 using namespace Qt::StringLiterals;
 
 namespace Log4Qt
 {
 
+namespace
+{
+
+// Free-list allocator for LoggingEvent::Data. Every thread keeps the blocks
+// it allocated on a private list. A block released on another thread -
+// typically the AsyncWorker - is handed back to its owner through a
+// lock-free stack, which the owner takes over in one exchange once its own
+// list runs dry. A pool therefore never holds more blocks than its thread
+// had events alive at once, and steady-state logging does not call malloc
+// for the event data.
+//
+// All blocks have the size of LoggingEvent::Data, the only user.
+class DataPool
+{
+public:
+    struct alignas(alignof(std::max_align_t)) Header
+    {
+        DataPool *owner;    // nullptr: not pooled
+        Header *next;       // free list link while the block is unused
+    };
+
+    static void *allocate(std::size_t size)
+    {
+        DataPool *pool = currentPool();
+        if (!pool)
+            return unpooled(size);
+
+        Header *block = pool->mLocal;
+        if (!block)
+            block = pool->mRemote.exchange(nullptr, std::memory_order_acquire);
+        if (block)
+            pool->mLocal = block->next;
+        else
+            block = static_cast<Header *>(::operator new(sizeof(Header) + size));
+
+        block->owner = pool;
+        pool->mReferences.fetch_add(1, std::memory_order_relaxed);
+        return block + 1;
+    }
+
+    static void release(void *ptr) noexcept
+    {
+        if (!ptr)
+            return;
+
+        Header *block = static_cast<Header *>(ptr) - 1;
+        DataPool *owner = block->owner;
+        if (!owner)
+        {
+            ::operator delete(block);
+            return;
+        }
+
+        if (owner == tlsPool)
+        {
+            // The owning thread holds a reference, so this never drops to 0
+            block->next = owner->mLocal;
+            owner->mLocal = block;
+            owner->mReferences.fetch_sub(1, std::memory_order_relaxed);
+            return;
+        }
+
+        // Push-only on this side, the owner takes the whole stack at once,
+        // so the compare-and-swap cannot suffer from ABA.
+        Header *head = owner->mRemote.load(std::memory_order_relaxed);
+        do
+            block->next = head;
+        while (!owner->mRemote.compare_exchange_weak(head, block,
+                                                     std::memory_order_release,
+                                                     std::memory_order_relaxed));
+        owner->unref();
+    }
+
+private:
+    DataPool() = default;
+    ~DataPool()
+    {
+        freeList(mLocal);
+        freeList(mRemote.exchange(nullptr, std::memory_order_acquire));
+    }
+    Q_DISABLE_COPY_MOVE(DataPool)
+
+    // Releases the owning thread's reference once it exits. Blocks still in
+    // use keep the pool alive; the last one returned deletes it.
+    struct ThreadGuard
+    {
+        DataPool *pool = nullptr;
+        ~ThreadGuard()
+        {
+            tlsPool = nullptr;
+            tlsExited = true;
+            freeList(std::exchange(pool->mLocal, nullptr));
+            freeList(pool->mRemote.exchange(nullptr, std::memory_order_acquire));
+            pool->unref();
+        }
+    };
+
+    static DataPool *currentPool()
+    {
+        if (tlsPool || tlsExited)
+            return tlsPool;
+
+        static thread_local ThreadGuard guard;
+        guard.pool = tlsPool = new DataPool;
+        return tlsPool;
+    }
+
+    static void *unpooled(std::size_t size)
+    {
+        auto *block = static_cast<Header *>(::operator new(sizeof(Header) + size));
+        block->owner = nullptr;
+        return block + 1;
+    }
+
+    static void freeList(Header *block) noexcept
+    {
+        while (block)
+            ::operator delete(std::exchange(block, block->next));
+    }
+
+    void unref() noexcept
+    {
+        if (mReferences.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            delete this;
+    }
+
+    // Trivially destructible, so they stay usable while other thread_local
+    // objects - which may still release events - are destroyed.
+    static thread_local DataPool *tlsPool;
+    static thread_local bool tlsExited;
+
+    Header *mLocal = nullptr;                   // owning thread only
+    std::atomic<Header *> mRemote{nullptr};     // returned by other threads
+    std::atomic<qint64> mReferences{1};         // owning thread + blocks in use
+};
+
+thread_local DataPool *DataPool::tlsPool = nullptr;
+thread_local bool DataPool::tlsExited = false;
+
+} // namespace
+
+void *LoggingEvent::Data::operator new(std::size_t size)
+{
+    return DataPool::allocate(size);
+}
+
+void LoggingEvent::Data::operator delete(void *ptr) noexcept
+{
+    DataPool::release(ptr);
+}
+
 LoggingEvent::Data::Data() :
     mLevel(Level::NULL_INT),
     mLogger(nullptr),
@@ -245,6 +398,16 @@ qint64 LoggingEvent::sequenceCount()
     return msSequenceCount;
 }
 
+LoggingEvent::SequenceNumberMode LoggingEvent::sequenceNumberMode()
+{
+    return msSequenceNumberMode.load(std::memory_order_relaxed);
+}
+
+void LoggingEvent::setSequenceNumberMode(SequenceNumberMode mode)
+{
+    msSequenceNumberMode.store(mode, std::memory_order_relaxed);
+}
+
 qint64 LoggingEvent::startTime()
 {
     return InitialisationHelper::startTime();
@@ -293,7 +456,26 @@ void LoggingEvent::setThreadNameToCurrent()
 
 qint64 LoggingEvent::nextSequenceNumber()
 {
-    return ++msSequenceCount;
+    if (msSequenceNumberMode.load(std::memory_order_relaxed) == SequenceNumberMode::Global)
+        return msSequenceCount.fetch_add(1, std::memory_order_relaxed) + 1;
+
+    // Claim numbers from the shared counter a block at a time, so the
+    // counter's cache line is written once per block instead of once per
+    // event. Blocks never overlap, so numbers stay unique.
+    static constexpr qint64 BlockSize = 256;
+    struct Block
+    {
+        qint64 next = 0;
+        qint64 end = 0;
+    };
+    static thread_local Block block;
+
+    if (block.next == block.end)
+    {
+        block.next = msSequenceCount.fetch_add(BlockSize, std::memory_order_relaxed) + 1;
+        block.end = block.next + BlockSize;
+    }
+    return block.next++;
 }
 
 Level LoggingEvent::level() const
@@ -308,7 +490,7 @@ const Logger *LoggingEvent::logger() const
 
 QString LoggingEvent::message() const
 {
-    return d->mMessage;
+    return d->mMessage.text();
 }
 
 QHash<QString, QString> LoggingEvent::mdc() const
@@ -384,6 +566,7 @@ int LoggingEvent::lineNumber() const
 void LoggingEvent::setLineNumber(int lineNumber)
 {
     d->mContext.line = lineNumber;
+    d->mContext.callSite = nullptr; // its pre-encoded line no longer applies
 }
 
 QString LoggingEvent::fileName() const
@@ -410,6 +593,7 @@ void LoggingEvent::setMethodName(const QString &functionName)
 }
 
 std::atomic<qint64> LoggingEvent::msSequenceCount {0};
+std::atomic<LoggingEvent::SequenceNumberMode> LoggingEvent::msSequenceNumberMode {SequenceNumberMode::ThreadBlocks};
 const QEvent::Type LoggingEvent::eventId = static_cast<QEvent::Type>(QEvent::registerEventType());
 
 #ifndef QT_NO_DATASTREAM
@@ -421,7 +605,7 @@ QDataStream &operator<<(QDataStream &out, const LoggingEvent &loggingEvent)
     // version 0 data
     out << loggingEvent.d->mLevel
            << loggingEvent.loggername()
-           << loggingEvent.d->mMessage
+           << loggingEvent.d->mMessage.text()
            << loggingEvent.d->mNdc
            << loggingEvent.d->mProperties
            << loggingEvent.d->mSequenceNumber
@@ -446,9 +630,10 @@ QDataStream &operator>>(QDataStream &in, LoggingEvent &loggingEvent)
 
     // Version 0 data
     QString logger;
+    QString message;
     in >> loggingEvent.d->mLevel
        >> logger
-       >> loggingEvent.d->mMessage
+       >> message
        >> loggingEvent.d->mNdc
        >> loggingEvent.d->mProperties
        >> loggingEvent.d->mSequenceNumber
@@ -457,6 +642,7 @@ QDataStream &operator>>(QDataStream &in, LoggingEvent &loggingEvent)
 
     if (in.status() != QDataStream::Ok)
         return in;
+    loggingEvent.d->mMessage.setText(message);
 
     // Do not auto-create loggers from an untrusted stream. Only resolve the
     // event's logger if a logger with this name has already been registered.
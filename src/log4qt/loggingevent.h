@@ -21,13 +21,16 @@
 #ifndef LOG4QT_LOG4QTEVENT_H
 #define LOG4QT_LOG4QTEVENT_H
 
+#include "callsite.h"
 #include "level.h"
+#include "helpers/deferredmessage.h"
 
 #include <QHash>
 #include <QStringList>
 #include <QEvent>
 
 #include <atomic>
+#include <cstddef>
 #ifdef __cpp_lib_source_location
 #include <source_location>
 #endif
@@ -43,16 +46,22 @@ class MessageContext
 {
 public:
     constexpr explicit MessageContext() noexcept
-        : file(nullptr), line(-1), function(nullptr) {}
+        : file(nullptr), line(-1), function(nullptr), callSite(nullptr) {}
     constexpr explicit MessageContext(const char *fileName, int lineNumber, const char *functionName) noexcept
-        : file(fileName), line(lineNumber), function(functionName) {}
+        : file(fileName), line(lineNumber), function(functionName), callSite(nullptr) {}
 #ifdef __cpp_lib_source_location
     explicit MessageContext(const std::source_location &loc)
-        : file(loc.file_name()), line(static_cast<int>(loc.line())), function(loc.function_name()) {}
+        : file(loc.file_name()), line(static_cast<int>(loc.line())), function(loc.function_name()), callSite(nullptr) {}
 #endif
+    explicit MessageContext(const CallSite &site) noexcept
+        : file(site.file()), line(site.line()), function(site.function()), callSite(&site) {}
     const char *file;
     int line;
     const char *function;
+    // The l4q* statement of the event, with its location pre-encoded; null
+    // for events logged otherwise. Never deleted, and file and function
+    // point into it, so the event may outlive the statement's library.
+    const CallSite *callSite;
 };
 
 /*!
@@ -62,10 +71,27 @@ public:
  * The class uses milliseconds since 1970-01-01T00:00:00, Coordinated
  * Universal Time for time values. For converstion from and to QDateTime
  * use DateTime.
+ *
+ * Every event gets a unique sequence number. By default each thread claims
+ * a block of numbers from the global counter at a time, so producer threads
+ * do not contend on it: numbers are unique and increase per thread, but
+ * events of different threads are not numbered in creation order. Set
+ * SequenceNumberMode::Global to number every event from the shared counter.
  */
 class LOG4QT_EXPORT LoggingEvent : public QEvent
 {
 public:
+    /*!
+     * Selects how sequence numbers are allocated.
+     *
+     * \sa setSequenceNumberMode()
+     */
+    enum class SequenceNumberMode
+    {
+        ThreadBlocks,  //!< Each thread numbers from its own block (default)
+        Global         //!< Every event increments the shared counter
+    };
+
     static const QEvent::Type eventId;
     LoggingEvent();
     virtual ~LoggingEvent();
@@ -139,10 +165,38 @@ public:
     [[nodiscard]] QString property(const QString &key) const;
     [[nodiscard]] QStringList propertyKeys() const;
     void setProperty(const QString &key, const QString &value);
+
+    /*!
+     * Sets the message to \a format completed with \a args through
+     * QString::arg(). The arguments are captured in the event and the
+     * message is built on the first call to message(), on whichever thread
+     * makes it.
+     *
+     * \sa DeferredMessage, LogManager::setDeferredFormatting()
+     */
+    template<typename ...Ts>
+    void setDeferredMessage(const QString &format, Ts &&...args)
+    {
+        d->mMessage.defer(format, std::forward<Ts>(args)...);
+    }
     QString toString() const;
+    /*!
+     * Returns the number of sequence numbers handed out so far. With
+     * SequenceNumberMode::ThreadBlocks this includes the unused part of
+     * every thread's current block.
+     */
     static qint64 sequenceCount();
     static qint64 startTime();
 
+    static SequenceNumberMode sequenceNumberMode();
+
+    /*!
+     * Sets the sequence number allocation \a mode for all threads. Numbers
+     * stay unique across a change, since both modes draw from the same
+     * counter.
+     */
+    static void setSequenceNumberMode(SequenceNumberMode mode);
+
     [[nodiscard]] int lineNumber() const;
     void setLineNumber(int lineNumber);
     [[nodiscard]] QString fileName() const;
@@ -180,9 +234,13 @@ private:
              const MessageContext &context,
              const QString &categoryName);
 
+        // Allocated from per-thread free lists, see loggingevent.cpp
+        static void *operator new(std::size_t size);
+        static void operator delete(void *ptr) noexcept;
+
         Level mLevel;
         const Logger *mLogger;
-        QString mMessage;
+        DeferredMessage mMessage;
         QString mNdc;
         QHash<QString, QString> mProperties;
         qint64 mSequenceNumber;
@@ -195,6 +253,7 @@ private:
     QSharedDataPointer<Data> d;
 
     static std::atomic<qint64> msSequenceCount;
+    static std::atomic<SequenceNumberMode> msSequenceNumberMode;
 
 #ifndef QT_NO_DATASTREAM
     // Needs to be friend to stream objects
@@ -21,6 +21,7 @@
 #include "logmanager.h"
 
 #include "consoleappender.h"
+#include "helpers/atomicsharedptr.h"
 #include "helpers/datetime.h"
 #include "helpers/initialisationhelper.h"
 #include "helpers/optionconverter.h"
@@ -39,10 +40,13 @@
 #include <QSettings>
 #include <QStringList>
 #include <QFileInfo>
+#include <QByteArray>
+#include <QHash>
 #include <QLoggingCategory>
 #include <QStringBuilder>
 
 #include <cstdlib>
+#include <memory>
 
 using namespace Qt::StringLiterals;
 
@@ -55,10 +59,70 @@ static bool isFatal(QtMsgType msgType);
 LOG4QT_DECLARE_STATIC_LOGGER(static_logger, Log4Qt::LogManager)
 Q_GLOBAL_STATIC(QMutex, singleton_guard)
 
+namespace
+{
+
+// The logger and the interned event category name of a QLoggingCategory
+struct QtCategory
+{
+    Logger *logger = nullptr;
+    QString categoryName;
+};
+
+using QtCategories = QHash<QByteArray, QtCategory>;
+
+// Category lookups are answered from an immutable snapshot that only grows;
+// the mutex just serialises publishing a new one.
+struct QtCategoryCache
+{
+    QMutex guard;
+    AtomicSharedPtr<const QtCategories> categories;
+};
+
+}
+
+Q_GLOBAL_STATIC(QtCategoryCache, qt_category_cache)
+
+static QtCategory qtCategory(const char *category)
+{
+    const auto name = QByteArray::fromRawData(category, qstrlen(category));
+    auto *cache = qt_category_cache();
+    if (cache != nullptr)
+    {
+        if (const auto categories = cache->categories.load())
+        {
+            const auto it = categories->constFind(name);
+            if (it != categories->cend())
+                return *it;
+        }
+    }
+
+    QtCategory entry;
+    entry.categoryName = u"Qt "_s % QString::fromUtf8(name);
+    // "default" is the category of plain qDebug() and friends. The logger is
+    // resolved before taking the cache mutex, as a repository lookup may
+    // itself emit Qt messages.
+    if (name.isEmpty() || name == "default")
+        entry.logger = LogManager::qtLogger();
+    else
+        entry.logger = LogManager::logger(u"Qt::"_s % QString::fromUtf8(name));
+
+    if (cache != nullptr)
+    {
+        QMutexLocker locker(&cache->guard);
+        const auto categories = cache->categories.load();
+        auto updated = std::make_shared<QtCategories>(categories ? *categories : QtCategories());
+        updated->insert(QByteArray(name.constData(), name.size()), entry);
+        cache->categories.store(std::move(updated));
+    }
+    return entry;
+}
+
 LogManager::LogManager() :
     mLoggerRepository(new Hierarchy()),
     mHandleQtMessages(false),
     mWatchThisFile(false),
+    mDeferredFormatting(false),
     mQtMsgHandler(nullptr)
 {
 }
@@ -136,6 +200,7 @@ Logger *LogManager::logger(const QString &name)
 void LogManager::resetConfiguration()
 {
     setHandleQtMessages(false);
+    setDeferredFormatting(false);
     instance()->mLoggerRepository->resetConfiguration();
     configureLogLogger();
 }
@@ -473,14 +538,20 @@ void LogManager::qtMessageHandler(QtMsgType type, const QMessageLogContext &cont
     default:
         level = Level::TRACE_INT;
     }
-    LoggingEvent loggingEvent = LoggingEvent(instance()->qtLogger(),
-                                             level,
-                                             message,
-                                             MessageContext(context.file, context.line, context.function),
-                                             u"Qt "_s % context.category);
 
-    instance()->qtLogger()->log(loggingEvent);
+    // Filter on the category's logger before building the event, so silenced
+    // categories cost one lookup and one level check.
+    const QtCategory category = qtCategory(context.category);
+    if (category.logger->isEnabledFor(level))
+    {
+        LoggingEvent loggingEvent = LoggingEvent(category.logger,
+                                                 level,
+                                                 message,
+                                                 MessageContext(context.file, context.line, context.function),
+                                                 category.categoryName);
 
+        category.logger->log(loggingEvent);
+    }
 
     // Qt fatal behaviour copied from global.cpp qt_message_output()
     // begin {
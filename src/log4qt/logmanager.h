@@ -92,6 +92,17 @@ public:
         return instance()->mWatchThisFile.load(std::memory_order_acquire);
     }
 
+    /*!
+     * Returns true, if the variadic Logger functions leave formatting the
+     * message to the first reader of the event.
+     *
+     * \sa setDeferredFormatting()
+     */
+    [[nodiscard]] static bool deferredFormatting()
+    {
+        return instance()->mDeferredFormatting.load(std::memory_order_relaxed);
+    }
+
     /*!
      * Returns the filter rules for qc[Info|Debug|Warning|Critical]
      *
@@ -144,9 +155,13 @@ public:
      * Activates or deactivates the handling of messages created by calls
      * to qDebug(), qWarning(), qCritical() and qFatal() is activated.
      *
-     * If activated, a Qt message handler is installed. Messages are logged
-     * using the logger returned by qtLogger(). For fatal messages the same
-     * exit procedure is implemented as for qFatal().
+     * If activated, a Qt message handler is installed. Messages of the
+     * default category are logged using the logger returned by qtLogger(),
+     * messages of any other QLoggingCategory using its child logger
+     * "Qt::<category>", with the dots of the category name becoming levels
+     * of the hierarchy (e.g. "Qt::qt::network"). Disabled levels are
+     * filtered before an event is built. For fatal messages the same exit
+     * procedure is implemented as for qFatal().
      *
      * The following mappping is used from QtMsgType to Level:
      *
@@ -193,6 +208,22 @@ public:
         instance()->doSetWatchThisFile(watchThisFile);
     }
 
+    /*!
+     * Enables/disables deferred formatting. If enabled, calls like
+     * Logger::info(format, args...) capture the arguments in the
+     * LoggingEvent and build the message on the first
+     * LoggingEvent::message() call. Behind an AsyncAppender that happens on
+     * the worker thread instead of the logging thread.
+     *
+     * The default value is false for formatting on the logging thread.
+     *
+     * \sa deferredFormatting(), DeferredMessage
+     */
+    static void setDeferredFormatting(bool deferredFormatting)
+    {
+        instance()->mDeferredFormatting.store(deferredFormatting, std::memory_order_relaxed);
+    }
+
     /*!
      * Set a message pattern for qc[Debug|Info|Warn|Critical]
      *
@@ -330,6 +361,7 @@ private:
     LoggerRepository *mLoggerRepository;
     std::atomic<bool> mHandleQtMessages;
     std::atomic<bool> mWatchThisFile;
+    std::atomic<bool> mDeferredFormatting;
     QString mFilterRules, mMessagePattern;
     QtMessageHandler mQtMsgHandler;
     static std::atomic<LogManager *> mInstance;
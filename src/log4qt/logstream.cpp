@@ -17,30 +17,149 @@
  * limitations under the License.
  *
  ******************************************************************************/
-
 #include "logstream.h"
 #include "logger.h"
 
+#include <memory>
+#include <utility>
+#include <vector>
+
 namespace Log4Qt
 {
 
+namespace
+{
+
+// Streams kept per thread. Nested statements - a value whose operator<<
+// logs itself - need more than one at a time; beyond this they are freed.
+constexpr std::size_t MaxPooledStreams = 8;
+// Buffers that grew beyond this are not kept for the next statement
+constexpr qsizetype MaxPooledCapacity = 16 * 1024;
+
+// Set once the thread's pool is destroyed; streams released later, by other
+// thread_local destructors, are deleted
+thread_local bool tlsPoolDestroyed = false;
+
+} // namespace
+
+struct LogStream::StreamPool
+{
+    StreamPool()
+    {
+        streams.reserve(MaxPooledStreams);
+    }
+    ~StreamPool()
+    {
+        tlsPoolDestroyed = true;
+    }
+
+    std::vector<std::unique_ptr<Stream>> streams;
+};
+
 LogStream::LogStream(const Logger &iLogger, Level iLevel)
 {
     if (iLogger.isEnabledFor(iLevel))
-        stream = std::make_shared<Stream>(&iLogger, iLevel);
+        stream = acquireStream(&iLogger, iLevel);
+}
+
+LogStream::LogStream(const Logger &iLogger, const CallSite &site)
+    : stream(acquireStream(&iLogger, site.level(), &site))
+{
+}
+
+LogStream::LogStream(const LogStream &other) noexcept
+    : stream(other.stream)
+{
+    if (stream)
+        stream->mReferences.fetch_add(1, std::memory_order_relaxed);
+}
+
+LogStream::LogStream(LogStream &&other) noexcept
+    : stream(std::exchange(other.stream, nullptr))
+{
+}
+
+LogStream &LogStream::operator=(const LogStream &other)
+{
+    LogStream copy(other);
+    std::swap(stream, copy.stream);
+    return *this;
+}
+
+LogStream &LogStream::operator=(LogStream &&other) noexcept
+{
+    std::swap(stream, other.stream);
+    return *this;
+}
+
+LogStream::~LogStream()
+{
+    if (stream && stream->mReferences.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        releaseStream(stream);
 }
 
-LogStream::Stream::Stream(const Logger *iLogger, Level iLevel)
+LogStream::Stream::Stream()
     : ts(&buffer, QIODeviceBase::WriteOnly)
-    , mLogger(iLogger)
-    , mLevel(iLevel)
 {
 }
 
-LogStream::Stream::~Stream()
+LogStream::StreamPool *LogStream::threadPool()
 {
-    if (!mLogger.isNull())
-        mLogger->log(mLevel, buffer);
+    if (tlsPoolDestroyed)
+        return nullptr;
+    static thread_local StreamPool pool;
+    return &pool;
+}
+
+LogStream::Stream *LogStream::acquireStream(const Logger *iLogger, Level iLevel, const CallSite *site)
+{
+    Stream *stream = nullptr;
+    StreamPool *pool = threadPool();
+    if (pool && !pool->streams.empty())
+    {
+        stream = pool->streams.back().release();
+        pool->streams.pop_back();
+        stream->mReferences.store(1, std::memory_order_relaxed);
+    }
+    else
+    {
+        stream = new Stream;
+    }
+    stream->mLogger = iLogger;
+    stream->mLevel = iLevel;
+    stream->mCallSite = site;
+    return stream;
+}
+
+void LogStream::releaseStream(Stream *stream)
+{
+    // An exact-size copy for the event, so the buffer keeps its capacity
+    if (!stream->mLogger.isNull())
+    {
+        QString message(stream->buffer.constData(), stream->buffer.size());
+        if (stream->mCallSite)
+            stream->mLogger->forcedLog(stream->mLevel, MessageContext(*stream->mCallSite), message);
+        else
+            stream->mLogger->log(stream->mLevel, message);
+    }
+    stream->mLogger.clear();
+    stream->mCallSite = nullptr;
+
+    StreamPool *pool = threadPool();
+    if (!pool || pool->streams.size() >= MaxPooledStreams)
+    {
+        delete stream;
+        return;
+    }
+
+    // Manipulators such as Qt::hex must not leak into the next statement
+    stream->ts.reset();
+    stream->ts.resetStatus();
+    if (stream->buffer.capacity() > MaxPooledCapacity)
+        stream->buffer = QString();
+    else
+        stream->buffer.truncate(0);
+    pool->streams.emplace_back(stream);
 }
 
 } // namespace Log4Qt
@@ -27,7 +27,7 @@
 #include <QString>
 #include <QPointer>
 
-#include <memory>
+#include <atomic>
 
 #ifdef __cpp_concepts
 #include <concepts>
@@ -40,15 +40,30 @@ concept QTextStreamable = requires(QTextStream &ts, const T &t) {
 
 namespace Log4Qt
 {
+class CallSite;
 class Logger;
 
 class LOG4QT_EXPORT LogStream
 {
 public:
     //! Constructs a LogStream for the given logger and level.
-    //! If the level is disabled on the logger, no internal stream is allocated
+    //! If the level is disabled on the logger, no internal stream is taken
     //! and all data streamed via operator<< is silently discarded.
+    //! Otherwise the stream comes from a small per-thread pool of reusable
+    //! QTextStream/QString pairs, so streaming does not set up a new text
+    //! stream per statement.
     LogStream(const Logger &iLogger, Level iLevel);
+    //! Constructs a LogStream for a statement that \a site has already let
+    //! through; the message is logged with the location of the site.
+    LogStream(const Logger &iLogger, const CallSite &site);
+    //! Copies share the stream; the message is logged when the last copy
+    //! is destroyed.
+    LogStream(const LogStream &other) noexcept;
+    LogStream(LogStream &&other) noexcept;
+    LogStream &operator=(const LogStream &other);
+    LogStream &operator=(LogStream &&other) noexcept;
+    ~LogStream();
+
 #ifdef __cpp_concepts
     template<QTextStreamable T>
 #else
@@ -64,15 +79,22 @@ public:
 private:
     struct Stream
     {
-        Stream(const Logger *iLogger, Level iLevel);
-        ~Stream();
+        Stream();
 
         QTextStream ts;
         QString buffer;
         QPointer<const Logger> mLogger;
         Level mLevel;
+        const CallSite *mCallSite = nullptr;
+        std::atomic<int> mReferences{1};
     };
-    std::shared_ptr<Stream> stream;
+    struct StreamPool;
+
+    static Stream *acquireStream(const Logger *iLogger, Level iLevel, const CallSite *site = nullptr);
+    static void releaseStream(Stream *stream);
+    static StreamPool *threadPool();
+
+    Stream *stream = nullptr;
 };
 }
 
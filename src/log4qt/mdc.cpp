@@ -20,35 +20,46 @@
 
 #include "mdc.h"
 
-#include <QMutex>
-#include <QThread>
 #include "helpers/initialisationhelper.h"
+#include "helpers/threadlocaldata.h"
 
 namespace Log4Qt
 {
 
 QString MDC::get(const QString &key)
 {
-    if (!instance()->mHash.hasLocalData())
-        return {};
-
-    return instance()->mHash.localData()->value(key);
+    return localData().value(key);
 }
 
 QHash<QString, QString> MDC::context()
 {
-    if (!instance()->mHash.hasLocalData())
-        return QHash<QString, QString>();
+    // Shares the thread's hash; the caller's copy is detached lazily
+    return localData();
+}
+
+void MDC::put(const QString &key, const QString &value)
+{
+    QHash<QString, QString> &hash = localData();
+    const auto it = hash.constFind(key);
+    if (it != hash.cend() && *it == value)
+        return;
+    hash.insert(key, value);
+}
 
-    return *instance()->mHash.localData();
+void MDC::remove(const QString &key)
+{
+    // QHash::remove() detaches before looking the key up
+    QHash<QString, QString> &hash = localData();
+    if (hash.contains(key))
+        hash.remove(key);
 }
 
 LOG4QT_IMPLEMENT_INSTANCE(MDC)
 
-QHash<QString, QString> *MDC::localData()
+QHash<QString, QString> &MDC::localData()
 {
-    if (!instance()->mHash.hasLocalData())
-        instance()->mHash.setLocalData(new QHash<QString, QString>);
-    return instance()->mHash.localData();
+    // A thread_local pointer instead of QThreadStorage: one TLS access per
+    // call. It stays valid for logging at thread exit.
+    return ThreadLocalData<MDC, QHash<QString, QString>>::get();
 }
 } // namespace Log4Qt
@@ -25,7 +25,6 @@
 
 #include <QString>
 #include <QHash>
-#include <QThreadStorage>
 
 namespace Log4Qt
 {
@@ -33,6 +32,10 @@ namespace Log4Qt
 /*!
      * \brief The class MDC implements a mapped diagnostic context.
      *
+     * Each thread's context is an implicitly shared QHash. context() and
+     * every LoggingEvent only take a reference to it; the hash is copied
+     * only when put() or remove() change it while such a snapshot is alive.
+     *
      * \note All the functions declared in this class are thread-safe.
      */
 class LOG4QT_EXPORT MDC
@@ -50,20 +53,21 @@ public:
      */
     static MDC *instance();
 
-    static void put(const QString &key, const QString &value)
-    {
-        localData()->insert(key, value);
-    }
-    static void remove(const QString &key)
-    {
-        localData()->remove(key);
-    }
+    /*!
+     * Sets \a key to \a value in the context of the calling thread. Does
+     * nothing if the key already holds that value, so snapshots taken by
+     * earlier events stay shared.
+     */
+    static void put(const QString &key, const QString &value);
 
-private:
-    static QHash<QString, QString> *localData();
+    /*!
+     * Removes \a key from the context of the calling thread. Does nothing
+     * if the key is not set.
+     */
+    static void remove(const QString &key);
 
 private:
-    QThreadStorage<QHash<QString, QString> *> mHash;
+    static QHash<QString, QString> &localData();
 };
 
 } // namespace Log4Qt
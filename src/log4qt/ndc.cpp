@@ -21,11 +21,9 @@
 #include "ndc.h"
 
 #include "helpers/initialisationhelper.h"
+#include "helpers/threadlocaldata.h"
 #include "logger.h"
 
-#include <QMutex>
-#include <QThread>
-
 using namespace Qt::StringLiterals;
 
 namespace Log4Qt
@@ -35,19 +33,13 @@ LOG4QT_DECLARE_STATIC_LOGGER(logger, Log4Qt: NDC)
 
 void NDC::clear()
 {
-    if (!instance()->mStack.hasLocalData())
-        return;
-
-    instance()->mStack.localData()->clear();
+    localData().clear();
 }
 
 
 int NDC::depth()
 {
-    if (!instance()->mStack.hasLocalData())
-        return 0;
-
-    return instance()->mStack.localData()->count();
+    return localData().count();
 }
 
 
@@ -56,42 +48,48 @@ LOG4QT_IMPLEMENT_INSTANCE(NDC)
 
 QString NDC::pop()
 {
-    if (!instance()->mStack.hasLocalData() || instance()->mStack.localData()->isEmpty())
+    QStack<QString> &stack = localData();
+    if (stack.isEmpty())
     {
         logger()->warn(u"Requesting pop from empty NDC stack"_s);
         return {};
     }
 
-    return instance()->mStack.localData()->pop();
+    return stack.pop();
 }
 
 
 void NDC::push(const QString &message)
 {
-    if (!instance()->mStack.hasLocalData())
-        instance()->mStack.setLocalData(new QStack<QString>);
-
-    instance()->mStack.localData()->push(message);
+    localData().push(message);
 }
 
 
 void NDC::setMaxDepth(int maxDepth)
 {
-    if (!instance()->mStack.hasLocalData() ||
-            instance()->mStack.localData()->size() <= maxDepth)
+    QStack<QString> &stack = localData();
+    if (stack.size() <= maxDepth)
         return;
 
-    instance()->mStack.localData()->resize(maxDepth);
+    stack.resize(maxDepth);
 }
 
 
 QString NDC::peek()
 {
-    if (!instance()->mStack.hasLocalData() ||
-            instance()->mStack.localData()->isEmpty())
+    // Events keep a shared reference to the top entry, not a copy
+    const QStack<QString> &stack = localData();
+    if (stack.isEmpty())
         return {};
 
-    return instance()->mStack.localData()->top();
+    return stack.top();
+}
+
+
+QStack<QString> &NDC::localData()
+{
+    // See MDC::localData()
+    return ThreadLocalData<NDC, QStack<QString>>::get();
 }
 
 } // namespace Log4Qt
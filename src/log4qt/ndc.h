@@ -25,7 +25,6 @@
 
 #include <QString>
 #include <QStack>
-#include <QThreadStorage>
 
 namespace Log4Qt
 {
@@ -33,8 +32,8 @@ namespace Log4Qt
 /*!
  * \brief The class NDC implements a nested diagnostic context.
  *
- * The method remove() is not required. QThreadStorage cleans up on thread
- * exit.
+ * The method remove() is not required. Each thread's stack is destroyed
+ * on thread exit.
  *
  * \note All the functions declared in this class are thread-safe.
  */
@@ -59,7 +58,7 @@ public:
     static QString peek();
 
 private:
-    QThreadStorage<QStack<QString> *> mStack;
+    static QStack<QString> &localData();
 };
 
 } // namespace Log4Qt
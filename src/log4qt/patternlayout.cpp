@@ -72,6 +72,13 @@ QString PatternLayout::format(const LoggingEvent &event)
     return mpPatternFormatter->format(event);
 }
 
+void PatternLayout::formatTo(const LoggingEvent &event, QByteArray &dest)
+{
+    Q_ASSERT_X(mpPatternFormatter, "PatternLayout::formatTo()", "mpPatternConverter must not be null");
+
+    mpPatternFormatter->formatTo(event, dest);
+}
+
 bool PatternLayout::requiresLocation() const
 {
     return mpPatternFormatter && mpPatternFormatter->requiresLocation();
@@ -137,6 +137,12 @@ public:
 
     [[nodiscard]] QString format(const LoggingEvent &event) override;
 
+    /*!
+     * Writes the event as UTF-8 through PatternFormatter::formatTo(),
+     * without building the QString that format() returns.
+     */
+    void formatTo(const LoggingEvent &event, QByteArray &dest) override;
+
     /*!
      * Returns true if the current pattern contains at least one
      * location-sensitive conversion character (\c %F, \c %L, \c %M,
@@ -218,6 +218,15 @@ void PropertyConfigurator::configureGlobalSettings(const Properties &properties,
                         QVariant(LogManager::watchThisFile()).toString());
     }
 
+    // Deferred formatting
+    value = properties.property(u"deferredFormatting"_s);
+    if (!value.isNull())
+    {
+        LogManager::setDeferredFormatting(OptionConverter::toBoolean(value, false));
+        staticLogger()->debug(u"Set deferred formatting to %1"_s,
+                        QVariant(LogManager::deferredFormatting()).toString());
+    }
+
     // Filter rules
     value = properties.property(u"filterRules"_s);
     if (!value.isNull())
@@ -667,6 +676,7 @@ Properties PropertyConfigurator::translateLegacyProperties(const Properties &pro
         {u"log4j.threshold"_s,                u"threshold"_s},
         {u"log4j.handleQtMessages"_s,         u"handleQtMessages"_s},
         {u"log4j.watchThisFile"_s,            u"watchThisFile"_s},
+        {u"log4j.deferredFormatting"_s,       u"deferredFormatting"_s},
         {u"log4j.qtLogging.filterRules"_s,    u"filterRules"_s},
         {u"log4j.qtLogging.messagePattern"_s, u"messagePattern"_s},
     };
@@ -45,6 +45,15 @@ static inline QByteArray &encodedMessageBuffer()
     return AbstractStringLayout::threadLocalBuffer();
 }
 
+// Separate from encodedMessageBuffer(): a nested single-event append on the
+// same thread (e.g. an error logged while the batch is written) must not
+// clobber the batch being assembled.
+static inline QByteArray &encodedBatchBuffer()
+{
+    thread_local QByteArray buf;
+    return buf;
+}
+
 RandomAccessFileAppender::RandomAccessFileAppender(QObject *parent)
     : AppenderSkeleton(false, parent)
     , mAppendFile(false)
@@ -177,6 +186,7 @@ void RandomAccessFileAppender::append(const LoggingEvent &event)
     if (mByteBuffer.size() + encoded.size() > mBufferSize.load(std::memory_order_relaxed))
         flushBuffer();
 
+    appendLayoutPending();
     mByteBuffer.append(encoded);
     encoded.clear();
 
@@ -184,6 +194,61 @@ void RandomAccessFileAppender::append(const LoggingEvent &event)
         flushBuffer();
 }
 
+void RandomAccessFileAppender::appendBatch(std::span<const LoggingEvent *const> events, const LayoutSharedPtr &layout)
+{
+    if (!layout)
+        return;
+
+    // Called outside mObjectGuard — encode the whole batch into one block.
+    QByteArray &block = encodedBatchBuffer();
+    block.clear();
+    auto *sl = qobject_cast<AbstractStringLayout *>(layout.data());
+    for (const auto *event : events)
+    {
+        if (sl)
+            sl->formatTo(*event, block);
+        else
+            block += layout->format(*event).toUtf8();
+    }
+    if (block.isEmpty())
+        return;
+
+    QMutexLocker locker(&mObjectGuard);
+    if (!checkEntryConditions())
+    {
+        block.clear();
+        return;
+    }
+
+    if (mByteBuffer.size() + block.size() > mBufferSize.load(std::memory_order_relaxed))
+        flushBuffer();
+
+    appendLayoutPending();
+    // A block larger than the whole buffer goes straight to the file.
+    if (block.size() > mBufferSize.load(std::memory_order_relaxed))
+    {
+        flushBuffer();
+        mFile->write(block);
+        handleIoErrors();
+    }
+    else
+    {
+        mByteBuffer.append(block);
+        if (mImmediateFlush.load(std::memory_order_relaxed))
+            flushBuffer();
+    }
+    block.clear();
+}
+
+void RandomAccessFileAppender::appendLayoutPending()
+{
+    // What the layout's formatted events rely on, e.g. the Define records of
+    // BinaryLayout, goes in front of them in this file. mLayoutWritten is the
+    // layout's marker for mFile and restarts at 0 in openFile().
+    if (auto *sl = qobject_cast<AbstractStringLayout *>(layoutSnapshot().data()))
+        sl->formatPendingTo(mByteBuffer, mLayoutWritten);
+}
+
 void RandomAccessFileAppender::flushBuffer()
 {
     if (mByteBuffer.isEmpty())
@@ -255,14 +320,15 @@ void RandomAccessFileAppender::openFile()
     logger()->debug(u"Opened file '%1' for appender '%2'"_s, mFile->fileName(), name());
 
     // Write the layout header (if any) into the buffer so it is included in
-    // the first flush. Skip when appending to a non-empty existing file —
-    // the header is already present from the previous run.
+    // the first flush. Text layouts skip it when appending to a non-empty
+    // existing file — the header is already present from the previous run.
     const bool isNewFile = !mAppendFile.load(std::memory_order_relaxed) || mFile->size() == 0;
-    if (isNewFile) {
-        const LayoutSharedPtr l = layout();
-        if (l && !l->header().isEmpty())
-            mByteBuffer += l->header().toUtf8() + AbstractLayout::endOfLine().toUtf8();
-    }
+    const LayoutSharedPtr l = layout();
+    mLayoutWritten = 0;
+    if (auto *sl = qobject_cast<AbstractStringLayout *>(l.data()))
+        sl->formatHeaderTo(mByteBuffer, !isNewFile);
+    else if (isNewFile && l && !l->header().isEmpty())
+        mByteBuffer += l->header().toUtf8() + AbstractLayout::endOfLine().toUtf8();
 }
 
 void RandomAccessFileAppender::closeFile()
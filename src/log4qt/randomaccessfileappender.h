@@ -182,6 +182,14 @@ protected:
 
     void append(const LoggingEvent &event) override;
 
+    /*!
+     * Encodes all \a events into one thread-local block outside
+     * \c mObjectGuard, then copies the block into the write buffer under a
+     * single lock acquisition. With \l immediateFlush set, the buffer is
+     * flushed once per batch instead of once per event.
+     */
+    void appendBatch(std::span<const LoggingEvent *const> events, const LayoutSharedPtr &layout) override;
+
     /*!
      * Tests if all entry conditions for using append() in this class are met.
      *
@@ -207,6 +215,7 @@ protected:
 
 private:
     void closeInternal();
+    void appendLayoutPending();
 
     std::atomic<bool> mAppendFile;
     std::atomic<int>  mBufferSize;
@@ -214,6 +223,7 @@ private:
     QString           mFileName;      // guarded by mObjectGuard
     QByteArray        mByteBuffer;    // guarded by mObjectGuard
     std::unique_ptr<QFile> mFile;     // guarded by mObjectGuard
+    qsizetype         mLayoutWritten = 0; // guarded by mObjectGuard
 };
 
 } // namespace Log4Qt
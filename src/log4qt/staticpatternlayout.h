@@ -0,0 +1,452 @@
+/******************************************************************************
+ *
+ * This file is part of Log4Qt library.
+ *
+ * Copyright (C) 2007 - 2026 Log4Qt contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+#ifndef LOG4QT_STATICPATTERNLAYOUT_H
+#define LOG4QT_STATICPATTERNLAYOUT_H
+
+#include "abstractstringlayout.h"
+#include "logger.h"
+#include "loggingevent.h"
+#include "helpers/datetime.h"
+#include "helpers/factory.h"
+#include "helpers/formatstring.h"
+#include "helpers/patternformatter.h"
+
+#include <QDateTime>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+namespace Log4Qt
+{
+
+/*!
+ * \brief The class template StaticPatternLayout formats logging events with
+ *        a conversion pattern parsed at compile time.
+ *
+ * StaticPatternLayout produces the same output as a PatternLayout with the
+ * same pattern, for patterns that are fixed when the program is built:
+ *
+ * \code
+ * using AccessLayout = Log4Qt::StaticPatternLayout<"%d{ISO8601} [%t] %-5p %c - %m%n">;
+ * appender->setLayout(LayoutSharedPtr(new AccessLayout));
+ * \endcode
+ *
+ * The pattern is parsed into a list of steps at compile time, and formatTo()
+ * is generated as one inline statement per step. There is no converter chain,
+ * no virtual call per conversion and no switch on the conversion type.
+ * Literals are stored UTF-8 encoded in the binary, and padding modifiers are
+ * constants. Before writing, formatTo() adds up the fields that are cheap to
+ * measure and, if the destination lacks the room, grows it geometrically
+ * once, so a batch formatted into one buffer stays linear.
+ *
+ * The conversions are those of PatternLayout, except that \c %P and a bare
+ * \c %X (the whole MDC) are not supported. A pattern using either, an
+ * invalid conversion character or a malformed modifier does not compile,
+ * where PatternLayout logs a warning at runtime and writes the text as a
+ * literal. Date formats are resolved when the layout is constructed, so
+ * \c %d{locale} follows the locale at that time.
+ *
+ * The pattern is part of the type, so there is no \c conversionPattern
+ * property to configure. To make a layout available to configuration
+ * files, register it with the Factory under a class name of your choice:
+ *
+ * \code
+ * AccessLayout::registerLayout(u"AccessLayout"_s);
+ * \endcode
+ *
+ * \note The class template has no meta-object of its own: metaObject()
+ *       returns the one of AbstractStringLayout.
+ * &nbsp;
+ * \note The ownership and lifetime of objects of this class are managed.
+ *       See \ref Ownership "Object ownership" for more details.
+ *
+ * \sa PatternLayout, PatternFormatter
+ */
+template<FormatLiteral Pattern>
+class StaticPatternLayout final : public AbstractStringLayout
+{
+    static constexpr std::size_t Capacity = sizeof(Pattern.value);
+
+    enum class Op
+    {
+        Literal,
+        Message,
+        Ndc,
+        LevelName,
+        Thread,
+        LoggerName,
+        Mdc,
+        Date,
+        Relative,
+        Filename,
+        FunctionName,
+        LineNumber,
+        Location
+    };
+
+    struct Step
+    {
+        Op op = Op::Literal;
+        FormattingInfo formattingInfo;
+        // Literal: the encoded text; Date, Mdc: the option
+        std::size_t begin = 0;
+        std::size_t size = 0;
+        // LoggerName: the number of trailing name sections, 0 for all
+        int precision = 0;
+    };
+
+    struct Parsed
+    {
+        std::array<Step, Capacity> steps {};
+        std::size_t stepCount = 0;
+        std::array<char, Capacity> text {};
+        std::size_t textSize = 0;
+        bool requiresLocation = false;
+    };
+
+    // Not constexpr: reaching it while parsing stops compilation
+    static void invalidPattern(const char *) {}
+
+    static consteval bool isDigit(char c)
+    {
+        return c >= '0' && c <= '9';
+    }
+
+    // Reads the digits at in[i] into a value that saturates at INT_MAX, like
+    // PatternFormatter::addDigit()
+    static consteval int readNumber(const char *in, std::size_t length, std::size_t &i)
+    {
+        int value = 0;
+        for (; i < length && isDigit(in[i]); ++i)
+        {
+            const int digit = in[i] - '0';
+            value = value > (INT_MAX - digit) / 10 ? INT_MAX : value * 10 + digit;
+        }
+        return value;
+    }
+
+    // Follows PatternFormatter::parse()
+    static consteval Parsed parse()
+    {
+        Parsed parsed;
+        const char *in = Pattern.value;
+        const std::size_t length = Capacity - 1;
+        std::size_t literalBegin = 0;
+        const auto addStep = [&parsed](const Step &step) {
+            parsed.steps[parsed.stepCount++] = step;
+        };
+
+        for (std::size_t i = 0; i < length; ++i)
+        {
+            if (in[i] != '%')
+            {
+                parsed.text[parsed.textSize++] = in[i];
+                continue;
+            }
+            if (++i == length)
+                invalidPattern("unexpected end of pattern after '%'");
+            if (in[i] == '%' || in[i] == 'n')
+            {
+                // AbstractLayout::endOfLine()
+                parsed.text[parsed.textSize++] = in[i] == 'n' ? '\n' : '%';
+                continue;
+            }
+
+            if (parsed.textSize > literalBegin)
+                addStep(Step{Op::Literal, FormattingInfo(), literalBegin, parsed.textSize - literalBegin, 0});
+
+            Step step;
+            for (; i < length && in[i] == '-'; ++i)
+                step.formattingInfo.mLeftAligned = true;
+            if (i < length && isDigit(in[i]))
+                step.formattingInfo.mMinLength = readNumber(in, length, i);
+            if (i < length && in[i] == '.')
+            {
+                if (++i == length || !isDigit(in[i]))
+                    invalidPattern("digit expected after '.'");
+                step.formattingInfo.mMaxLength = readNumber(in, length, i);
+            }
+            if (i == length)
+                invalidPattern("unexpected end of pattern in a conversion");
+
+            const char character = in[i];
+            std::size_t optionBegin = i + 1;
+            std::size_t optionEnd = optionBegin;
+            if ((character == 'c' || character == 'd' || character == 'X' || character == 'P')
+                && i + 1 < length && in[i + 1] == '{')
+            {
+                optionBegin = i + 2;
+                optionEnd = optionBegin;
+                while (optionEnd < length && in[optionEnd] != '}')
+                    ++optionEnd;
+                if (optionEnd == length)
+                    invalidPattern("unterminated '{' option");
+                i = optionEnd;
+            }
+            const auto storeOption = [&] {
+                step.begin = parsed.textSize;
+                for (std::size_t k = optionBegin; k < optionEnd; ++k)
+                    parsed.text[parsed.textSize++] = in[k];
+                step.size = parsed.textSize - step.begin;
+            };
+
+            switch (character)
+            {
+            case 'C':
+                // Ignored, as by PatternFormatter
+                literalBegin = parsed.textSize;
+                continue;
+            case 'c':
+            {
+                std::size_t k = optionBegin;
+                step.precision = readNumber(in, optionEnd, k);
+                if (k != optionEnd)
+                    invalidPattern("the option of %c must be a positive integer");
+                step.op = Op::LoggerName;
+                break;
+            }
+            case 'd':
+                storeOption();
+                step.op = Op::Date;
+                break;
+            case 'r':
+                step.op = Op::Relative;
+                break;
+            case 'm':
+                step.op = Op::Message;
+                break;
+            case 'p':
+                step.op = Op::LevelName;
+                break;
+            case 't':
+                step.op = Op::Thread;
+                break;
+            case 'x':
+                step.op = Op::Ndc;
+                break;
+            case 'X':
+                if (optionEnd == optionBegin)
+                    invalidPattern("%X needs a key, use PatternLayout to write the whole MDC");
+                storeOption();
+                step.op = Op::Mdc;
+                break;
+            case 'P':
+                invalidPattern("%P is not supported, use PatternLayout");
+                break;
+            case 'F':
+                step.op = Op::Filename;
+                parsed.requiresLocation = true;
+                break;
+            case 'M':
+                step.op = Op::FunctionName;
+                parsed.requiresLocation = true;
+                break;
+            case 'L':
+                step.op = Op::LineNumber;
+                parsed.requiresLocation = true;
+                break;
+            case 'l':
+                step.op = Op::Location;
+                parsed.requiresLocation = true;
+                break;
+            default:
+                invalidPattern("invalid conversion character");
+            }
+            addStep(step);
+            literalBegin = parsed.textSize;
+        }
+
+        if (parsed.textSize > literalBegin)
+            addStep(Step{Op::Literal, FormattingInfo(), literalBegin, parsed.textSize - literalBegin, 0});
+        return parsed;
+    }
+
+    static constexpr Parsed parsed = parse();
+    static constexpr std::size_t StepCount = parsed.stepCount;
+
+public:
+    explicit StaticPatternLayout(QObject *parent = nullptr) :
+        AbstractStringLayout(parent)
+    {
+        const qint64 now = QDateTime::currentMSecsSinceEpoch();
+        for (std::size_t i = 0; i < StepCount; ++i)
+        {
+            const Step &step = parsed.steps[i];
+            const QString option = QString::fromUtf8(parsed.text.data() + step.begin,
+                                                     static_cast<qsizetype>(step.size));
+            if (step.op == Op::Mdc)
+                mMdcKeys[i] = option;
+            if (step.op != Op::Date && step.op != Op::Relative)
+                continue;
+            mDateFormatters[i] = std::make_unique<const DateTimeFormatter>(
+                step.op == Op::Date ? PatternFormatter::dateFormat(option) : QStringLiteral("RELATIVE"));
+            QByteArray sample;
+            mDateFormatters[i]->formatTo(now, sample);
+            mDateSizes[i] = sample.size();
+        }
+    }
+
+private:
+    Q_DISABLE_COPY_MOVE(StaticPatternLayout)
+
+public:
+    /*!
+     * Returns the conversion pattern of the layout.
+     */
+    [[nodiscard]] static QString conversionPattern()
+    {
+        return QString::fromUtf8(Pattern.value, static_cast<qsizetype>(Capacity - 1));
+    }
+
+    /*!
+     * Creates a StaticPatternLayout on the heap, as a Factory::LayoutFactoryFunc.
+     */
+    static AbstractLayout *create()
+    {
+        return new StaticPatternLayout;
+    }
+
+    /*!
+     * Registers the layout with the Factory as \a layoutClassName, so that
+     * configurations can refer to it by that name.
+     *
+     * \sa Factory::registerLayout()
+     */
+    static void registerLayout(const QString &layoutClassName)
+    {
+        Factory::registerLayout(layoutClassName, &create);
+    }
+
+    [[nodiscard]] QString format(const LoggingEvent &event) override
+    {
+        QByteArray utf8;
+        formatTo(event, utf8);
+        return QString::fromUtf8(utf8);
+    }
+
+    void formatTo(const LoggingEvent &event, QByteArray &dest) override
+    {
+        [&]<std::size_t ...I>(std::index_sequence<I...>) {
+            const qsizetype needed = dest.size() + (qsizetype(0) + ... + sizeOf<I>(event));
+            if (needed > dest.capacity())
+                dest.reserve((std::max)(needed, 2 * dest.capacity()));
+            (write<I>(event, dest), ...);
+        }(std::make_index_sequence<StepCount>());
+    }
+
+    /*!
+     * Returns true if the pattern contains at least one location-sensitive
+     * conversion character (\c %F, \c %L, \c %M, \c %l).
+     */
+    [[nodiscard]] bool requiresLocation() const override
+    {
+        return parsed.requiresLocation;
+    }
+
+private:
+    template<std::size_t I>
+    static constexpr bool isPlain()
+    {
+        return parsed.steps[I].formattingInfo.mMinLength == 0
+               && parsed.steps[I].formattingInfo.mMaxLength == INT_MAX;
+    }
+
+    // An estimate of the bytes step I writes. Fields that need a lookup or a
+    // scan to measure (logger name, MDC value, call site) only count their
+    // minimum width; they are measured again when written.
+    template<std::size_t I>
+    qsizetype sizeOf(const LoggingEvent &event) const
+    {
+        constexpr Step step = parsed.steps[I];
+        qsizetype size = 0;
+        if constexpr (step.op == Op::Literal)
+            return static_cast<qsizetype>(step.size);
+        else if constexpr (step.op == Op::Message)
+            size = event.message().size();
+        else if constexpr (step.op == Op::Ndc)
+            size = event.ndc().size();
+        else if constexpr (step.op == Op::LevelName)
+            size = PatternFormatter::levelName(event.level()).size();
+        else if constexpr (step.op == Op::Thread)
+            size = event.threadName().size();
+        else if constexpr (step.op == Op::Date || step.op == Op::Relative)
+            size = mDateSizes[I];
+        else if constexpr (step.op == Op::LineNumber)
+            size = 11;
+        return (std::max)(size, qsizetype(step.formattingInfo.mMinLength));
+    }
+
+    template<std::size_t I>
+    void write(const LoggingEvent &event, QByteArray &dest) const
+    {
+        constexpr Step step = parsed.steps[I];
+        constexpr FormattingInfo formattingInfo = step.formattingInfo;
+        if constexpr (step.op == Op::Literal)
+            dest.append(parsed.text.data() + step.begin, static_cast<qsizetype>(step.size));
+        else if constexpr (step.op == Op::Message)
+            PatternFormatter::appendFormatted(dest, event.message(), formattingInfo);
+        else if constexpr (step.op == Op::Ndc)
+            PatternFormatter::appendFormatted(dest, event.ndc(), formattingInfo);
+        else if constexpr (step.op == Op::LevelName)
+            append<I>(dest, PatternFormatter::levelName(event.level()));
+        else if constexpr (step.op == Op::Thread)
+            PatternFormatter::appendFormatted(dest, event.threadName(), formattingInfo);
+        else if constexpr (step.op == Op::LoggerName)
+            PatternFormatter::appendLoggerName(dest, event, step.precision, formattingInfo);
+        else if constexpr (step.op == Op::Mdc)
+            PatternFormatter::appendFormatted(dest, event.property(mMdcKeys[I]), formattingInfo);
+        else if constexpr ((step.op == Op::Date || step.op == Op::Relative) && isPlain<I>())
+            mDateFormatters[I]->formatTo(event.timeStamp(), dest);
+        else if constexpr (step.op == Op::Date || step.op == Op::Relative)
+            PatternFormatter::appendFormatted(dest, mDateFormatters[I]->format(event.timeStamp()), formattingInfo);
+        else if constexpr (step.op == Op::Filename)
+            append<I>(dest, PatternFormatter::fileName(event.context()));
+        else if constexpr (step.op == Op::FunctionName)
+            append<I>(dest, PatternFormatter::functionName(event.context()));
+        else if constexpr (step.op == Op::LineNumber)
+            PatternFormatter::appendLineNumber(dest, event.context(), formattingInfo);
+        else if constexpr (step.op == Op::Location)
+            PatternFormatter::appendLocation(dest, event.context(), formattingInfo);
+    }
+
+    template<std::size_t I>
+    static void append(QByteArray &dest, QByteArrayView utf8)
+    {
+        if constexpr (isPlain<I>())
+            dest.append(utf8);
+        else
+            PatternFormatter::appendFormatted(dest, utf8, parsed.steps[I].formattingInfo);
+    }
+
+private:
+    // Indexed by step; only the entries of Date and Relative, and of Mdc
+    // steps are used
+    std::array<std::unique_ptr<const DateTimeFormatter>, StepCount> mDateFormatters;
+    std::array<qsizetype, StepCount> mDateSizes {};
+    std::array<QString, StepCount> mMdcKeys;
+};
+
+} // namespace Log4Qt
+
+#endif // LOG4QT_STATICPATTERNLAYOUT_H
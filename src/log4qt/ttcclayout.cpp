@@ -92,6 +92,13 @@ QString TTCCLayout::format(const LoggingEvent &event)
     return mPatternFormatter->format(event);
 }
 
+void TTCCLayout::formatTo(const LoggingEvent &event, QByteArray &dest)
+{
+    Q_ASSERT_X(mPatternFormatter, "TTCCLayout::formatTo()", "mpPatternConverter must not be null");
+
+    mPatternFormatter->formatTo(event, dest);
+}
+
 
 void TTCCLayout::updatePatternFormatter()
 {
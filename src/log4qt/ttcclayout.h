@@ -160,6 +160,11 @@ public:
     }
     virtual QString format(const LoggingEvent &event) override;
 
+    /*!
+     * Writes the event as UTF-8 through PatternFormatter::formatTo().
+     */
+    void formatTo(const LoggingEvent &event, QByteArray &dest) override;
+
 private:
     void updatePatternFormatter();
 
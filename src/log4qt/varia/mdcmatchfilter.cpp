@@ -0,0 +1,118 @@
+/******************************************************************************
+ *
+ * This file is part of Log4Qt library.
+ *
+ * Copyright (C) 2007 - 2026 Log4Qt contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+#include "varia/mdcmatchfilter.h"
+
+#include "helpers/logerror.h"
+#include "logger.h"
+#include "loggingevent.h"
+#include "varia/multistringmatchfilter.h"
+
+#include <memory>
+
+namespace Log4Qt
+{
+
+LOG4QT_DECLARE_STATIC_LOGGER(logger, Log4Qt::MdcMatchFilter)
+
+MdcMatchFilter::MdcMatchFilter(QObject *parent) :
+    Filter(parent)
+{}
+
+MdcMatchFilter::~MdcMatchFilter() = default;
+
+QList<MdcMatchFilter::Predicate> MdcMatchFilter::predicateList() const
+{
+    const auto predicates = mPredicates.load();
+    return predicates ? *predicates : QList<Predicate>();
+}
+
+void MdcMatchFilter::addPredicate(const QString &key, const QString &value)
+{
+    auto predicates = std::make_shared<QList<Predicate>>(predicateList());
+    predicates->append(Predicate(key, value));
+    mPredicates.store(std::move(predicates));
+}
+
+void MdcMatchFilter::clearPredicates()
+{
+    mPredicates.store(nullptr);
+}
+
+QString MdcMatchFilter::predicates() const
+{
+    QStringList entries;
+    for (const auto &predicate : predicateList())
+        entries << predicate.first + QLatin1Char('=') + predicate.second;
+    return MultiStringMatchFilter::joinStrings(entries);
+}
+
+void MdcMatchFilter::setPredicates(const QString &predicates)
+{
+    auto list = std::make_shared<QList<Predicate>>();
+    for (const auto &entry : MultiStringMatchFilter::splitStrings(predicates))
+    {
+        const auto separator = entry.indexOf(QLatin1Char('='));
+        const QString key = separator < 0 ? QString() : entry.left(separator).trimmed();
+        if (key.isEmpty())
+        {
+            LogError e = LOG4QT_QCLASS_ERROR("Invalid predicate '%1', expected key=value",
+                                             ConfiguratorInvalidOptionError);
+            e << entry;
+            logger()->error(e);
+            continue;
+        }
+        list->append(Predicate(key, entry.mid(separator + 1)));
+    }
+    if (list->isEmpty())
+        mPredicates.store(nullptr);
+    else
+        mPredicates.store(std::move(list));
+}
+
+Filter::Decision MdcMatchFilter::decide(const LoggingEvent &event) const
+{
+    const auto predicates = mPredicates.load();
+    if (!predicates)
+        return Filter::Neutral;
+
+    const bool matchAll = mMatchAll;
+    bool match = matchAll;
+    for (const auto &predicate : *predicates)
+    {
+        if ((event.property(predicate.first) == predicate.second) != matchAll)
+        {
+            match = !matchAll;
+            break;
+        }
+    }
+
+    if (!match)
+        return Filter::Neutral;
+
+    if (mAcceptOnMatch)
+        return Filter::Accept;
+
+    return Filter::Deny;
+}
+
+} // namespace Log4Qt
+
+#include "moc_mdcmatchfilter.cpp"
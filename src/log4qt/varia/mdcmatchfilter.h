@@ -0,0 +1,119 @@
+/******************************************************************************
+ *
+ * This file is part of Log4Qt library.
+ *
+ * Copyright (C) 2007 - 2026 Log4Qt contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+#ifndef LOG4QT_MDCMATCHFILTER_H
+#define LOG4QT_MDCMATCHFILTER_H
+
+#include "log4qt/spi/filter.h"
+#include "log4qt/helpers/atomicsharedptr.h"
+
+#include <QList>
+#include <QPair>
+
+namespace Log4Qt
+{
+
+/*!
+ * \brief The class MdcMatchFilter matches key=value predicates against the
+ *        MDC of logging events.
+ *
+ * Each predicate compares the MDC value stored under a key with an expected
+ * value. With \l matchAll set, all predicates must hold for an event to
+ * match, otherwise any one of them is enough. The values are looked up one
+ * key at a time with LoggingEvent::property(), so the MDC of the event is
+ * never copied. Values are compared case-sensitively; an empty expected
+ * value also matches an event that does not carry the key.
+ *
+ * The decision is Accept on a match if \l acceptOnMatch is true, otherwise
+ * Deny. Events that do not match get Neutral, as do all events while no
+ * predicate is set.
+ *
+ * In configuration files the predicates are set through the \l predicates
+ * property as one value of "key=value" entries separated by '|', escaped as
+ * for MultiStringMatchFilter. The key ends at the first '='.
+ *
+ * \note The ownership and lifetime of objects of this class are managed.
+ *       See  \ref Ownership "Object ownership" for more details.
+ *
+ * \sa RegexFilter, MultiStringMatchFilter::splitStrings()
+ */
+class LOG4QT_EXPORT MdcMatchFilter : public Filter
+{
+    Q_OBJECT
+
+    /*!
+     * The property holds the "key=value" predicates, separated by '|'.
+     *
+     * \sa predicates(), setPredicates()
+     */
+    Q_PROPERTY(QString predicates READ predicates WRITE setPredicates)
+
+    /*!
+     * The property holds if all predicates must hold for an event to match.
+     * If false, one is enough.
+     *
+     * The default is true.
+     *
+     * \sa matchAll(), setMatchAll()
+     */
+    Q_PROPERTY(bool matchAll READ matchAll WRITE setMatchAll)
+
+    /*!
+     * The property holds if an event is accepted on a match.
+     *
+     * The default is true.
+     *
+     * \sa acceptOnMatch(), setAcceptOnMatch()
+     */
+    Q_PROPERTY(bool acceptOnMatch READ acceptOnMatch WRITE setAcceptOnMatch)
+
+public:
+    using Predicate = QPair<QString, QString>;
+
+    MdcMatchFilter(QObject *parent = nullptr);
+    ~MdcMatchFilter() override;
+
+    [[nodiscard]] QList<Predicate> predicateList() const;
+    void addPredicate(const QString &key, const QString &value);
+    void clearPredicates();
+
+    [[nodiscard]] QString predicates() const;
+    void setPredicates(const QString &predicates);
+
+    [[nodiscard]] bool matchAll() const { return mMatchAll; }
+    void setMatchAll(bool all) { mMatchAll = all; }
+
+    [[nodiscard]] bool acceptOnMatch() const { return mAcceptOnMatch; }
+    void setAcceptOnMatch(bool accept) { mAcceptOnMatch = accept; }
+
+    Decision decide(const LoggingEvent &event) const override;
+
+private:
+    Q_DISABLE_COPY_MOVE(MdcMatchFilter)
+
+    bool mMatchAll = true;
+    bool mAcceptOnMatch = true;
+    // Replaced as a whole by every setter
+    AtomicSharedPtr<const QList<Predicate>> mPredicates;
+};
+
+} // namespace Log4Qt
+
+#endif // LOG4QT_MDCMATCHFILTER_H
@@ -0,0 +1,291 @@
+/******************************************************************************
+ *
+ * This file is part of Log4Qt library.
+ *
+ * Copyright (C) 2007 - 2026 Log4Qt contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+#include "varia/multistringmatchfilter.h"
+
+#include "loggingevent.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <vector>
+
+namespace Log4Qt
+{
+
+/*
+ * Aho-Corasick automaton over UTF-16 code units.
+ *
+ * Every state stores its failure link and the union of the match flags of
+ * all strings ending in it or in any state on its failure chain, so a scan
+ * only ever looks at the current state. Transitions are kept sorted in one
+ * flat array; the root additionally has a direct table for Latin-1, where
+ * most scans spend their time.
+ */
+class MultiStringMatchFilter::Automaton
+{
+public:
+    enum Flag : std::uint8_t
+    {
+        DenyFlag = 1,
+        AcceptFlag = 2
+    };
+
+    Automaton(const QStringList &denyStrings, const QStringList &acceptStrings, Qt::CaseSensitivity cs)
+        : mCaseSensitivity(cs)
+    {
+        // Build a trie with std::map children, then flatten it.
+        std::vector<std::map<char16_t, int>> children(1);
+        std::vector<std::uint8_t> flags(1, 0);
+        auto insert = [&](const QString &string, std::uint8_t flag)
+        {
+            int state = 0;
+            for (const QChar c : string)
+            {
+                const char16_t unit = fold(c.unicode());
+                const auto it = children[state].find(unit);
+                if (it != children[state].end())
+                {
+                    state = it->second;
+                    continue;
+                }
+                const int next = static_cast<int>(children.size());
+                children[state].emplace(unit, next);
+                children.emplace_back();
+                flags.push_back(0);
+                state = next;
+            }
+            flags[state] |= flag;
+        };
+        for (const auto &string : denyStrings)
+            insert(string, DenyFlag);
+        for (const auto &string : acceptStrings)
+            insert(string, AcceptFlag);
+
+        mStates.resize(children.size());
+        for (std::size_t s = 0; s < children.size(); ++s)
+        {
+            mStates[s].firstEdge = static_cast<int>(mEdges.size());
+            for (const auto &[unit, target] : children[s])
+                mEdges.push_back({unit, target});
+            mStates[s].lastEdge = static_cast<int>(mEdges.size());
+            mStates[s].flags = flags[s];
+        }
+
+        // Failure links in breadth-first order, so the failure target of a
+        // state is complete before the state itself is processed.
+        std::vector<int> queue;
+        queue.reserve(mStates.size());
+        for (const auto &child : children[0])
+            queue.push_back(child.second);
+        for (std::size_t i = 0; i < queue.size(); ++i)
+        {
+            const int state = queue[i];
+            for (const auto &[unit, target] : children[state])
+            {
+                int fail = mStates[state].fail;
+                int next = transition(fail, unit);
+                while (next < 0 && fail != 0)
+                {
+                    fail = mStates[fail].fail;
+                    next = transition(fail, unit);
+                }
+                mStates[target].fail = next < 0 ? 0 : next;
+                mStates[target].flags |= mStates[mStates[target].fail].flags;
+                queue.push_back(target);
+            }
+        }
+
+        std::fill(std::begin(mRootLatin1), std::end(mRootLatin1), 0);
+        for (int e = mStates[0].firstEdge; e < mStates[0].lastEdge; ++e)
+        {
+            if (mEdges[e].unit < 256)
+                mRootLatin1[mEdges[e].unit] = mEdges[e].target;
+        }
+        mHasDenyStrings = std::any_of(flags.begin(), flags.end(),
+                                      [](std::uint8_t flag) { return (flag & DenyFlag) != 0; });
+    }
+
+    [[nodiscard]] bool isEmpty() const { return mStates.size() <= 1; }
+
+    [[nodiscard]] Decision decide(QStringView text) const
+    {
+        std::uint8_t found = 0;
+        int state = 0;
+        for (const QChar c : text)
+        {
+            const char16_t unit = fold(c.unicode());
+            state = step(state, unit);
+            found |= mStates[state].flags;
+            if ((found & DenyFlag) != 0)
+                return Filter::Deny;
+            // With no deny strings the first accept string settles it
+            if (found != 0 && !mHasDenyStrings)
+                break;
+        }
+        return found != 0 ? Filter::Accept : Filter::Neutral;
+    }
+
+private:
+    struct State
+    {
+        int fail = 0;
+        int firstEdge = 0;
+        int lastEdge = 0;
+        std::uint8_t flags = 0;
+    };
+
+    struct Edge
+    {
+        char16_t unit;
+        int target;
+    };
+
+    [[nodiscard]] char16_t fold(char16_t unit) const
+    {
+        if (mCaseSensitivity == Qt::CaseSensitive)
+            return unit;
+        return static_cast<char16_t>(QChar::toCaseFolded(char32_t(unit)));
+    }
+
+    // The target of the goto edge of state for unit, or -1
+    [[nodiscard]] int transition(int state, char16_t unit) const
+    {
+        const auto first = mEdges.begin() + mStates[state].firstEdge;
+        const auto last = mEdges.begin() + mStates[state].lastEdge;
+        const auto it = std::lower_bound(first, last, unit,
+                                         [](const Edge &edge, char16_t u) { return edge.unit < u; });
+        return it != last && it->unit == unit ? it->target : -1;
+    }
+
+    [[nodiscard]] int step(int state, char16_t unit) const
+    {
+        while (state != 0)
+        {
+            const int next = transition(state, unit);
+            if (next >= 0)
+                return next;
+            state = mStates[state].fail;
+        }
+        if (unit < 256)
+            return mRootLatin1[unit];
+        const int next = transition(0, unit);
+        return next < 0 ? 0 : next;
+    }
+
+    Qt::CaseSensitivity mCaseSensitivity;
+    bool mHasDenyStrings = false;
+    std::vector<State> mStates;
+    std::vector<Edge> mEdges;
+    int mRootLatin1[256];
+};
+
+MultiStringMatchFilter::MultiStringMatchFilter(QObject *parent) :
+    Filter(parent)
+{}
+
+MultiStringMatchFilter::~MultiStringMatchFilter() = default;
+
+void MultiStringMatchFilter::setDenyStringList(const QStringList &strings)
+{
+    mDenyStrings = strings;
+    mDenyStrings.removeAll(QString());
+    compile();
+}
+
+void MultiStringMatchFilter::setAcceptStringList(const QStringList &strings)
+{
+    mAcceptStrings = strings;
+    mAcceptStrings.removeAll(QString());
+    compile();
+}
+
+void MultiStringMatchFilter::setCaseSensitivity(Qt::CaseSensitivity cs)
+{
+    mCaseSensitivity = cs;
+    compile();
+}
+
+Filter::Decision MultiStringMatchFilter::decide(const LoggingEvent &event) const
+{
+    const auto automaton = mAutomaton.load();
+    if (!automaton)
+        return Filter::Neutral;
+
+    const QString message = event.message();
+    return automaton->decide(message);
+}
+
+QStringList MultiStringMatchFilter::splitStrings(const QString &strings)
+{
+    QStringList result;
+    QString current;
+    for (qsizetype i = 0; i < strings.size(); ++i)
+    {
+        const QChar c = strings.at(i);
+        if (c == QLatin1Char('\\') && i + 1 < strings.size()
+            && (strings.at(i + 1) == QLatin1Char('|') || strings.at(i + 1) == QLatin1Char('\\')))
+        {
+            current += strings.at(++i);
+        }
+        else if (c == QLatin1Char('|'))
+        {
+            if (!current.isEmpty())
+                result << current;
+            current.clear();
+        }
+        else
+        {
+            current += c;
+        }
+    }
+    if (!current.isEmpty())
+        result << current;
+    return result;
+}
+
+QString MultiStringMatchFilter::joinStrings(const QStringList &strings)
+{
+    QString result;
+    for (const auto &string : strings)
+    {
+        if (!result.isEmpty())
+            result += QLatin1Char('|');
+        for (const QChar c : string)
+        {
+            if (c == QLatin1Char('|') || c == QLatin1Char('\\'))
+                result += QLatin1Char('\\');
+            result += c;
+        }
+    }
+    return result;
+}
+
+void MultiStringMatchFilter::compile()
+{
+    auto automaton = std::make_shared<const Automaton>(mDenyStrings, mAcceptStrings, mCaseSensitivity);
+    mAutomaton.store(automaton->isEmpty() ? nullptr : std::move(automaton));
+}
+
+} // namespace Log4Qt
+
+#include "moc_multistringmatchfilter.cpp"
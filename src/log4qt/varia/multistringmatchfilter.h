@@ -0,0 +1,132 @@
+/******************************************************************************
+ *
+ * This file is part of Log4Qt library.
+ *
+ * Copyright (C) 2007 - 2026 Log4Qt contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+#ifndef LOG4QT_MULTISTRINGMATCHFILTER_H
+#define LOG4QT_MULTISTRINGMATCHFILTER_H
+
+#include "log4qt/spi/filter.h"
+#include "log4qt/helpers/atomicsharedptr.h"
+
+#include <QStringList>
+
+namespace Log4Qt
+{
+
+/*!
+ * \brief The class MultiStringMatchFilter matches a set of substrings
+ *        against the message of logging events in a single pass.
+ *
+ * The filter replaces a chain of StringMatchFilter objects. Each string is
+ * either a deny or an accept string. All strings are compiled into one
+ * Aho-Corasick automaton, so the message is scanned once no matter how many
+ * strings are configured.
+ *
+ * The decision is:
+ * \li Deny, if the message contains any deny string,
+ * \li otherwise Accept, if it contains any accept string,
+ * \li otherwise Neutral.
+ *
+ * In configuration files the strings are set through the \l denyStrings and
+ * \l acceptStrings properties as one value, with the strings separated by
+ * '|'. A literal '|' or '\\' inside a string is written as "\|" or "\\\\".
+ *
+ * Case-insensitive matching folds each UTF-16 code unit with
+ * QChar::toCaseFolded().
+ *
+ * \note The ownership and lifetime of objects of this class are managed.
+ *       See  \ref Ownership "Object ownership" for more details.
+ *
+ * \sa StringMatchFilter
+ */
+class LOG4QT_EXPORT MultiStringMatchFilter : public Filter
+{
+    Q_OBJECT
+
+    /*!
+     * The property holds the strings that deny an event, separated by '|'.
+     *
+     * \sa denyStrings(), setDenyStrings()
+     */
+    Q_PROPERTY(QString denyStrings READ denyStrings WRITE setDenyStrings)
+
+    /*!
+     * The property holds the strings that accept an event, separated by '|'.
+     *
+     * \sa acceptStrings(), setAcceptStrings()
+     */
+    Q_PROPERTY(QString acceptStrings READ acceptStrings WRITE setAcceptStrings)
+
+    /*!
+     * The property holds the case sensitivity used to match the strings.
+     *
+     * The default is Qt::CaseSensitive.
+     *
+     * \sa caseSensitivity(), setCaseSensitivity()
+     */
+    Q_PROPERTY(Qt::CaseSensitivity caseSensitivity READ caseSensitivity WRITE setCaseSensitivity)
+
+public:
+    MultiStringMatchFilter(QObject *parent = nullptr);
+    ~MultiStringMatchFilter() override;
+
+    [[nodiscard]] QStringList denyStringList() const { return mDenyStrings; }
+    [[nodiscard]] QStringList acceptStringList() const { return mAcceptStrings; }
+    void setDenyStringList(const QStringList &strings);
+    void setAcceptStringList(const QStringList &strings);
+
+    [[nodiscard]] QString denyStrings() const { return joinStrings(mDenyStrings); }
+    [[nodiscard]] QString acceptStrings() const { return joinStrings(mAcceptStrings); }
+    void setDenyStrings(const QString &strings) { setDenyStringList(splitStrings(strings)); }
+    void setAcceptStrings(const QString &strings) { setAcceptStringList(splitStrings(strings)); }
+
+    [[nodiscard]] Qt::CaseSensitivity caseSensitivity() const { return mCaseSensitivity; }
+    void setCaseSensitivity(Qt::CaseSensitivity cs);
+
+    Decision decide(const LoggingEvent &event) const override;
+
+    /*!
+     * Splits a '|' separated property value into its strings, resolving the
+     * "\|" and "\\\\" escapes. Empty strings are dropped.
+     */
+    [[nodiscard]] static QStringList splitStrings(const QString &strings);
+
+    /*!
+     * Joins \a strings into a property value, the inverse of splitStrings().
+     */
+    [[nodiscard]] static QString joinStrings(const QStringList &strings);
+
+private:
+    Q_DISABLE_COPY_MOVE(MultiStringMatchFilter)
+
+    void compile();
+
+    class Automaton;
+
+    QStringList mDenyStrings;
+    QStringList mAcceptStrings;
+    Qt::CaseSensitivity mCaseSensitivity = Qt::CaseSensitive;
+    // Rebuilt by every setter and published as a snapshot, so decide() reads
+    // it without a lock; RegexFilter and MdcMatchFilter do the same.
+    AtomicSharedPtr<const Automaton> mAutomaton;
+};
+
+} // namespace Log4Qt
+
+#endif // LOG4QT_MULTISTRINGMATCHFILTER_H
@@ -0,0 +1,158 @@
+/******************************************************************************
+ *
+ * This file is part of Log4Qt library.
+ *
+ * Copyright (C) 2007 - 2026 Log4Qt contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+#include "varia/regexfilter.h"
+
+#include "helpers/logerror.h"
+#include "logger.h"
+#include "loggingevent.h"
+
+#include <QRegularExpression>
+
+#include <memory>
+
+namespace Log4Qt
+{
+
+LOG4QT_DECLARE_STATIC_LOGGER(logger, Log4Qt::RegexFilter)
+
+// Everything decide() needs, published as one snapshot so that a setter
+// never pairs a new expression with an old target.
+struct RegexFilter::Matcher
+{
+    QRegularExpression expression;
+    Target target;
+    QString mdcKey;
+};
+
+RegexFilter::RegexFilter(QObject *parent) :
+    Filter(parent)
+{}
+
+RegexFilter::~RegexFilter() = default;
+
+void RegexFilter::setRegex(const QString &regex)
+{
+    mRegex = regex;
+    compile();
+}
+
+QString RegexFilter::target() const
+{
+    switch (mTarget)
+    {
+    case Target::Logger:    return QStringLiteral("Logger");
+    case Target::Mdc:       return QStringLiteral("MDC:") + mMdcKey;
+    default:                return QStringLiteral("Message");
+    }
+}
+
+void RegexFilter::setTarget(const QString &target)
+{
+    mMdcKey.clear();
+    if (target.compare(u"Logger", Qt::CaseInsensitive) == 0)
+        mTarget = Target::Logger;
+    else if (target.startsWith(u"MDC:", Qt::CaseInsensitive) && !target.mid(4).trimmed().isEmpty())
+    {
+        mTarget = Target::Mdc;
+        mMdcKey = target.mid(4).trimmed();
+    }
+    else
+    {
+        mTarget = Target::Message;
+        if (target.compare(u"Message", Qt::CaseInsensitive) != 0)
+        {
+            LogError e = LOG4QT_QCLASS_ERROR("Invalid target '%1', using Message",
+                                             ConfiguratorInvalidOptionError);
+            e << target;
+            logger()->error(e);
+        }
+    }
+    compile();
+}
+
+void RegexFilter::setCaseSensitivity(Qt::CaseSensitivity cs)
+{
+    mCaseSensitivity = cs;
+    compile();
+}
+
+Filter::Decision RegexFilter::decide(const LoggingEvent &event) const
+{
+    const auto matcher = mMatcher.load();
+    if (!matcher)
+        return Filter::Neutral;
+
+    QString subject;
+    switch (matcher->target)
+    {
+    case Target::Logger:
+        subject = event.loggername();
+        break;
+    case Target::Mdc:
+        subject = event.property(matcher->mdcKey);
+        if (subject.isNull())
+            return Filter::Neutral;
+        break;
+    default:
+        subject = event.message();
+        break;
+    }
+
+    if (!matcher->expression.matchView(subject).hasMatch())
+        return Filter::Neutral;
+
+    if (mAcceptOnMatch)
+        return Filter::Accept;
+
+    return Filter::Deny;
+}
+
+void RegexFilter::compile()
+{
+    if (mRegex.isEmpty())
+    {
+        mMatcher.store(nullptr);
+        return;
+    }
+
+    QRegularExpression::PatternOptions options = QRegularExpression::NoPatternOption;
+    if (mCaseSensitivity == Qt::CaseInsensitive)
+        options |= QRegularExpression::CaseInsensitiveOption;
+    auto matcher = std::make_shared<Matcher>(Matcher{QRegularExpression(mRegex, options), mTarget, mMdcKey});
+    if (!matcher->expression.isValid())
+    {
+        LogError e = LOG4QT_QCLASS_ERROR("Invalid regular expression '%1': %2 at offset %3",
+                                         ConfiguratorInvalidOptionError);
+        e << mRegex << matcher->expression.errorString()
+          << static_cast<int>(matcher->expression.patternErrorOffset());
+        logger()->error(e);
+        mMatcher.store(nullptr);
+        return;
+    }
+    // Compiles the pattern now, and JIT-compiles it where available, instead
+    // of on the first event.
+    matcher->expression.optimize();
+    mMatcher.store(std::move(matcher));
+}
+
+} // namespace Log4Qt
+
+#include "moc_regexfilter.cpp"
@@ -0,0 +1,136 @@
+/******************************************************************************
+ *
+ * This file is part of Log4Qt library.
+ *
+ * Copyright (C) 2007 - 2026 Log4Qt contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+#ifndef LOG4QT_REGEXFILTER_H
+#define LOG4QT_REGEXFILTER_H
+
+#include "log4qt/spi/filter.h"
+#include "log4qt/helpers/atomicsharedptr.h"
+
+namespace Log4Qt
+{
+
+/*!
+ * \brief The class RegexFilter matches a regular expression against the
+ *        message, the logger name or an MDC value of logging events.
+ *
+ * The expression is compiled once, when it is set, and optimized with
+ * QRegularExpression::optimize(), which also JIT-compiles it where the
+ * platform supports it. decide() only runs the compiled matcher.
+ *
+ * The decision is Accept on a match if \l acceptOnMatch is true, otherwise
+ * Deny. Events that do not match, or that do not carry the MDC key the
+ * filter looks at, get Neutral. An invalid expression is reported and
+ * leaves the filter neutral.
+ *
+ * \note The ownership and lifetime of objects of this class are managed.
+ *       See  \ref Ownership "Object ownership" for more details.
+ *
+ * \sa StringMatchFilter, MdcMatchFilter
+ */
+class LOG4QT_EXPORT RegexFilter : public Filter
+{
+    Q_OBJECT
+
+    /*!
+     * The property holds the regular expression, in Perl-compatible syntax.
+     *
+     * \sa regex(), setRegex()
+     */
+    Q_PROPERTY(QString regex READ regex WRITE setRegex)
+
+    /*!
+     * The property holds what the expression is matched against: "Message",
+     * "Logger", or "MDC:<key>" for the value of an MDC entry.
+     *
+     * The default is "Message".
+     *
+     * \sa target(), setTarget()
+     */
+    Q_PROPERTY(QString target READ target WRITE setTarget)
+
+    /*!
+     * The property holds if an event is accepted on a match.
+     *
+     * The default is true.
+     *
+     * \sa acceptOnMatch(), setAcceptOnMatch()
+     */
+    Q_PROPERTY(bool acceptOnMatch READ acceptOnMatch WRITE setAcceptOnMatch)
+
+    /*!
+     * The property holds the case sensitivity used to match the expression.
+     *
+     * The default is Qt::CaseSensitive.
+     *
+     * \sa caseSensitivity(), setCaseSensitivity()
+     */
+    Q_PROPERTY(Qt::CaseSensitivity caseSensitivity READ caseSensitivity WRITE setCaseSensitivity)
+
+public:
+    RegexFilter(QObject *parent = nullptr);
+    ~RegexFilter() override;
+
+    [[nodiscard]] QString regex() const { return mRegex; }
+    void setRegex(const QString &regex);
+
+    [[nodiscard]] QString target() const;
+    void setTarget(const QString &target);
+
+    [[nodiscard]] bool acceptOnMatch() const { return mAcceptOnMatch; }
+    void setAcceptOnMatch(bool accept) { mAcceptOnMatch = accept; }
+
+    [[nodiscard]] Qt::CaseSensitivity caseSensitivity() const { return mCaseSensitivity; }
+    void setCaseSensitivity(Qt::CaseSensitivity cs);
+
+    /*!
+     * Returns true, if a regular expression is set and compiled without
+     * errors.
+     */
+    [[nodiscard]] bool isValid() const { return mMatcher.load() != nullptr; }
+
+    Decision decide(const LoggingEvent &event) const override;
+
+private:
+    Q_DISABLE_COPY_MOVE(RegexFilter)
+
+    void compile();
+
+    enum class Target
+    {
+        Message,
+        Logger,
+        Mdc
+    };
+
+    struct Matcher;
+
+    QString mRegex;
+    Target mTarget = Target::Message;
+    QString mMdcKey;
+    bool mAcceptOnMatch = true;
+    Qt::CaseSensitivity mCaseSensitivity = Qt::CaseSensitive;
+    // Compiled from the members above
+    AtomicSharedPtr<const Matcher> mMatcher;
+};
+
+} // namespace Log4Qt
+
+#endif // LOG4QT_REGEXFILTER_H
@@ -23,6 +23,8 @@
 #include "abstractlayout.h"
 #include "loggingevent.h"
 
+#include <QScopeGuard>
+
 namespace Log4Qt
 {
 
@@ -121,15 +123,14 @@ void WriterAppender::append(const LoggingEvent &event)
 {
     // Called under mObjectGuard by doAppend Phase 5 — read mpLayout directly
     // to avoid an extra recursive-mutex acquisition and a QSharedPointer copy.
-    const LayoutSharedPtr &layoutSnap = layoutSnapshot();
-    if (!layoutSnap)
+    if (!layoutSnapshot())
         return;
 
-    *mWriter << layoutSnap->format(event);
+    *mWriter << formattedText(event);
     if (handleIoErrors())
         return;
 
-    if (immediateFlush())
+    if (flushAfterAppend())
     {
         mWriter->flush();
         if (handleIoErrors())
@@ -137,6 +138,60 @@ void WriterAppender::append(const LoggingEvent &event)
     }
 }
 
+void WriterAppender::appendBatch(std::span<const LoggingEvent *const> events, const LayoutSharedPtr &layout)
+{
+    if (!layout)
+        return;
+
+    // Format and run preAppend() outside the lock, as doAppend() does for
+    // single events.
+    QStringList formatted;
+    formatted.reserve(static_cast<qsizetype>(events.size()));
+    for (const auto *event : events)
+    {
+        preAppend(*event, layout);
+        formatted.append(layout->format(*event));
+    }
+
+    QMutexLocker locker(&mObjectGuard);
+
+    mDeferFlush = true;
+    const auto resetBatchState = qScopeGuard([this] {
+        mPreformatted = nullptr;
+        mDeferFlush = false;
+    });
+
+    for (std::size_t i = 0; i < events.size(); ++i)
+    {
+        // Per event: a rollover in the previous append() may have torn down
+        // the writer.
+        if (!checkEntryConditions())
+            return;
+        mPreformatted = &formatted.at(static_cast<qsizetype>(i));
+        append(*events[i]);
+    }
+    mPreformatted = nullptr;
+
+    if (immediateFlush() && mWriter != nullptr)
+    {
+        mWriter->flush();
+        handleIoErrors();
+    }
+}
+
+QString WriterAppender::formattedText(const LoggingEvent &event) const
+{
+    if (mPreformatted != nullptr)
+        return *mPreformatted;
+    const LayoutSharedPtr &layoutSnap = layoutSnapshot();
+    return layoutSnap ? layoutSnap->format(event) : QString();
+}
+
+bool WriterAppender::flushAfterAppend() const
+{
+    return immediateFlush() && !mDeferFlush;
+}
+
 bool WriterAppender::checkEntryConditions() const
 {
     if (writer() == nullptr)
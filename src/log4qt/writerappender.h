@@ -108,6 +108,18 @@ public:
 protected:
     void append(const LoggingEvent &event) override;
 
+    /*!
+     * Formats all \a events outside \c mObjectGuard, then writes them under
+     * a single lock acquisition and flushes the writer once at the end of
+     * the batch if \l immediateFlush is set.
+     *
+     * Every event still passes through append(), so subclasses that hook
+     * into it (rolling, date checks) see each event; append() picks up the
+     * pre-formatted text instead of formatting again. preAppend() is called
+     * for every event before the lock is taken.
+     */
+    void appendBatch(std::span<const LoggingEvent *const> events, const LayoutSharedPtr &layout) override;
+
     /*!
      * Tests if all entry conditions for using append() in this class are
      * met.
@@ -127,6 +139,21 @@ protected:
      */
     bool checkEntryConditions() const override;
 
+    /*!
+     * Returns the text append() writes for \a event: the text appendBatch()
+     * formatted outside the lock, or else the layout's output. Subclasses
+     * that override append() to write elsewhere use it instead of
+     * formatting themselves. Call with \c mObjectGuard held.
+     */
+    [[nodiscard]] QString formattedText(const LoggingEvent &event) const;
+
+    /*!
+     * Returns true if append() should flush after writing: \l immediateFlush
+     * is set and no appendBatch() defers the flush to the end of the batch.
+     * Call with \c mObjectGuard held.
+     */
+    [[nodiscard]] bool flushAfterAppend() const;
+
     void closeWriter();
 
     virtual bool handleIoErrors() const;
@@ -144,6 +171,10 @@ private:
     QTextStream *mWriter;
     std::atomic<bool> mImmediateFlush;
     mutable bool mSuppressNextFooter = false;
+    // Set by appendBatch() for the duration of one append() call; guarded
+    // by mObjectGuard.
+    const QString *mPreformatted = nullptr;
+    bool mDeferFlush = false;
     void closeInternal();
 };
 
@@ -20,15 +20,136 @@
 
 #include "xmllayout.h"
 
+#include "logger.h"
 #include "loggingevent.h"
 
-#include <QXmlStreamWriter>
+#include <QStringEncoder>
+
+#include <charconv>
+#include <iterator>
 
 using namespace Qt::StringLiterals;
 
 namespace Log4Qt
 {
 
+namespace
+{
+
+// UTF-8 of U+FFFD, written for control characters XML 1.0 cannot represent
+constexpr QByteArrayView replacementCharacter("\xEF\xBF\xBD");
+
+// Returns the entity for an ASCII character of an attribute value, an empty
+// view if it is written as is
+QByteArrayView attributeEscape(char16_t c)
+{
+    switch (c)
+    {
+    case u'<':  return "&lt;";
+    case u'>':  return "&gt;";
+    case u'&':  return "&amp;";
+    case u'"':  return "&quot;";
+    case u'\'': return "&apos;";
+    case u'\t': return "&#9;";
+    case u'\n': return "&#10;";
+    case u'\r': return "&#13;";
+    default:
+        return c < 0x20 ? replacementCharacter : QByteArrayView();
+    }
+}
+
+bool isCDataSpecial(char16_t c)
+{
+    return c == u'>' || (c < 0x20 && c != u'\t' && c != u'\n' && c != u'\r');
+}
+
+// Appends ASCII text, narrowed one code unit per byte
+void appendAscii(QByteArray &dest, const char16_t *begin, const char16_t *end)
+{
+    const qsizetype start = dest.size();
+    dest.resize(start + (end - begin));
+    char *out = dest.data() + start;
+    for (const char16_t *in = begin; in != end; ++in)
+        *out++ = static_cast<char>(*in);
+}
+
+// Appends the run of non-ASCII text starting at \a p, none of which needs
+// escaping, and returns its end
+const char16_t *appendNonAscii(QByteArray &dest, const char16_t *p, const char16_t *end)
+{
+    const char16_t *const begin = p;
+    while (p < end && *p >= 0x80)
+        ++p;
+    const QStringView text(begin, p);
+    QStringEncoder encoder(QStringEncoder::Utf8, QStringEncoder::Flag::Stateless);
+    const qsizetype start = dest.size();
+    dest.resize(start + encoder.requiredSpace(text.size()));
+    const char *out = encoder.appendToBuffer(dest.data() + start, text);
+    dest.truncate(out - dest.constData());
+    return p;
+}
+
+// Appends \a text as the value of a double-quoted attribute
+void appendAttribute(QByteArray &dest, QStringView text)
+{
+    const char16_t *p = text.utf16();
+    const char16_t *const end = p + text.size();
+    while (p < end)
+    {
+        const char16_t *const run = p;
+        while (p < end && *p < 0x80 && attributeEscape(*p).isEmpty())
+            ++p;
+        appendAscii(dest, run, p);
+        if (p == end)
+            break;
+        if (*p >= 0x80)
+            p = appendNonAscii(dest, p, end);
+        else
+            dest.append(attributeEscape(*p++));
+    }
+}
+
+// Appends \a text as the content of a CDATA section. A "]]>" in the text
+// ends the section and opens a new one, as QXmlStreamWriter does.
+void appendCData(QByteArray &dest, QStringView text)
+{
+    const char16_t *const begin = text.utf16();
+    const char16_t *p = begin;
+    const char16_t *const end = p + text.size();
+    while (p < end)
+    {
+        const char16_t *const run = p;
+        while (p < end && *p < 0x80 && !isCDataSpecial(*p))
+            ++p;
+        appendAscii(dest, run, p);
+        if (p == end)
+            break;
+        if (*p >= 0x80)
+            p = appendNonAscii(dest, p, end);
+        else if (*p != u'>')
+        {
+            dest.append(replacementCharacter);
+            ++p;
+        }
+        else
+        {
+            if (p - begin >= 2 && p[-1] == u']' && p[-2] == u']')
+                dest.append("]]><![CDATA[");
+            dest.append('>');
+            ++p;
+        }
+    }
+}
+
+void appendNumber(QByteArray &dest, qint64 value)
+{
+    char digits[24];
+    const auto result = std::to_chars(std::begin(digits), std::end(digits), value);
+    dest.append(digits, result.ptr - digits);
+}
+
+} // namespace
+
 XMLLayout::XMLLayout(QObject *parent)
     : AbstractStringLayout(parent)
 {
@@ -41,42 +162,49 @@ QString XMLLayout::contentType() const
 
 QString XMLLayout::format(const LoggingEvent &event)
 {
-    QString output;
-    QXmlStreamWriter writer(&output);
-
-    writer.writeStartElement(u"log4j:event"_s);
-    writer.writeAttribute(u"logger"_s, event.loggername());
-    writer.writeAttribute(u"timestamp"_s, QString::number(event.timeStamp()));
-    writer.writeAttribute(u"level"_s, event.level().toString());
-    writer.writeAttribute(u"thread"_s, event.threadName());
+    QByteArray utf8;
+    formatTo(event, utf8);
+    return QString::fromUtf8(utf8);
+}
 
-    writer.writeStartElement(u"log4j:message"_s);
-    writer.writeCDATA(event.message());
-    writer.writeEndElement();
+void XMLLayout::formatTo(const LoggingEvent &event, QByteArray &dest)
+{
+    dest.append("<log4j:event logger=\"");
+    if (const Logger *logger = event.logger())
+        appendAttribute(dest, logger->nameView());
+    dest.append("\" timestamp=\"");
+    appendNumber(dest, event.timeStamp());
+    dest.append("\" level=\"");
+    appendAttribute(dest, event.level().toString());
+    dest.append("\" thread=\"");
+    appendAttribute(dest, event.threadName());
+    dest.append("\"><log4j:message><![CDATA[");
+    appendCData(dest, event.message());
+    dest.append("]]></log4j:message>");
 
-    if (!event.ndc().isEmpty())
+    const QString ndc = event.ndc();
+    if (!ndc.isEmpty())
     {
-        writer.writeStartElement(u"log4j:NDC"_s);
-        writer.writeCDATA(event.ndc());
-        writer.writeEndElement();
+        dest.append("<log4j:NDC><![CDATA[");
+        appendCData(dest, ndc);
+        dest.append("]]></log4j:NDC>");
     }
 
-    auto props = event.properties();
-    if (!props.isEmpty())
+    const QHash<QString, QString> properties = event.properties();
+    if (!properties.isEmpty())
     {
-        writer.writeStartElement(u"log4j:properties"_s);
-        for (const auto &[key, value] : props.asKeyValueRange())
+        dest.append("<log4j:properties>");
+        for (const auto &[key, value] : properties.asKeyValueRange())
         {
-            writer.writeStartElement(u"log4j:data"_s);
-            writer.writeAttribute(u"name"_s, key);
-            writer.writeAttribute(u"value"_s, value);
-            writer.writeEndElement();
+            dest.append("<log4j:data name=\"");
+            appendAttribute(dest, key);
+            dest.append("\" value=\"");
+            appendAttribute(dest, value);
+            dest.append("\"/>");
         }
-        writer.writeEndElement();
+        dest.append("</log4j:properties>");
     }
-    writer.writeEndElement();
-
-    return output;
+    dest.append("</log4j:event>");
 }
 
 }
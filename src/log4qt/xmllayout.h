@@ -26,6 +26,17 @@
 namespace Log4Qt
 {
 
+/*!
+ * \brief The class XMLLayout formats a LoggingEvent as a log4j:event element.
+ *
+ * The element is written directly as UTF-8 by formatTo(). Attribute values
+ * are escaped (\c < \c > \c & \c " \c ' and line breaks as character
+ * references), message and NDC go into CDATA sections. Control characters
+ * XML 1.0 cannot represent are replaced by U+FFFD.
+ *
+ * \note The ownership and lifetime of objects of this class are managed. See
+ *       \ref Ownership "Object ownership" for more details.
+ */
 class LOG4QT_EXPORT XMLLayout : public AbstractStringLayout
 {
     Q_OBJECT
@@ -35,6 +46,12 @@ public:
     QString contentType() const override;
     QString format(const LoggingEvent &event) override;
 
+    /*!
+     * Writes the event as UTF-8, without building the QString that
+     * format() returns.
+     */
+    void formatTo(const LoggingEvent &event, QByteArray &dest) override;
+
 private:
     Q_DISABLE_COPY_MOVE(XMLLayout)
 };
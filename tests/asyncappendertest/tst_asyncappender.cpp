@@ -23,6 +23,8 @@
 #include <QThread>
 #include <QElapsedTimer>
 
+#include <algorithm>
+
 #include "log4qt/asyncappender.h"
 #include "log4qt/loggingevent.h"
 #include "log4qt/logger.h"
@@ -30,6 +32,7 @@
 #include "log4qt/propertyconfigurator.h"
 #include "log4qt/varia/listappender.h"
 #include "log4qt/helpers/boundedblockingqueue.h"
+#include "log4qt/helpers/mpscringqueue.h"
 #include "log4qt/helpers/properties.h"
 
 using namespace Log4Qt;
@@ -85,6 +88,83 @@ private:
     QStringList mThreadNames;
 };
 
+// ---------------------------------------------------------------------------
+// BatchRecordingAppender — records the size of every batch it receives and
+// the messages in arrival order. The first batch is held up so the queue
+// fills behind it.
+// ---------------------------------------------------------------------------
+class BatchRecordingAppender : public AppenderSkeleton
+{
+    Q_OBJECT
+public:
+    explicit BatchRecordingAppender(QObject *parent = nullptr)
+        : AppenderSkeleton(parent) {}
+    bool requiresLayout() const override { return false; }
+
+    QList<int> batchSizes() const
+    {
+        QMutexLocker locker(&mObjectGuard);
+        return mBatchSizes;
+    }
+    QStringList messages() const
+    {
+        QMutexLocker locker(&mObjectGuard);
+        return mMessages;
+    }
+protected:
+    void appendBatch(std::span<const LoggingEvent *const> events, const LayoutSharedPtr &layout) override
+    {
+        {
+            QMutexLocker locker(&mObjectGuard);
+            if (mBatchSizes.isEmpty())
+                QThread::msleep(100);
+            mBatchSizes.append(static_cast<int>(events.size()));
+        }
+        AppenderSkeleton::appendBatch(events, layout);
+    }
+    void append(const LoggingEvent &event) override
+    {
+        mMessages.append(event.message());
+    }
+private:
+    QList<int> mBatchSizes;
+    QStringList mMessages;
+};
+
+// ---------------------------------------------------------------------------
+// ShardRecordingAppender — records logger, message and dispatching thread of
+// every event in arrival order
+// ---------------------------------------------------------------------------
+class ShardRecordingAppender : public AppenderSkeleton
+{
+    Q_OBJECT
+public:
+    struct Record
+    {
+        QString logger;
+        QString message;
+        QString thread;
+    };
+
+    explicit ShardRecordingAppender(QObject *parent = nullptr)
+        : AppenderSkeleton(parent) {}
+    bool requiresLayout() const override { return false; }
+
+    QList<Record> records() const
+    {
+        QMutexLocker locker(&mObjectGuard);
+        return mRecords;
+    }
+protected:
+    void append(const LoggingEvent &event) override
+    {
+        mRecords.append({event.loggername(), event.message(),
+                         QThread::currentThread()->objectName()});
+    }
+private:
+    QList<Record> mRecords;
+};
+
 // ===========================================================================
 // Test Class
 // ===========================================================================
@@ -104,12 +184,24 @@ private Q_SLOTS:
     void BoundedBlockingQueue_drain();
     void BoundedBlockingQueue_drainAfterShutdown();
 
+    // MpscRingQueue tests
+    void MpscRingQueue_enqueueDequeue();
+    void MpscRingQueue_capacity();
+    void MpscRingQueue_blockingEnqueue();
+    void MpscRingQueue_shutdown();
+    void MpscRingQueue_multipleProducers();
+
     // AsyncAppender core tests
     void AsyncAppender_defaultProperties();
     void AsyncAppender_basicAsyncLogging();
     void AsyncAppender_multipleAppenders();
     void AsyncAppender_preservesEventData();
     void AsyncAppender_workerThreadName();
+    void AsyncAppender_batchDispatch();
+    void AsyncAppender_batchSizeOne();
+    void AsyncAppender_shardKeyString();
+    void AsyncAppender_shardedPerKeyOrdering();
+    void AsyncAppender_shardedByMdcKey();
 
     // Queue full policy tests
     void AsyncAppender_blockPolicy_nonBlocking();
@@ -117,6 +209,9 @@ private Q_SLOTS:
     void AsyncAppender_discardPolicy_aboveThreshold();
     void AsyncAppender_synchronousPolicy();
     void AsyncAppender_queueFullPolicyString();
+    void AsyncAppender_queueImplementationString();
+    void AsyncAppender_lockFreeQueue();
+    void AsyncAppender_lockFreeQueue_discardPolicy();
 
     // Error appender tests
     void AsyncAppender_errorAppender();
@@ -288,6 +383,136 @@ void AsyncAppenderTest::BoundedBlockingQueue_drainAfterShutdown()
     QCOMPARE(out[1], 20);
 }
 
+// ===========================================================================
+// MpscRingQueue Tests
+// ===========================================================================
+
+void AsyncAppenderTest::MpscRingQueue_enqueueDequeue()
+{
+    MpscRingQueue<int> queue(4);
+
+    QVERIFY(queue.tryEnqueue(10));
+    QVERIFY(queue.tryEnqueue(20));
+    QVERIFY(queue.enqueue(30));
+    QCOMPARE(queue.size(), 3);
+
+    int val = 0;
+    QVERIFY(queue.dequeue(val));
+    QCOMPARE(val, 10);
+    QVERIFY(queue.dequeue(val));
+    QCOMPARE(val, 20);
+    QVERIFY(queue.dequeue(val));
+    QCOMPARE(val, 30);
+
+    QVERIFY(queue.isEmpty());
+}
+
+void AsyncAppenderTest::MpscRingQueue_capacity()
+{
+    MpscRingQueue<int> queue(3);
+
+    // Wrap around the ring several times
+    for (int round = 0; round < 4; ++round)
+    {
+        QVERIFY(queue.tryEnqueue(1));
+        QVERIFY(queue.tryEnqueue(2));
+        QVERIFY(queue.tryEnqueue(3));
+        QCOMPARE(queue.size(), 3);
+        QCOMPARE(queue.capacity(), 3);
+        QVERIFY(!queue.tryEnqueue(4));
+
+        std::vector<int> out;
+        QCOMPARE(queue.drain(out, 10), 3);
+        QCOMPARE(out, (std::vector<int>{1, 2, 3}));
+    }
+
+    // A single slot cannot distinguish full from empty; the ring keeps two
+    MpscRingQueue<int> tiny(1);
+    QCOMPARE(tiny.capacity(), 2);
+}
+
+void AsyncAppenderTest::MpscRingQueue_blockingEnqueue()
+{
+    MpscRingQueue<int> queue(2);
+    queue.tryEnqueue(1);
+    queue.tryEnqueue(2);
+
+    QThread *consumer = QThread::create([&queue]() {
+        QThread::msleep(50);
+        int val = 0;
+        queue.dequeue(val);
+    });
+    consumer->start();
+
+    // Blocks until the consumer frees a slot
+    QVERIFY(queue.enqueue(3));
+
+    consumer->wait();
+    delete consumer;
+    QCOMPARE(queue.size(), 2);
+}
+
+void AsyncAppenderTest::MpscRingQueue_shutdown()
+{
+    MpscRingQueue<int> queue(4);
+
+    bool dequeued = true;
+    QThread *consumer = QThread::create([&queue, &dequeued]() {
+        int val = 0;
+        dequeued = queue.dequeue(val);
+    });
+    consumer->start();
+
+    QThread::msleep(50);
+    queue.shutdown();
+    consumer->wait();
+    delete consumer;
+
+    QVERIFY(!dequeued);
+    QVERIFY(!queue.tryEnqueue(1));
+    QVERIFY(!queue.enqueue(1));
+}
+
+void AsyncAppenderTest::MpscRingQueue_multipleProducers()
+{
+    const int producerCount = 4;
+    const int perProducer = 5000;
+    MpscRingQueue<int> queue(16);
+
+    QList<QThread *> producers;
+    for (int p = 0; p < producerCount; ++p)
+    {
+        producers << QThread::create([&queue, p, perProducer]() {
+            for (int i = 0; i < perProducer; ++i)
+                queue.enqueue(p * perProducer + i);
+        });
+        producers.last()->start();
+    }
+
+    // FIFO per producer, nothing lost or duplicated
+    QList<int> last(producerCount, -1);
+    int total = 0;
+    int outOfOrder = 0;
+    int val = 0;
+    while (total < producerCount * perProducer && queue.dequeue(val))
+    {
+        const int p = val / perProducer;
+        if (val % perProducer != last[p] + 1)
+            ++outOfOrder;
+        last[p] = val % perProducer;
+        ++total;
+    }
+
+    for (auto *producer : std::as_const(producers))
+    {
+        producer->wait();
+        delete producer;
+    }
+    QCOMPARE(total, producerCount * perProducer);
+    QCOMPARE(outOfOrder, 0);
+    QVERIFY(queue.isEmpty());
+}
+
 // ===========================================================================
 // AsyncAppender Core Tests
 // ===========================================================================
@@ -296,6 +521,9 @@ void AsyncAppenderTest::AsyncAppender_defaultProperties()
 {
     AsyncAppender appender;
     QCOMPARE(appender.bufferSize(), 1024);
+    QCOMPARE(appender.batchSize(), 64);
+    QCOMPARE(appender.workerCount(), 1);
+    QCOMPARE(appender.shardKey(), QStringLiteral("Logger"));
     QCOMPARE(appender.blocking(), true);
     QCOMPARE(appender.shutdownTimeout(), 0);
     QCOMPARE(appender.queueFullPolicy(), AsyncAppender::QueueFullPolicy::Block);
@@ -394,6 +622,170 @@ void AsyncAppenderTest::AsyncAppender_workerThreadName()
     QCOMPARE(capture->capturedThreadNames().at(0), QStringLiteral("Log4Qt-Async-MyAsync"));
 }
 
+void AsyncAppenderTest::AsyncAppender_batchDispatch()
+{
+    AsyncAppender async;
+    async.setName(QStringLiteral("TestAsync"));
+    async.setBufferSize(64);
+    async.setBatchSize(16);
+
+    auto *recorder = new BatchRecordingAppender;
+    recorder->setName(QStringLiteral("Recorder"));
+    async.addAppender(AppenderSharedPtr(recorder));
+    async.activateOptions();
+
+    const int count = 40;
+    for (int i = 0; i < count; ++i)
+        async.doAppend(LoggingEvent(test_logger(), Level::INFO_INT,
+                                    QStringLiteral("msg%1").arg(i)));
+
+    async.close();
+
+    // Events queued up behind the delayed first batch arrive together,
+    // never more than batchSize at once, in order and without loss.
+    const auto sizes = recorder->batchSizes();
+    QVERIFY(*std::max_element(sizes.cbegin(), sizes.cend()) > 1);
+    QVERIFY(*std::max_element(sizes.cbegin(), sizes.cend()) <= 16);
+
+    const auto messages = recorder->messages();
+    QCOMPARE(messages.size(), count);
+    for (int i = 0; i < count; ++i)
+        QCOMPARE(messages.at(i), QStringLiteral("msg%1").arg(i));
+}
+
+void AsyncAppenderTest::AsyncAppender_batchSizeOne()
+{
+    AsyncAppender async;
+    async.setName(QStringLiteral("TestAsync"));
+    async.setBatchSize(1);
+
+    auto *recorder = new BatchRecordingAppender;
+    recorder->setName(QStringLiteral("Recorder"));
+    async.addAppender(AppenderSharedPtr(recorder));
+    async.activateOptions();
+
+    for (int i = 0; i < 5; ++i)
+        async.doAppend(LoggingEvent(test_logger(), Level::INFO_INT,
+                                    QStringLiteral("msg%1").arg(i)));
+
+    async.close();
+
+    // Event-by-event dispatch goes through doAppend(), not the batch path
+    QVERIFY(recorder->batchSizes().isEmpty());
+    QCOMPARE(recorder->messages().size(), 5);
+}
+
+void AsyncAppenderTest::AsyncAppender_shardKeyString()
+{
+    AsyncAppender async;
+    async.setShardKey(QStringLiteral("thread"));
+    QCOMPARE(async.shardKey(), QStringLiteral("Thread"));
+
+    async.setShardKey(QStringLiteral("mdc:tenant"));
+    QCOMPARE(async.shardKey(), QStringLiteral("MDC:tenant"));
+
+    // An MDC key is required; unknown values fall back to Logger
+    async.setShardKey(QStringLiteral("MDC:"));
+    QCOMPARE(async.shardKey(), QStringLiteral("Logger"));
+    async.setShardKey(QStringLiteral("invalid"));
+    QCOMPARE(async.shardKey(), QStringLiteral("Logger"));
+
+    async.setWorkerCount(0);
+    QCOMPARE(async.workerCount(), 1);
+}
+
+void AsyncAppenderTest::AsyncAppender_shardedPerKeyOrdering()
+{
+    AsyncAppender async;
+    async.setName(QStringLiteral("Sharded"));
+    async.setBufferSize(16);
+    async.setWorkerCount(4);
+
+    auto *recorder = new ShardRecordingAppender;
+    recorder->setName(QStringLiteral("Recorder"));
+    async.addAppender(AppenderSharedPtr(recorder));
+    async.activateOptions();
+
+    const int loggerCount = 8;
+    const int perLogger = 50;
+    for (int i = 0; i < perLogger; ++i)
+    {
+        for (int l = 0; l < loggerCount; ++l)
+        {
+            const auto *logger = LogManager::logger(QStringLiteral("Test::Shard%1").arg(l));
+            async.doAppend(LoggingEvent(logger, Level::INFO_INT, QString::number(i)));
+        }
+    }
+
+    async.close();
+
+    const auto records = recorder->records();
+    QCOMPARE(records.size(), loggerCount * perLogger);
+
+    // Every logger is served by exactly one worker, in the order it logged
+    QHash<QString, int> nextIndex;
+    QHash<QString, QString> workerOfLogger;
+    for (const auto &record : records)
+    {
+        QVERIFY(record.thread.startsWith(QStringLiteral("Log4Qt-Async-Sharded-")));
+        QCOMPARE(record.message, QString::number(nextIndex.value(record.logger)));
+        nextIndex[record.logger] += 1;
+
+        const auto worker = workerOfLogger.constFind(record.logger);
+        if (worker == workerOfLogger.cend())
+            workerOfLogger.insert(record.logger, record.thread);
+        else
+            QCOMPARE(record.thread, *worker);
+    }
+    QCOMPARE(nextIndex.size(), loggerCount);
+}
+
+void AsyncAppenderTest::AsyncAppender_shardedByMdcKey()
+{
+    AsyncAppender async;
+    async.setName(QStringLiteral("Sharded"));
+    async.setWorkerCount(3);
+    async.setShardKey(QStringLiteral("MDC:tenant"));
+
+    auto *recorder = new ShardRecordingAppender;
+    recorder->setName(QStringLiteral("Recorder"));
+    async.addAppender(AppenderSharedPtr(recorder));
+    async.activateOptions();
+
+    const int tenantCount = 6;
+    const int perTenant = 20;
+    for (int i = 0; i < perTenant; ++i)
+    {
+        for (int t = 0; t < tenantCount; ++t)
+        {
+            LoggingEvent event(test_logger(), Level::INFO_INT,
+                               QStringLiteral("%1:%2").arg(t).arg(i));
+            event.setProperty(QStringLiteral("tenant"), QString::number(t));
+            async.doAppend(event);
+        }
+    }
+
+    async.close();
+
+    const auto records = recorder->records();
+    QCOMPARE(records.size(), tenantCount * perTenant);
+
+    QHash<QString, int> nextIndex;
+    QHash<QString, QString> workerOfTenant;
+    for (const auto &record : records)
+    {
+        const QString tenant = record.message.section(u':', 0, 0);
+        QCOMPARE(record.message.section(u':', 1, 1), QString::number(nextIndex.value(tenant)));
+        nextIndex[tenant] += 1;
+
+        const auto worker = workerOfTenant.constFind(tenant);
+        if (worker == workerOfTenant.cend())
+            workerOfTenant.insert(tenant, record.thread);
+        else
+            QCOMPARE(record.thread, *worker);
+    }
+}
+
 // ===========================================================================
 // Queue Full Policy Tests
 // ===========================================================================
@@ -534,6 +926,79 @@ void AsyncAppenderTest::AsyncAppender_queueFullPolicyString()
     QCOMPARE(async.queueFullPolicy(), AsyncAppender::QueueFullPolicy::Block);
 }
 
+void AsyncAppenderTest::AsyncAppender_queueImplementationString()
+{
+    AsyncAppender async;
+    QCOMPARE(async.queueImplementation(), AsyncAppender::QueueImplementation::Blocking);
+    QCOMPARE(async.queueImplementationString(), QStringLiteral("Blocking"));
+
+    async.setQueueImplementationString(QStringLiteral("lockfree"));
+    QCOMPARE(async.queueImplementation(), AsyncAppender::QueueImplementation::LockFree);
+    QCOMPARE(async.queueImplementationString(), QStringLiteral("LockFree"));
+
+    // Unknown value defaults to Blocking
+    async.setQueueImplementationString(QStringLiteral("invalid"));
+    QCOMPARE(async.queueImplementation(), AsyncAppender::QueueImplementation::Blocking);
+}
+
+void AsyncAppenderTest::AsyncAppender_lockFreeQueue()
+{
+    AsyncAppender async;
+    async.setName(QStringLiteral("TestAsync"));
+    async.setBufferSize(8);
+    async.setQueueImplementation(AsyncAppender::QueueImplementation::LockFree);
+
+    auto *list = new ListAppender;
+    list->setName(QStringLiteral("List"));
+    async.addAppender(AppenderSharedPtr(list));
+    async.activateOptions();
+
+    const int threadCount = 4;
+    const int perThread = 100;
+    QList<QThread *> threads;
+    for (int t = 0; t < threadCount; ++t)
+    {
+        threads << QThread::create([&async, perThread]() {
+            for (int i = 0; i < perThread; ++i)
+                async.doAppend(LoggingEvent(test_logger(), Level::INFO_INT,
+                                            QStringLiteral("msg%1").arg(i)));
+        });
+        threads.last()->start();
+    }
+    for (auto *thread : std::as_const(threads))
+    {
+        thread->wait();
+        delete thread;
+    }
+
+    async.close();
+
+    QCOMPARE(list->list().size(), threadCount * perThread);
+}
+
+void AsyncAppenderTest::AsyncAppender_lockFreeQueue_discardPolicy()
+{
+    AsyncAppender async;
+    async.setName(QStringLiteral("TestAsync"));
+    async.setBufferSize(2);
+    async.setQueueImplementation(AsyncAppender::QueueImplementation::LockFree);
+    async.setQueueFullPolicy(AsyncAppender::QueueFullPolicy::Discard);
+    async.setDiscardThreshold(Level(Level::INFO_INT));
+
+    auto *slow = new SlowAppender(100);
+    slow->setName(QStringLiteral("Slow"));
+    async.addAppender(AppenderSharedPtr(slow));
+    async.activateOptions();
+
+    for (int i = 0; i < 20; ++i)
+        async.doAppend(LoggingEvent(test_logger(), Level::DEBUG_INT,
+                                    QStringLiteral("debug%1").arg(i)));
+
+    async.close();
+
+    QVERIFY(async.discardedCount() > 0);
+}
+
 // ===========================================================================
 // Error Appender Tests
 // ===========================================================================
@@ -0,0 +1,125 @@
+/******************************************************************************
+ *
+ * This file is part of Log4Qt library.
+ *
+ * Copyright (C) 2007 - 2026 Log4Qt contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+// Strip everything below INFO in this translation unit, whatever the build
+// configured for the log4qt target.
+#undef LOG4QT_COMPILE_TIME_MIN_LEVEL
+#define LOG4QT_COMPILE_TIME_MIN_LEVEL LOG4QT_LEVEL_INFO
+
+#include <QTest>
+
+#include "log4qt/logger.h"
+#include "log4qt/logmanager.h"
+#include "log4qt/varia/listappender.h"
+
+using namespace Log4Qt;
+
+LOG4QT_DECLARE_STATIC_LOGGER(logger, Test::CompileTimeLevel)
+
+static_assert(!isCompiledIn(Level::TRACE_INT));
+static_assert(!isCompiledIn(Level::DEBUG_INT));
+static_assert(isCompiledIn(Level::INFO_INT));
+static_assert(isCompiledIn(Level::FATAL_INT));
+
+class CompileTimeLevelTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void init();
+    void cleanup();
+    void strippedMacrosDoNotEvaluateArguments();
+    void strippedMacroKeepsElseBinding();
+    void keptMacrosLog();
+    void strippedTemplatesDoNotLog();
+
+private:
+    static QString countedMessage();
+
+    ListAppender *mAppender = nullptr;
+    static inline int msEvaluations = 0;
+};
+
+QString CompileTimeLevelTest::countedMessage()
+{
+    ++msEvaluations;
+    return QStringLiteral("message");
+}
+
+void CompileTimeLevelTest::init()
+{
+    msEvaluations = 0;
+    mAppender = new ListAppender;
+    logger()->addAppender(AppenderSharedPtr(mAppender));
+    logger()->setLevel(Level::ALL_INT);
+}
+
+void CompileTimeLevelTest::cleanup()
+{
+    LogManager::resetConfiguration();
+    mAppender = nullptr;
+}
+
+void CompileTimeLevelTest::strippedMacrosDoNotEvaluateArguments()
+{
+    l4qTrace(countedMessage());
+    l4qDebug(countedMessage());
+    l4qDebug() << countedMessage();
+
+    QCOMPARE(msEvaluations, 0);
+    QCOMPARE(mAppender->list().size(), 0);
+}
+
+void CompileTimeLevelTest::strippedMacroKeepsElseBinding()
+{
+    bool elseTaken = false;
+    const bool condition = QTest::currentTestFunction() == nullptr;
+    if (condition)
+        l4qDebug(countedMessage());
+    else
+        elseTaken = true;
+
+    QVERIFY(elseTaken);
+    QCOMPARE(msEvaluations, 0);
+}
+
+void CompileTimeLevelTest::keptMacrosLog()
+{
+    l4qInfo(countedMessage());
+    l4qWarn() << countedMessage();
+
+    QCOMPARE(msEvaluations, 2);
+    QCOMPARE(mAppender->list().size(), 2);
+    QCOMPARE(mAppender->list().at(0).level(), Level(Level::INFO_INT));
+    QCOMPARE(mAppender->list().at(1).level(), Level(Level::WARN_INT));
+}
+
+void CompileTimeLevelTest::strippedTemplatesDoNotLog()
+{
+    logger()->debug(QStringLiteral("debug %1"), 1);
+    logger()->trace(QStringLiteral("trace %1"), 2);
+    logger()->info(QStringLiteral("info %1"), 3);
+
+    QCOMPARE(mAppender->list().size(), 1);
+    QCOMPARE(mAppender->list().at(0).message(), QStringLiteral("info 3"));
+}
+
+QTEST_MAIN(CompileTimeLevelTest)
+#include "tst_compiletimelevel.moc"
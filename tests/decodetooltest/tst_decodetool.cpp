@@ -0,0 +1,163 @@
+/******************************************************************************
+ *
+ * This file is part of Log4Qt library.
+ *
+ * Copyright (C) 2007 - 2026 Log4Qt contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+#include <QTest>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QProcess>
+#include <QTemporaryDir>
+
+#include "log4qt/binarylayout.h"
+#include "log4qt/logger.h"
+#include "log4qt/loggingevent.h"
+
+using namespace Log4Qt;
+
+// Runs the log4qt-decode tool built with the library on files written with
+// BinaryLayout
+class DecodeToolTest : public QObject
+{
+    Q_OBJECT
+
+private:
+    struct Result
+    {
+        int exitCode;
+        QByteArray output;
+        QByteArray errors;
+    };
+
+    // Writes the events as RandomAccessFileAppender does, leaving out the
+    // Define records of the first skippedDefinitions dictionary entries
+    QString writeFile(const QString &name, qsizetype skippedDefinitions = 0) const
+    {
+        BinaryLayout layout;
+        QByteArray data;
+        qsizetype written = skippedDefinitions;
+        layout.formatHeaderTo(data, false);
+        for (const LoggingEvent &event : mEvents)
+        {
+            QByteArray record;
+            layout.formatTo(event, record);
+            layout.formatPendingTo(data, written);
+            data += record;
+        }
+
+        const QString fileName = mDirectory.filePath(name);
+        QFile file(fileName);
+        if (!file.open(QIODevice::WriteOnly) || file.write(data) != data.size())
+            return QString();
+        return fileName;
+    }
+
+    static Result decode(const QStringList &arguments)
+    {
+        QProcess process;
+        process.start(QStringLiteral(LOG4QT_DECODE_TOOL), arguments);
+        if (!process.waitForFinished(30000))
+            return {-1, {}, process.errorString().toUtf8()};
+        return {process.exitStatus() == QProcess::NormalExit ? process.exitCode() : -1,
+                process.readAllStandardOutput(), process.readAllStandardError()};
+    }
+
+    static QList<QByteArray> lines(const QByteArray &output)
+    {
+        QList<QByteArray> result;
+        for (const QByteArray &line : output.split('\n'))
+            if (!line.trimmed().isEmpty())
+                result << line.trimmed();
+        return result;
+    }
+
+private slots:
+    void initTestCase()
+    {
+        QVERIFY(mDirectory.isValid());
+        Logger *logger = Logger::logger(QStringLiteral("Decode::Test"));
+        mEvents << LoggingEvent(logger, Level::INFO_INT, QStringLiteral("first"), QString(),
+                                {{QStringLiteral("user"), QStringLiteral("alice")}},
+                                QStringLiteral("main"), Q_INT64_C(1705314600123))
+                << LoggingEvent(logger, Level::WARN_INT, QStringLiteral("second"), QString(), {},
+                                QStringLiteral("main"), Q_INT64_C(1705314600456));
+    }
+
+    void pattern()
+    {
+        const QString file = writeFile(QStringLiteral("pattern.l4qb"));
+        QVERIFY(!file.isEmpty());
+        const Result result = decode({QStringLiteral("--pattern"), QStringLiteral("%p %c [%t] - %m%n"), file});
+        QCOMPARE(result.exitCode, 0);
+        QCOMPARE(lines(result.output),
+                 QList<QByteArray>({"INFO Decode::Test [main] - first", "WARN Decode::Test [main] - second"}));
+    }
+
+    void jsonLines()
+    {
+        const QString file = writeFile(QStringLiteral("json.l4qb"));
+        QVERIFY(!file.isEmpty());
+        const Result result = decode({QStringLiteral("--json"), file});
+        QCOMPARE(result.exitCode, 0);
+        const QList<QByteArray> objects = lines(result.output);
+        QCOMPARE(objects.size(), 2);
+        for (qsizetype i = 0; i < objects.size(); ++i)
+        {
+            QJsonParseError error;
+            const QJsonDocument document = QJsonDocument::fromJson(objects.at(i), &error);
+            QVERIFY2(error.error == QJsonParseError::NoError, qPrintable(error.errorString()));
+            QCOMPARE(document.object().value(QStringLiteral("message")).toString(), mEvents.at(i).message());
+        }
+    }
+
+    void prettyJsonArray()
+    {
+        const QString file = writeFile(QStringLiteral("pretty.l4qb"));
+        QVERIFY(!file.isEmpty());
+        const Result result = decode({QStringLiteral("--json"), QStringLiteral("--pretty"), file});
+        QCOMPARE(result.exitCode, 0);
+        QJsonParseError error;
+        const QJsonDocument document = QJsonDocument::fromJson(result.output, &error);
+        QVERIFY2(error.error == QJsonParseError::NoError, qPrintable(error.errorString()));
+        QVERIFY(document.isArray());
+        QCOMPARE(document.array().size(), 2);
+        QCOMPARE(document.array().at(1).toObject().value(QStringLiteral("level")).toString(), QStringLiteral("WARN"));
+
+        QCOMPARE(decode({QStringLiteral("--pretty"), file}).exitCode, 1);
+    }
+
+    void missingDefinition()
+    {
+        // Without the Define record of the logger name, the first entry
+        const QString file = writeFile(QStringLiteral("missing.l4qb"), 1);
+        QVERIFY(!file.isEmpty());
+        const Result result = decode({QStringLiteral("--pattern"), QStringLiteral("%c [%t] - %m%n"), file});
+        QCOMPARE(result.exitCode, 1);
+        QVERIFY2(result.errors.contains("<unknown #id>"), result.errors.constData());
+        QCOMPARE(lines(result.output),
+                 QList<QByteArray>({"<unknown #1> [main] - first", "<unknown #1> [main] - second"}));
+    }
+
+private:
+    QTemporaryDir mDirectory;
+    QList<LoggingEvent> mEvents;
+};
+
+QTEST_MAIN(DecodeToolTest)
+#include "tst_decodetool.moc"
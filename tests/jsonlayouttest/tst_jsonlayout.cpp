@@ -76,16 +76,23 @@ private Q_SLOTS:
     void format_thread();
     void format_message();
     void format_disableFields();
+    void format_fieldOrder();
+    void format_noFields();
+    void format_escaping_data();
+    void format_escaping();
+    void formatTo_matchesFormat();
 
     void format_includeNdc();
     void format_ndcOmittedWhenEmpty();
     void format_includeMdc();
     void format_mdcOmittedWhenEmpty();
+    void format_mdcSortedByKey();
 
     void format_includeLocation();
     void format_locationOmittedByDefault();
 
     void format_prettyPrint();
+    void format_prettyPrintMatchesQJsonDocument();
 };
 
 void JsonLayoutTest::cleanup()
@@ -253,6 +260,65 @@ void JsonLayoutTest::format_ndcOmittedWhenEmpty()
     QVERIFY(!obj.contains(QStringLiteral("ndc")));
 }
 
+void JsonLayoutTest::format_fieldOrder()
+{
+    JsonLayout layout;
+    const QString output = layout.format(makeEvent(Level::INFO_INT, QStringLiteral("Started")));
+    QCOMPARE(output, QStringLiteral("{\"timestamp\":1705314600123,\"level\":\"INFO\",\"logger\":\"root\","
+                                    "\"thread\":\"testThread\",\"message\":\"Started\"}\n"));
+}
+
+void JsonLayoutTest::format_noFields()
+{
+    JsonLayout layout;
+    layout.setIncludeTimestamp(false);
+    layout.setIncludeLevel(false);
+    layout.setIncludeLogger(false);
+    layout.setIncludeThread(false);
+    layout.setIncludeMessage(false);
+    QCOMPARE(layout.format(makeEvent(Level::INFO_INT, QStringLiteral("x"))), QStringLiteral("{}\n"));
+}
+
+void JsonLayoutTest::format_escaping_data()
+{
+    QTest::addColumn<QString>("message");
+
+    QTest::newRow("Quote and backslash") << QStringLiteral("say \"hi\" to C:\\temp");
+    QTest::newRow("Control characters") << QStringLiteral("a\tb\nc\rd\be\ff") + QChar(0x01) + QChar(0x1F);
+    QTest::newRow("Non-ASCII") << QStringLiteral("Gr\u00FC\u00DFe \u20AC \U0001F600 end");
+    QTest::newRow("Escape after long ASCII run") << QStringLiteral("0123456789abcdefgh\"0123456789\\");
+    QTest::newRow("DEL and tilde") << QStringLiteral("~\x7f~");
+}
+
+void JsonLayoutTest::format_escaping()
+{
+    QFETCH(QString, message);
+
+    JsonLayout layout;
+    layout.setIncludeMdc(true);
+    const QHash<QString, QString> mdc{{message, message}};
+    const QJsonObject obj = formatToJson(layout, makeEvent(Level::INFO_INT, message, {}, mdc,
+                                                           message));
+    QCOMPARE(obj.value(QStringLiteral("message")).toString(), message);
+    QCOMPARE(obj.value(QStringLiteral("thread")).toString(), message);
+    QCOMPARE(obj.value(QStringLiteral("mdc")).toObject().value(message).toString(), message);
+}
+
+void JsonLayoutTest::formatTo_matchesFormat()
+{
+    JsonLayout layout;
+    layout.setIncludeNdc(true);
+    layout.setIncludeLocation(true);
+    const MessageContext ctx("myfile.cpp", 42, "MyClass::myMethod");
+    const LoggingEvent event(LogManager::rootLogger(), Level::ERROR_INT,
+                             QStringLiteral("caf\u00E9 \"quoted\""), QStringLiteral("ndc"), {},
+                             TEST_TIMESTAMP, ctx, {});
+
+    QByteArray utf8("prefix:");
+    layout.formatTo(event, utf8);
+    QCOMPARE(utf8, "prefix:" + layout.format(event).toUtf8());
+}
+
 // ---------------------------------------------------------------------------
 // MDC
 // ---------------------------------------------------------------------------
@@ -282,6 +348,24 @@ void JsonLayoutTest::format_mdcOmittedWhenEmpty()
     QVERIFY(!obj.contains(QStringLiteral("mdc")));
 }
 
+void JsonLayoutTest::format_mdcSortedByKey()
+{
+    JsonLayout layout;
+    layout.setIncludeTimestamp(false);
+    layout.setIncludeLevel(false);
+    layout.setIncludeLogger(false);
+    layout.setIncludeThread(false);
+    layout.setIncludeMessage(false);
+    layout.setIncludeMdc(true);
+
+    // Independent of the QHash iteration order
+    QHash<QString, QString> mdc;
+    for (const char *key : {"zeta", "alpha", "mu", "beta", "omega", "delta"})
+        mdc.insert(QString::fromLatin1(key), QStringLiteral("v"));
+    QCOMPARE(layout.format(makeEvent(Level::INFO_INT, {}, {}, mdc)).trimmed(),
+             QStringLiteral(R"({"mdc":{"alpha":"v","beta":"v","delta":"v","mu":"v","omega":"v","zeta":"v"}})"));
+}
+
 // ---------------------------------------------------------------------------
 // Location
 // ---------------------------------------------------------------------------
@@ -334,5 +418,38 @@ void JsonLayoutTest::format_prettyPrint()
     QVERIFY(!doc.isNull());
 }
 
+void JsonLayoutTest::format_prettyPrintMatchesQJsonDocument()
+{
+    JsonLayout layout;
+    layout.setPrettyPrint(true);
+    layout.setIncludeTimestamp(false);
+    layout.setIncludeMdc(true);
+
+    const QHash<QString, QString> mdc{{QStringLiteral("userId"), QStringLiteral("99")}};
+    const QString output = layout.format(makeEvent(Level::INFO_INT, QStringLiteral("hi"), {}, mdc));
+    // QJsonDocument sorts the keys, so compare the sorted lines
+    QJsonObject expected;
+    expected[QStringLiteral("level")] = QStringLiteral("INFO");
+    expected[QStringLiteral("logger")] = QStringLiteral("root");
+    expected[QStringLiteral("message")] = QStringLiteral("hi");
+    expected[QStringLiteral("mdc")] = QJsonObject{{QStringLiteral("userId"), QStringLiteral("99")}};
+    expected[QStringLiteral("thread")] = QStringLiteral("testThread");
+    const QString qtOutput = QString::fromUtf8(QJsonDocument(expected).toJson(QJsonDocument::Indented));
+
+    QStringList lines = output.split(QLatin1Char('\n'));
+    QStringList qtLines = qtOutput.split(QLatin1Char('\n'));
+    QCOMPARE(lines.size(), qtLines.size() + 1); // plus the end of line
+    // The trailing commas depend on the key order
+    const auto normalise = [](QStringList list) {
+        for (auto &line : list)
+            if (line.endsWith(QLatin1Char(',')))
+                line.chop(1);
+        list.sort();
+        return list;
+    };
+    lines.removeLast();
+    QCOMPARE(normalise(lines), normalise(qtLines));
+}
+
 QTEST_MAIN(JsonLayoutTest)
 #include "tst_jsonlayout.moc"
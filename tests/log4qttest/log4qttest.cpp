@@ -26,6 +26,8 @@
 #include "log4qttest.h"
 
 #include "log4qt/basicconfigurator.h"
+#include "log4qt/binarylayout.h"
+#include "log4qt/callsite.h"
 #include "log4qt/consoleappender.h"
 #include "log4qt/spi/daterolloverstrategy.h"
 #include "log4qt/spi/timebasedtriggeringpolicy.h"
@@ -39,35 +41,51 @@
 #include "log4qt/helpers/properties.h"
 #include "log4qt/logmanager.h"
 #include "log4qt/loggerrepository.h"
+#include "log4qt/mdc.h"
+#include "log4qt/ndc.h"
 #include "log4qt/patternlayout.h"
 #include "log4qt/propertyconfigurator.h"
+#include "log4qt/randomaccessfileappender.h"
 #include "log4qt/rollingfileappender.h"
 #include "log4qt/simplelayout.h"
+#include "log4qt/staticpatternlayout.h"
 #include "log4qt/spi/defaultrolloverstrategy.h"
 #include "log4qt/spi/sizebasedtriggeringpolicy.h"
 #include "log4qt/ttcclayout.h"
 #include "log4qt/varia/denyallfilter.h"
 #include "log4qt/varia/levelmatchfilter.h"
 #include "log4qt/varia/levelrangefilter.h"
+#include "log4qt/varia/mdcmatchfilter.h"
+#include "log4qt/varia/multistringmatchfilter.h"
+#include "log4qt/varia/regexfilter.h"
 #include "log4qt/varia/stringmatchfilter.h"
+#include "log4qt/xmllayout.h"
 
 #include <QBuffer>
 #include <QBitArray>
 #include <QDataStream>
 #include <QFile>
+#include <QLoggingCategory>
 #include <QMetaEnum>
+#include <QSet>
 #include <QSettings>
 #include <QTextStream>
 #include <QThread>
+#include <QXmlStreamReader>
 
 #include <QtTest/QTest>
 
+#include <algorithm>
 #include <atomic>
+#include <memory>
 #include <type_traits>
+#include <vector>
 
 using namespace Qt::StringLiterals;
 
 using namespace Log4Qt;
+
+Q_LOGGING_CATEGORY(lcCategoryTest, "log4qttest.category")
 #if QT_VERSION >= 0x050E00
 using Qt::endl;
 #endif
@@ -159,6 +177,61 @@ void Log4QtTest::DateTime_milliseconds()
     QCOMPARE(DateTime::fromMSecsSinceEpoch(milliseconds).toUTC(), datetime);
 }
 
+void Log4QtTest::DateTimeFormatter_data()
+{
+    QTest::addColumn<QString>("format");
+
+    QTest::newRow("ISO with T") << QStringLiteral("yyyy-MM-dd'T'HH:mm:ss.zzz");
+    QTest::newRow("ISO with offset") << QStringLiteral("yyyy-MM-dd'T'HH:mm:ss.zzzttt");
+    QTest::newRow("Short milliseconds") << QStringLiteral("HH:mm:ss.z");
+    QTest::newRow("Milliseconds twice") << QStringLiteral("zzz ss zzz");
+    QTest::newRow("Four z") << QStringLiteral("ss.zzzz");
+    QTest::newRow("Quoted z") << QStringLiteral("'zone' HH 'z''zz' zzz");
+    QTest::newRow("Escaped quote") << QStringLiteral("HH''mm''ss.zzz");
+    QTest::newRow("AM/PM") << QStringLiteral("h:mm:ss.zzz AP");
+    QTest::newRow("No milliseconds") << QStringLiteral("dddd, d MMMM yyyy HH:mm:ss");
+}
+
+void Log4QtTest::DateTimeFormatter()
+{
+    QFETCH(QString, format);
+
+    const Log4Qt::DateTimeFormatter formatter(format);
+    const qint64 base = QDateTime(QDate(2016, 5, 3), QTime(15, 7, 5)).toMSecsSinceEpoch();
+    // Same second, next second, and back to an earlier one
+    for (const qint64 offset : {0, 9, 120, 999, 1000, 1045, 500, -1, 86400123})
+    {
+        const qint64 msecs = base + offset;
+        const QString expected = QDateTime::fromMSecsSinceEpoch(msecs).toString(format);
+        QCOMPARE(formatter.format(msecs), expected);
+        QByteArray utf8("prefix:");
+        formatter.formatTo(msecs, utf8);
+        QCOMPARE(utf8, "prefix:" + expected.toUtf8());
+        QCOMPARE(DateTime::formatMsecs(msecs, format), expected);
+    }
+}
+
+void Log4QtTest::DateTimeFormatter_providerTimeZone()
+{
+    const QDateTime utcNow(QDate(2026, 1, 15), QTime(10, 30, 0), QTimeZone::utc());
+    const Log4Qt::DateTimeFormatter formatter(QStringLiteral("yyyy-MM-dd'T'HH:mm:ss.zzz t"));
+    const qint64 msecs = utcNow.toMSecsSinceEpoch() + 42;
+
+    // Installing the provider does not call it, the time zone is sampled lazily
+    const auto calls = std::make_shared<int>(0);
+    DateTime::setProvider([utcNow, calls]() { ++*calls; return utcNow; });
+    QCOMPARE(*calls, 0);
+    QCOMPARE(DateTime::providerTimeZone(), QTimeZone::utc());
+    QCOMPARE(*calls, 1);
+    QCOMPARE(DateTime::providerTimeZone(), QTimeZone::utc());
+    QCOMPARE(*calls, 1);
+    QCOMPARE(formatter.format(msecs), QStringLiteral("2026-01-15T10:30:00.042 UTC"));
+
+    DateTime::setProvider({});
+    QCOMPARE(formatter.format(msecs),
+             QDateTime::fromMSecsSinceEpoch(msecs).toString(QStringLiteral("yyyy-MM-dd'T'HH:mm:ss.zzz t")));
+}
+
 void Log4QtTest::PatternFormatter_data()
 {
     QTest::addColumn<LoggingEvent>("event");
@@ -375,6 +448,31 @@ void Log4QtTest::PatternFormatter_data()
             << "%X- %m"
             << QStringLiteral("{A=a, B=b, C=c}- This is the message")
             << 0;
+    // Padding and truncation count UTF-16 code units, also in formatTo()
+    QTest::newRow("Non-ASCII with padding and truncation")
+            << LoggingEvent(test_logger(),
+                            Level(Level::INFO_INT),
+                            QString::fromUtf8("Gr\xc3\xbc\xc3\x9f" "e \xe2\x82\xac \xf0\x9f\x98\x80"),
+                            QStringLiteral("NDC"),
+                            properties,
+                            QString::fromUtf8("th\xc3\xa9"),
+                            relative_timestamp)
+            << QString::fromUtf8("\xc2\xbb%-5t|%6.4m|%3.2c{1}\xc2\xab")
+            << QString::fromUtf8("\xc2\xbbth\xc3\xa9  |  \xe2\x82\xac \xf0\x9f\x98\x80| Qt\xc2\xab")
+            << 0;
+    QTest::newRow("Logger name sections")
+            << LoggingEvent(test_logger(),
+                            Level(Level::ERROR_INT),
+                            QStringLiteral("This is the message"),
+                            QStringLiteral("NDC"),
+                            properties,
+                            QStringLiteral("main"),
+                            relative_timestamp,
+                            MessageContext("foo.cpp", 100, "foo()"),
+                            QString())
+            << "%c{1}|%c{2}|%7p|%-7L|%20l"
+            << QStringLiteral("TestLog4Qt|Test::TestLog4Qt|  ERROR|100    | foo.cpp:100 - foo()")
+            << 0;
 
     resetLogging();
 }
@@ -389,6 +487,10 @@ void Log4QtTest::PatternFormatter()
     Log4Qt::PatternFormatter pattern_formatter(pattern);
     QCOMPARE(pattern_formatter.format(event), result);
 
+    QByteArray bytes("prefix:");
+    pattern_formatter.formatTo(event, bytes);
+    QCOMPARE(bytes, "prefix:" + result.toUtf8());
+
     QCOMPARE(loggingEvents()->list().count(), event_count);
 }
 
@@ -970,6 +1072,18 @@ void Log4QtTest::Factory_createFilter_data()
             << "org.apache.log4j.varia.StringMatchFilter" << "Log4Qt::StringMatchFilter" << 0;
     QTest::newRow("StringMatchFilter cpp")
             << "Log4Qt::StringMatchFilter" << "Log4Qt::StringMatchFilter" << 0;
+    QTest::newRow("MultiStringMatchFilter cpp")
+            << "Log4Qt::MultiStringMatchFilter" << "Log4Qt::MultiStringMatchFilter" << 0;
+    QTest::newRow("MultiStringMatchFilter short")
+            << "MultiStringMatch" << "Log4Qt::MultiStringMatchFilter" << 0;
+    QTest::newRow("RegexFilter cpp")
+            << "Log4Qt::RegexFilter" << "Log4Qt::RegexFilter" << 0;
+    QTest::newRow("RegexFilter short")
+            << "Regex" << "Log4Qt::RegexFilter" << 0;
+    QTest::newRow("MdcMatchFilter cpp")
+            << "Log4Qt::MdcMatchFilter" << "Log4Qt::MdcMatchFilter" << 0;
+    QTest::newRow("MdcMatchFilter short")
+            << "MdcMatch" << "Log4Qt::MdcMatchFilter" << 0;
 }
 
 
@@ -1278,6 +1392,162 @@ void Log4QtTest::StringMatchFilterCaseInsensitive()
     QCOMPARE(decision, result);
 }
 
+void Log4QtTest::MultiStringMatchFilter_data()
+{
+    QTest::addColumn<QString>("deny_strings");
+    QTest::addColumn<QString>("accept_strings");
+    QTest::addColumn<Qt::CaseSensitivity>("case_sensitivity");
+    QTest::addColumn<QString>("event_string");
+    QTest::addColumn<QString>("result");
+
+    QTest::newRow("No strings") << "" << "" << Qt::CaseSensitive << "This is a message" << "Neutral";
+    QTest::newRow("No match") << "heartbeat|poll" << "error" << Qt::CaseSensitive << "This is a message" << "Neutral";
+    QTest::newRow("Deny match") << "heartbeat|poll" << "" << Qt::CaseSensitive << "Sending heartbeat 42" << "Deny";
+    QTest::newRow("Accept match") << "heartbeat" << "message" << Qt::CaseSensitive << "This is a message" << "Accept";
+    QTest::newRow("Deny wins") << "poll" << "This" << Qt::CaseSensitive << "This is a poll" << "Deny";
+    QTest::newRow("Overlapping strings") << "shers" << "he" << Qt::CaseSensitive << "ushers" << "Deny";
+    QTest::newRow("Suffix of other string") << "abcd|bc" << "" << Qt::CaseSensitive << "xabcx" << "Deny";
+    QTest::newRow("Case sensitive") << "MESSAGE" << "" << Qt::CaseSensitive << "This is a message" << "Neutral";
+    QTest::newRow("Case insensitive") << "MESSAGE" << "" << Qt::CaseInsensitive << "This is a message" << "Deny";
+    QTest::newRow("Non Latin-1") << QString::fromUtf8("\xce\xb1\xce\xb2") << "" << Qt::CaseInsensitive
+                                 << QString::fromUtf8("x \xce\x91\xce\x92 y") << "Deny";
+    QTest::newRow("Empty message") << "This" << "" << Qt::CaseSensitive << "" << "Neutral";
+}
+
+void Log4QtTest::MultiStringMatchFilter()
+{
+    QFETCH(QString, deny_strings);
+    QFETCH(QString, accept_strings);
+    QFETCH(Qt::CaseSensitivity, case_sensitivity);
+    QFETCH(QString, event_string);
+    QFETCH(QString, result);
+
+    Log4Qt::MultiStringMatchFilter filter;
+    filter.setDenyStrings(deny_strings);
+    filter.setAcceptStrings(accept_strings);
+    filter.setCaseSensitivity(case_sensitivity);
+    LoggingEvent event(test_logger(), Level::WARN_INT, event_string);
+
+    QString decision =
+        enumValueToKey(&filter, "Decision", filter.decide(event));
+    QCOMPARE(decision, result);
+}
+
+void Log4QtTest::MultiStringMatchFilter_splitStrings()
+{
+    const QString value = QStringLiteral("a\\|b\\\\c||d");
+    const QStringList strings = Log4Qt::MultiStringMatchFilter::splitStrings(value);
+    QCOMPARE(strings, QStringList({QStringLiteral("a|b\\c"), QStringLiteral("d")}));
+    QCOMPARE(Log4Qt::MultiStringMatchFilter::joinStrings(strings), QStringLiteral("a\\|b\\\\c|d"));
+}
+
+void Log4QtTest::RegexFilter_data()
+{
+    QTest::addColumn<QString>("regex");
+    QTest::addColumn<QString>("target");
+    QTest::addColumn<bool>("accept");
+    QTest::addColumn<Qt::CaseSensitivity>("case_sensitivity");
+    QTest::addColumn<QString>("result");
+
+    QTest::newRow("No regex") << "" << "Message" << true << Qt::CaseSensitive << "Neutral";
+    QTest::newRow("Message match") << "user \\d+ logged" << "Message" << true << Qt::CaseSensitive << "Accept";
+    QTest::newRow("Message deny") << "user \\d+ logged" << "Message" << false << Qt::CaseSensitive << "Deny";
+    QTest::newRow("Message no match") << "^logged" << "Message" << true << Qt::CaseSensitive << "Neutral";
+    QTest::newRow("Case sensitive") << "USER" << "Message" << true << Qt::CaseSensitive << "Neutral";
+    QTest::newRow("Case insensitive") << "USER" << "Message" << true << Qt::CaseInsensitive << "Accept";
+    QTest::newRow("Logger match") << "^Test(::|\\.)TestLog4Qt$" << "Logger" << true << Qt::CaseSensitive << "Accept";
+    QTest::newRow("MDC match") << "^eu-" << "MDC:region" << true << Qt::CaseSensitive << "Accept";
+    QTest::newRow("MDC no match") << "^us-" << "MDC:region" << true << Qt::CaseSensitive << "Neutral";
+    QTest::newRow("MDC key missing") << ".*" << "MDC:tenant" << true << Qt::CaseSensitive << "Neutral";
+}
+
+void Log4QtTest::RegexFilter()
+{
+    QFETCH(QString, regex);
+    QFETCH(QString, target);
+    QFETCH(bool, accept);
+    QFETCH(Qt::CaseSensitivity, case_sensitivity);
+    QFETCH(QString, result);
+
+    Log4Qt::RegexFilter filter;
+    filter.setRegex(regex);
+    filter.setTarget(target);
+    filter.setAcceptOnMatch(accept);
+    filter.setCaseSensitivity(case_sensitivity);
+    QCOMPARE(filter.target(), target);
+    LoggingEvent event(test_logger(), Level::WARN_INT, QStringLiteral("user 42 logged in"));
+    event.setProperty(QStringLiteral("region"), QStringLiteral("eu-west"));
+
+    QString decision =
+        enumValueToKey(&filter, "Decision", filter.decide(event));
+    QCOMPARE(decision, result);
+}
+
+void Log4QtTest::RegexFilter_invalidRegex()
+{
+    loggingEvents()->clearList();
+    Log4Qt::RegexFilter filter;
+    filter.setRegex(QStringLiteral("user ("));
+    QVERIFY(!filter.isValid());
+    QCOMPARE(loggingEvents()->list().count(), 1);
+    LoggingEvent event(test_logger(), Level::WARN_INT, QStringLiteral("user ("));
+    QCOMPARE(filter.decide(event), Filter::Neutral);
+
+    filter.setRegex(QStringLiteral("user \\("));
+    QVERIFY(filter.isValid());
+    QCOMPARE(filter.decide(event), Filter::Accept);
+
+    filter.setTarget(QStringLiteral("Thread"));
+    QCOMPARE(filter.target(), QStringLiteral("Message"));
+    QCOMPARE(loggingEvents()->list().count(), 2);
+}
+
+void Log4QtTest::MdcMatchFilter_data()
+{
+    QTest::addColumn<QString>("predicates");
+    QTest::addColumn<bool>("match_all");
+    QTest::addColumn<bool>("accept");
+    QTest::addColumn<QString>("result");
+
+    QTest::newRow("No predicates") << "" << true << true << "Neutral";
+    QTest::newRow("Single match") << "user=alice" << true << true << "Accept";
+    QTest::newRow("Single match deny") << "user=alice" << true << false << "Deny";
+    QTest::newRow("Single no match") << "user=bob" << true << true << "Neutral";
+    QTest::newRow("All match") << "user=alice|tenant=acme" << true << true << "Accept";
+    QTest::newRow("All partial") << "user=alice|tenant=other" << true << true << "Neutral";
+    QTest::newRow("Any partial") << "user=bob|tenant=acme" << false << true << "Accept";
+    QTest::newRow("Any none") << "user=bob|tenant=other" << false << true << "Neutral";
+    QTest::newRow("Missing key") << "session=1" << true << true << "Neutral";
+    QTest::newRow("Value with separator") << "query=a\\|b=c" << true << true << "Accept";
+    QTest::newRow("Invalid entry ignored") << "novalue|user=alice" << true << true << "Accept";
+}
+
+void Log4QtTest::MdcMatchFilter()
+{
+    QFETCH(QString, predicates);
+    QFETCH(bool, match_all);
+    QFETCH(bool, accept);
+    QFETCH(QString, result);
+
+    Log4Qt::MdcMatchFilter filter;
+    filter.setPredicates(predicates);
+    filter.setMatchAll(match_all);
+    filter.setAcceptOnMatch(accept);
+    LoggingEvent event(test_logger(), Level::WARN_INT, QStringLiteral("This is a message"));
+    event.setProperty(QStringLiteral("user"), QStringLiteral("alice"));
+    event.setProperty(QStringLiteral("tenant"), QStringLiteral("acme"));
+    event.setProperty(QStringLiteral("query"), QStringLiteral("a|b=c"));
+
+    QString decision =
+        enumValueToKey(&filter, "Decision", filter.decide(event));
+    QCOMPARE(decision, result);
+
+    filter.clearPredicates();
+    QCOMPARE(filter.decide(event), Filter::Neutral);
+    filter.addPredicate(QStringLiteral("user"), QStringLiteral("alice"));
+    QCOMPARE(filter.predicates(), QStringLiteral("user=alice"));
+}
+
 
 
 /******************************************************************************
@@ -1401,6 +1671,30 @@ void Log4QtTest::AppenderSkeleton_clearFilters()
     QCOMPARE(appender.list().count(), 0);
 }
 
+void Log4QtTest::AppenderSkeleton_settersRepublishConfiguration()
+{
+    Log4Qt::ListAppender appender;
+    const LoggingEvent info(test_logger(), Level::INFO_INT, QStringLiteral("Info"));
+
+    appender.setThreshold(Level::WARN_INT);
+    appender.doAppend(info);
+    QCOMPARE(appender.list().count(), 0);
+    appender.setThreshold(Level::INFO_INT);
+    appender.doAppend(info);
+    QCOMPARE(appender.list().count(), 1);
+
+    LayoutSharedPtr layout(new SimpleLayout);
+    appender.setLayout(layout);
+    QCOMPARE(appender.layout(), layout);
+
+    appender.close();
+    appender.doAppend(info);
+    QCOMPARE(appender.list().count(), 1);
+    appender.activateOptions();
+    appender.doAppend(info);
+    QCOMPARE(appender.list().count(), 2);
+}
+
 
 // Test helper: an appender that reports an internal failure (as e.g. a file
 // appender does on a full disk) through its class logger while appending.
@@ -1498,6 +1792,313 @@ void Log4QtTest::Logger_logWithLocationHonoursLevel()
     logger->removeAllAppenders();
 }
 
+void Log4QtTest::Logger_effectiveLevelFollowsHierarchyChanges()
+{
+    resetLogging();
+
+    Logger *a = LogManager::logger(QStringLiteral("Test::Effective"));
+    Logger *c = LogManager::logger(QStringLiteral("Test::Effective::b::c"));
+    Logger *e = LogManager::logger(QStringLiteral("Test::Effective::b::c::d::e"));
+
+    const Level rootLevel = LogManager::rootLogger()->level();
+    QCOMPARE(e->effectiveLevel(), rootLevel);
+
+    // The cached level of a descendant follows every change up the chain
+    a->setLevel(Level::WARN_INT);
+    QCOMPARE(e->effectiveLevel(), Level(Level::WARN_INT));
+    QVERIFY(!e->isInfoEnabled());
+
+    c->setLevel(Level::INFO_INT);
+    QCOMPARE(e->effectiveLevel(), Level(Level::INFO_INT));
+    QVERIFY(e->isInfoEnabled());
+
+    c->setLevel(Level::NULL_INT);
+    QCOMPARE(e->effectiveLevel(), Level(Level::WARN_INT));
+
+    LogManager::resetConfiguration();
+    QCOMPARE(e->effectiveLevel(), LogManager::rootLogger()->level());
+
+    resetLogging();
+}
+
+void Log4QtTest::Logger_dispatchPlanFollowsAppenderChanges()
+{
+    resetLogging();
+
+    Logger *parent = LogManager::logger(QStringLiteral("Test::Dispatch"));
+    Logger *child = LogManager::logger(QStringLiteral("Test::Dispatch::a::b"));
+    parent->setAdditivity(false);
+    parent->setLevel(Level::INFO_INT);
+
+    auto *parentList = new Log4Qt::ListAppender;
+    parentList->setName(QStringLiteral("ParentList"));
+    const AppenderSharedPtr parentAppender(parentList);
+    auto *childList = new Log4Qt::ListAppender;
+    childList->setName(QStringLiteral("ChildList"));
+    const AppenderSharedPtr childAppender(childList);
+
+    parent->addAppender(parentAppender);
+    child->info(QStringLiteral("1"));
+    QCOMPARE(parentList->list().count(), 1);
+
+    // Changes anywhere on the chain reach the child's cached plan
+    child->addAppender(childAppender);
+    child->info(QStringLiteral("2"));
+    QCOMPARE(childList->list().count(), 1);
+    QCOMPARE(parentList->list().count(), 2);
+
+    LogManager::logger(QStringLiteral("Test::Dispatch::a"))->setAdditivity(false);
+    child->info(QStringLiteral("3"));
+    QCOMPARE(childList->list().count(), 2);
+    QCOMPARE(parentList->list().count(), 2);
+    LogManager::logger(QStringLiteral("Test::Dispatch::a"))->setAdditivity(true);
+
+    // An appender attached at two levels receives each event once
+    child->addAppender(parentAppender);
+    child->info(QStringLiteral("4"));
+    QCOMPARE(parentList->list().count(), 3);
+
+    child->removeAllAppenders();
+    parent->removeAppender(parentAppender);
+    child->info(QStringLiteral("5"));
+    QCOMPARE(childList->list().count(), 3);
+    QCOMPARE(parentList->list().count(), 3);
+
+    resetLogging();
+}
+
+void Log4QtTest::LogStream_reusedStreamsStartClean()
+{
+    resetLogging();
+
+    Logger *logger = LogManager::logger(QStringLiteral("Test::LogStream"));
+    logger->setLevel(Level::DEBUG_INT);
+    auto *list = new Log4Qt::ListAppender;
+    logger->addAppender(AppenderSharedPtr(list));
+
+    // Statements on one thread share pooled streams; neither text nor
+    // manipulators carry over
+    logger->info() << "first " << Qt::hex << 255;
+    logger->info() << "second " << 255;
+    {
+        LogStream stream = logger->warn();
+        const LogStream copy = stream;
+        stream << "shared";
+        // Logged once, when the last copy is gone
+        logger->info() << "nested " << 1;
+    }
+    logger->trace() << "disabled";
+
+    QCOMPARE(list->list().count(), 4);
+    QCOMPARE(list->list().at(0).message(), QStringLiteral("first ff"));
+    QCOMPARE(list->list().at(1).message(), QStringLiteral("second 255"));
+    QCOMPARE(list->list().at(2).message(), QStringLiteral("nested 1"));
+    QCOMPARE(list->list().at(3).message(), QStringLiteral("shared"));
+    QCOMPARE(list->list().at(3).level(), Level(Level::WARN_INT));
+
+    resetLogging();
+}
+
+// Parsed at compile time
+static_assert(FormatString<"user {} took {} ms">::argumentCount == 2);
+static_assert(FormatString<"{{}} {}">::argumentCount == 1);
+static_assert(FormatString<"\u00e4 {}">::literal().size() == 2);
+
+void Log4QtTest::Logger_abbreviatedName_data()
+{
+    QTest::addColumn<QString>("name");
+    QTest::addColumn<int>("precision");
+    QTest::addColumn<QString>("result");
+
+    QTest::newRow("Whole name") << QStringLiteral("Abbr::Sub::Leaf") << 0 << QStringLiteral("Abbr::Sub::Leaf");
+    QTest::newRow("Negative precision") << QStringLiteral("Abbr::Sub::Leaf") << -1 << QStringLiteral("Abbr::Sub::Leaf");
+    QTest::newRow("Last section") << QStringLiteral("Abbr::Sub::Leaf") << 1 << QStringLiteral("Leaf");
+    QTest::newRow("Two sections") << QStringLiteral("Abbr::Sub::Leaf") << 2 << QStringLiteral("Sub::Leaf");
+    QTest::newRow("All sections") << QStringLiteral("Abbr::Sub::Leaf") << 3 << QStringLiteral("Abbr::Sub::Leaf");
+    QTest::newRow("More than all") << QStringLiteral("Abbr::Sub::Leaf") << 7 << QStringLiteral("Abbr::Sub::Leaf");
+    QTest::newRow("Single section") << QStringLiteral("AbbrSingle") << 1 << QStringLiteral("AbbrSingle");
+    QTest::newRow("Non-ASCII") << QStringLiteral("Abbr::\u00C4rger::\u00DCbel") << 2
+                               << QStringLiteral("\u00C4rger::\u00DCbel");
+}
+
+void Log4QtTest::Logger_abbreviatedName()
+{
+    QFETCH(QString, name);
+    QFETCH(int, precision);
+    QFETCH(QString, result);
+
+    const Logger *logger = LogManager::logger(name);
+    QCOMPARE(logger->abbreviatedName(precision).toString(), result);
+    QCOMPARE(logger->abbreviatedNameUtf8(precision).toByteArray(), result.toUtf8());
+
+    // The same as %c{precision}; a negative option is rejected by the parser
+    if (precision >= 0)
+    {
+        const PatternFormatter formatter(u"%c{"_s + QString::number(precision) + u'}');
+        QCOMPARE(formatter.format(LoggingEvent(logger, Level::INFO_INT, QString())), result);
+    }
+}
+
+void Log4QtTest::Logger_formatString()
+{
+    resetLogging();
+
+    Logger *logger = LogManager::logger(QStringLiteral("Test::FormatString"));
+    logger->setLevel(Level::DEBUG_INT);
+    auto *list = new Log4Qt::ListAppender;
+    logger->addAppender(AppenderSharedPtr(list));
+
+    enum Code { Seven = 7 };
+    logger->info(L4Q_FMT("user {} took {} ms"), QStringLiteral("alice"), 42);
+    logger->debug(L4Q_FMT("{{{}}} {} {} {} {} {}"), -5LL, true, 'c', Seven, "utf8 \u00e4",
+                  QLatin1StringView("latin1"));
+    logger->log(Level::WARN_INT, L4Q_FMT("{} {}"), 1.5, QChar(u'x'));
+    logger->trace(L4Q_FMT("disabled {}"), 1);
+    logger->info(L4Q_FMT("no placeholders"));
+
+    QCOMPARE(list->list().count(), 4);
+    QCOMPARE(list->list().at(0).message(), QStringLiteral("user alice took 42 ms"));
+    QCOMPARE(list->list().at(1).message(), QStringLiteral("{-5} true c 7 utf8 \u00e4 latin1"));
+    QCOMPARE(list->list().at(2).message(), QStringLiteral("1.5 x"));
+    QCOMPARE(list->list().at(2).level(), Level(Level::WARN_INT));
+    QCOMPARE(list->list().at(3).message(), QStringLiteral("no placeholders"));
+
+    resetLogging();
+}
+
+void Log4QtTest::CallSite_modeOverridesLoggerLevel()
+{
+    resetLogging();
+
+    Logger *p_logger = LogManager::logger(QStringLiteral("Test::CallSite"));
+    p_logger->setLevel(Level::INFO_INT);
+    auto *list = new Log4Qt::ListAppender;
+    p_logger->addAppender(AppenderSharedPtr(list));
+    const auto logger = [p_logger] { return p_logger; };
+
+    // Rules set before a statement first runs apply once it registers
+    const int debugLine = __LINE__ + 5;
+    QCOMPARE(CallSiteRegistry::setMode(QStringLiteral("log4qttest.cpp"), debugLine, CallSite::Mode::Enabled), 0);
+    const int infoLine = __LINE__ + 4;
+    for (int i = 0; i < 2; ++i)
+    {
+        l4qDebug(QStringLiteral("debug %1"), i);
+        l4qInfo() << "info " << i;
+        CallSiteRegistry::setMode(QStringLiteral("log4qttest.cpp"), infoLine, CallSite::Mode::Disabled);
+    }
+
+    QCOMPARE(list->list().count(), 3);
+    QCOMPARE(list->list().at(0).message(), QStringLiteral("debug 0"));
+    QCOMPARE(list->list().at(0).level(), Level(Level::DEBUG_INT));
+    QCOMPARE(list->list().at(0).lineNumber(), debugLine);
+    QCOMPARE(list->list().at(1).message(), QStringLiteral("info 0"));
+    QCOMPARE(list->list().at(1).lineNumber(), infoLine);
+    QCOMPARE(list->list().at(2).message(), QStringLiteral("debug 1"));
+
+    const QList<CallSite *> sites = CallSiteRegistry::callSites();
+    const auto site = std::find_if(sites.cbegin(), sites.cend(), [&](const CallSite *s) {
+        return s->line() == debugLine && QByteArrayView(s->file()).endsWith("log4qttest.cpp");
+    });
+    QVERIFY(site != sites.cend());
+    QCOMPARE((*site)->mode(), CallSite::Mode::Enabled);
+    QCOMPARE((*site)->level(), Level(Level::DEBUG_INT));
+
+    // A path with a partial directory does not match a different file name
+    QCOMPARE(CallSiteRegistry::setMode(QStringLiteral("ttest.cpp"), debugLine, CallSite::Mode::Disabled), 0);
+
+    CallSiteRegistry::resetModes();
+    QCOMPARE((*site)->mode(), CallSite::Mode::Default);
+    l4qDebug(QStringLiteral("not logged"));
+    QCOMPARE(list->list().count(), 3);
+
+    resetLogging();
+}
+
+void Log4QtTest::CallSite_preEncodedLocation()
+{
+    const CallSite site(Level::WARN_INT, "src/module/file.cpp", 1234, "void Module::run(int)");
+    QCOMPARE(site.fileUtf8(), QByteArrayView("src/module/file.cpp"));
+    QCOMPARE(site.lineUtf8(), QByteArrayView("1234"));
+    QCOMPARE(site.functionUtf8(), QByteArrayView("void Module::run(int)"));
+    QCOMPARE(site.locationUtf8(), QByteArrayView("src/module/file.cpp:1234 - void Module::run(int)"));
+
+    // The site copies the names, events never point into the caller's module
+    QByteArray file("src/module/file.cpp");
+    QByteArray function("void Module::run(int)");
+    const CallSite copied(Level::WARN_INT, file.constData(), 1234, function.constData());
+    file.fill('x');
+    function.fill('x');
+    QCOMPARE(QByteArrayView(copied.file()), QByteArrayView("src/module/file.cpp"));
+    QCOMPARE(QByteArrayView(copied.function()), QByteArrayView("void Module::run(int)"));
+    QCOMPARE(copied.locationUtf8(), site.locationUtf8());
+
+    const LoggingEvent fromSite(test_logger(), Level::WARN_INT, QStringLiteral("message"),
+                                MessageContext(site), QString());
+    const LoggingEvent fromStrings(test_logger(), Level::WARN_INT, QStringLiteral("message"),
+                                   MessageContext(site.file(), site.line(), site.function()), QString());
+    QVERIFY(fromSite.context().callSite == &site);
+
+    PatternLayout layout(QStringLiteral("%F|%L|%M|%l|%-6L|%.3F|%m%n"));
+    QCOMPARE(layout.format(fromSite), layout.format(fromStrings));
+    QByteArray utf8;
+    layout.formatTo(fromSite, utf8);
+    QCOMPARE(utf8, layout.format(fromStrings).toUtf8());
+}
+
+void Log4QtTest::Logger_deferredFormatting()
+{
+    resetLogging();
+
+    Logger *logger = LogManager::logger(QStringLiteral("Test::Deferred"));
+    logger->setLevel(Level::DEBUG_INT);
+    auto *list = new Log4Qt::ListAppender;
+    logger->addAppender(AppenderSharedPtr(list));
+
+    // Deferred and eager formatting produce the same message
+    LogManager::setDeferredFormatting(true);
+    QString value = QStringLiteral("before");
+    logger->info(QStringLiteral("%1 of %2: %3"), 3, 4.5, value);
+    value = QStringLiteral("after");
+    LogManager::setDeferredFormatting(false);
+    logger->info(QStringLiteral("%1 of %2: %3"), 3, 4.5, QStringLiteral("before"));
+
+    QCOMPARE(list->list().count(), 2);
+    QCOMPARE(list->list().at(0).message(), QStringLiteral("3 of 4.5: before"));
+    QCOMPARE(list->list().at(1).message(), QStringLiteral("3 of 4.5: before"));
+
+    // Concurrent first readers all get the one formatted text
+    DeferredMessage message;
+    message.defer(QStringLiteral("%1-%2"), 7, QLatin1StringView("x"));
+    QVERIFY(message.isDeferred());
+    const int threadCount = 4;
+    std::vector<QString> texts(threadCount);
+    QList<QThread *> threads;
+    for (int t = 0; t < threadCount; ++t)
+        threads << QThread::create([&message, &texts, t]() { texts[t] = message.text(); });
+    for (auto *thread : std::as_const(threads))
+        thread->start();
+    for (auto *thread : std::as_const(threads))
+    {
+        thread->wait();
+        delete thread;
+    }
+    QVERIFY(!message.isDeferred());
+    for (const auto &text : texts)
+        QCOMPARE(text, QStringLiteral("7-x"));
+
+    // A copy carries the formatted text, not the capture
+    message.defer(QStringLiteral("%1"), 1);
+    const DeferredMessage copy(message);
+    QVERIFY(!copy.isDeferred());
+    QCOMPARE(copy.text(), QStringLiteral("1"));
+
+    // Captures beyond the inline buffer
+    message.defer(QStringLiteral("%1%2%3%4"), QStringLiteral("a"), QStringLiteral("b"),
+                  QStringLiteral("c"), QStringLiteral("d"));
+    QCOMPARE(message.text(), QStringLiteral("abcd"));
+
+    resetLogging();
+}
 
 // Regression test: resetConfiguration() used to emit levelChanged /
 // additivityChanged while holding the repository write lock. A direct-
@@ -1527,6 +2128,65 @@ void Log4QtTest::Hierarchy_signalSlotsMayQueryRepositoryDuringReset()
     disconnect(connection);
 }
 
+void Log4QtTest::LogManager_qtMessagesUseCategoryLoggers()
+{
+    resetLogging();
+
+    Logger *category = LogManager::logger(QStringLiteral("Qt::log4qttest::category"));
+    auto *list = new Log4Qt::ListAppender;
+    category->addAppender(AppenderSharedPtr(list));
+    category->setAdditivity(false);
+    // Inherited from the parent of the category logger
+    LogManager::logger(QStringLiteral("Qt::log4qttest"))->setLevel(Level::WARN_INT);
+
+    LogManager::setHandleQtMessages(true);
+    qCInfo(lcCategoryTest) << "filtered";
+    qCWarning(lcCategoryTest) << "first";
+    qCWarning(lcCategoryTest) << "second";
+    LogManager::setHandleQtMessages(false);
+
+    QCOMPARE(list->list().count(), 2);
+    QVERIFY(list->list().at(0).logger() == category);
+    QCOMPARE(list->list().at(0).message(), QStringLiteral("first"));
+    QCOMPARE(list->list().at(0).categoryName(), QStringLiteral("Qt log4qttest.category"));
+    QCOMPARE(list->list().at(1).message(), QStringLiteral("second"));
+}
+
+void Log4QtTest::Hierarchy_lookupAcceptsEverySpelling()
+{
+    LoggerRepository *repository = LogManager::loggerRepository();
+
+    Logger *logger = repository->logger(QStringLiteral("Test.Lookup.Spelling"));
+    QCOMPARE(logger->name(), QStringLiteral("Test::Lookup::Spelling"));
+    // Served from the lookup snapshot, whichever spelling is used
+    QCOMPARE(repository->logger(QStringLiteral("Test.Lookup.Spelling")), logger);
+    QCOMPARE(repository->logger(QStringLiteral("Test::Lookup::Spelling")), logger);
+    QVERIFY(repository->exists(QStringLiteral("Test::Lookup")));
+    QCOMPARE(logger->parentLogger(), repository->logger(QStringLiteral("Test.Lookup")));
+    // Aliases are not loggers of their own
+    QVERIFY(!repository->exists(QStringLiteral("Test.Lookup.Spelling")));
+
+    // Lookups racing with creation all agree on a single logger per name
+    constexpr int threadCount = 4;
+    constexpr int nameCount = 64;
+    std::vector<std::vector<Logger *>> seen(threadCount);
+    QList<QThread *> threads;
+    for (int t = 0; t < threadCount; ++t)
+        threads << QThread::create([&seen, repository, t]() {
+            for (int i = 0; i < nameCount; ++i)
+                seen[t].push_back(repository->logger(QStringLiteral("Test.Lookup.Race%1").arg(i)));
+        });
+    for (auto *thread : std::as_const(threads))
+        thread->start();
+    for (auto *thread : std::as_const(threads))
+    {
+        thread->wait();
+        delete thread;
+    }
+    for (int t = 1; t < threadCount; ++t)
+        QCOMPARE(seen[t], seen[0]);
+}
+
 
 // Regression test: a conversion pattern ending in an option-capable
 // character (%c, %d, %P) left the parser waiting for a possible '{option}'
@@ -1547,6 +2207,329 @@ void Log4QtTest::PatternLayout_patternEndingInOptionCharacter()
     QVERIFY(formatted.contains(QStringLiteral("Test::TestLog4Qt")));
 }
 
+// Regression test: %l decoded the call-site file and function as Latin-1
+// while %F, %M and formatTo() passed them through as UTF-8, so the byte
+// output differed from format().toUtf8() for non-ASCII source paths.
+void Log4QtTest::PatternLayout_nonAsciiLocation()
+{
+    PatternLayout layout(QStringLiteral("%F|%M|%l|%L"));
+    const CallSite site(Level::INFO_INT, "src/d\xC3\xA9j\xC3\xA0.cpp", 7, "void caf\xC3\xA9()");
+    const QString expected = QStringLiteral(
+        "src/d\u00E9j\u00E0.cpp|void caf\u00E9()|src/d\u00E9j\u00E0.cpp:7 - void caf\u00E9()|7");
+
+    for (const MessageContext &context : {MessageContext("src/d\xC3\xA9j\xC3\xA0.cpp", 7, "void caf\xC3\xA9()"),
+                                          MessageContext(site)})
+    {
+        const LoggingEvent event(test_logger(), Level::INFO_INT, QStringLiteral("MSG"), context, QString());
+        const QString formatted = layout.format(event);
+        QCOMPARE(formatted, expected);
+
+        QByteArray utf8("prefix:");
+        layout.formatTo(event, utf8);
+        QCOMPARE(utf8, "prefix:" + formatted.toUtf8());
+    }
+}
+
+void Log4QtTest::StaticPatternLayout_matchesPatternLayout()
+{
+    using Layout = StaticPatternLayout<"%d{yyyy-MM-dd hh:mm:ss.zzz} [%-6t] %5p %.4c{1} %X{host} %x: %m%%%n%C%-3.5m">;
+    const CallSite site(Level::ERROR_INT, "src/disk.cpp", 77, "void Disk::check()");
+    const LoggingEvent event(test_logger(), Level::ERROR_INT, QStringLiteral("Disk é full"),
+                             QStringLiteral("request"), {{QStringLiteral("host"), QStringLiteral("db1")}},
+                             QStringLiteral("main"), Q_INT64_C(1705314600123), MessageContext(site), QString());
+
+    Layout layout;
+    PatternLayout reference(Layout::conversionPattern());
+    QVERIFY(!layout.requiresLocation());
+    QCOMPARE(layout.format(event), reference.format(event));
+    QByteArray utf8("prefix:");
+    layout.formatTo(event, utf8);
+    QCOMPARE(utf8, "prefix:" + reference.format(event).toUtf8());
+
+    using LocationLayout = StaticPatternLayout<"%F|%-4L|%M|%l|%r">;
+    LocationLayout locationLayout;
+    PatternLayout locationReference(LocationLayout::conversionPattern());
+    QVERIFY(locationLayout.requiresLocation());
+    const QString location = locationLayout.format(event);
+    QVERIFY2(location.startsWith(QStringLiteral("src/disk.cpp|77  |void Disk::check()|src/disk.cpp:77 - void Disk::check()|")),
+             qPrintable(location));
+    QCOMPARE(location, locationReference.format(event));
+
+    Layout::registerLayout(QStringLiteral("Test::StaticLayout"));
+    QVERIFY(Factory::registeredLayouts().contains(QStringLiteral("Test::StaticLayout")));
+    std::unique_ptr<AbstractLayout> created(Factory::createLayout(QStringLiteral("Test::StaticLayout")));
+    QVERIFY(dynamic_cast<Layout *>(created.get()) != nullptr);
+    Factory::unregisterLayout(QStringLiteral("Test::StaticLayout"));
+}
+
+void Log4QtTest::XMLLayout_format()
+{
+    XMLLayout layout;
+    const LoggingEvent event(test_logger(), Level::WARN_INT, QStringLiteral("Disk almost full"),
+                             QStringLiteral("request"), {{QStringLiteral("host"), QStringLiteral("db1")}},
+                             QStringLiteral("main"), Q_INT64_C(1705314600123));
+
+    const QString expected = QStringLiteral(
+        "<log4j:event logger=\"Test::TestLog4Qt\" timestamp=\"1705314600123\" level=\"WARN\" thread=\"main\">"
+        "<log4j:message><![CDATA[Disk almost full]]></log4j:message>"
+        "<log4j:NDC><![CDATA[request]]></log4j:NDC>"
+        "<log4j:properties><log4j:data name=\"host\" value=\"db1\"/></log4j:properties>"
+        "</log4j:event>");
+    QCOMPARE(layout.format(event), expected);
+
+    QByteArray utf8("prefix:");
+    layout.formatTo(event, utf8);
+    QCOMPARE(utf8, "prefix:" + expected.toUtf8());
+}
+
+void Log4QtTest::XMLLayout_escaping()
+{
+    XMLLayout layout;
+    const QString special = QStringLiteral("<a href=\"x\">Tom & Jerry's</a>\n\u00E9") + QChar(0x01);
+    const LoggingEvent event(test_logger(), Level::INFO_INT, QStringLiteral("end ]]> of data \u00E9\t"),
+                             QString(), {{QStringLiteral("key"), special}},
+                             special, Q_INT64_C(0));
+
+    const QString formatted = layout.format(event);
+    const QString escaped = QStringLiteral(
+        "&lt;a href=&quot;x&quot;&gt;Tom &amp; Jerry&apos;s&lt;/a&gt;&#10;\u00E9\uFFFD");
+    QVERIFY2(formatted.contains(u"thread=\""_s + escaped + u'"'), qPrintable(formatted));
+    QVERIFY2(formatted.contains(u"value=\""_s + escaped + u'"'), qPrintable(formatted));
+    QVERIFY2(formatted.contains(QStringLiteral("<![CDATA[end ]]]]><![CDATA[> of data \u00E9\t]]>")),
+             qPrintable(formatted));
+
+    QXmlStreamReader reader(formatted);
+    reader.setNamespaceProcessing(false); // the log4j prefix is not declared in an event
+    QString message;
+    while (reader.readNext() != QXmlStreamReader::Invalid && !reader.atEnd())
+    {
+        if (reader.isStartElement() && reader.qualifiedName() == u"log4j:message"_s)
+            message = reader.readElementText();
+        else if (reader.isStartElement() && reader.qualifiedName() == u"log4j:data"_s)
+            QCOMPARE(reader.attributes().value(u"value"_s).toString(), special.chopped(1) + QChar(0xFFFD));
+    }
+    QCOMPARE(message, QStringLiteral("end ]]> of data \u00E9\t"));
+}
+
+void Log4QtTest::BinaryLayout_roundTrip()
+{
+    BinaryLayout layout;
+    const QString longMessage = QString(200, u'x') + QStringLiteral("\u00E9\U0001F600");
+    const LoggingEvent first(test_logger(), Level::WARN_INT, QStringLiteral("Disk almost full"),
+                             QStringLiteral("request"), {{QStringLiteral("host"), QStringLiteral("db1")}},
+                             QStringLiteral("main"), Q_INT64_C(1705314600123),
+                             MessageContext("disk.cpp", 42, "void check()"), QStringLiteral("storage"));
+    const LoggingEvent second(test_logger(), Level::DEBUG_INT, longMessage,
+                              QString(), {}, QStringLiteral("main"), Q_INT64_C(-5),
+                              MessageContext(), QString());
+
+    // As RandomAccessFileAppender does: format, then let the layout add
+    // what the file lacks in front of the record
+    QByteArray data;
+    qsizetype written = 0;
+    const auto write = [&](const LoggingEvent &event) {
+        QByteArray record;
+        layout.formatTo(event, record);
+        layout.formatPendingTo(data, written);
+        data += record;
+    };
+    layout.formatHeaderTo(data, false);
+    QVERIFY(data.startsWith("L4QB"));
+    write(first);
+    const qsizetype firstSize = data.size();
+    write(first);
+    // Repeated strings are written as dictionary ids
+    QVERIFY2(data.size() - firstSize < firstSize / 2, qPrintable(QString::number(data.size())));
+    write(second);
+
+    BinaryLogReader reader;
+    QVERIFY2(reader.read(data), qPrintable(reader.errorString()));
+    QCOMPARE(reader.events().size(), 3);
+
+    const LoggingEvent &decoded = reader.events().at(0);
+    QCOMPARE(decoded.logger(), test_logger());
+    QCOMPARE(decoded.level(), Level(Level::WARN_INT));
+    QCOMPARE(decoded.message(), first.message());
+    QCOMPARE(decoded.ndc(), first.ndc());
+    QCOMPARE(decoded.properties(), first.properties());
+    QCOMPARE(decoded.threadName(), first.threadName());
+    QCOMPARE(decoded.timeStamp(), first.timeStamp());
+    QCOMPARE(decoded.categoryName(), first.categoryName());
+    QCOMPARE(decoded.fileName(), QStringLiteral("disk.cpp"));
+    QCOMPARE(decoded.lineNumber(), 42);
+    QCOMPARE(decoded.functionName(), QStringLiteral("void check()"));
+
+    const LoggingEvent &last = reader.events().at(2);
+    QCOMPARE(last.message(), longMessage);
+    QCOMPARE(last.timeStamp(), Q_INT64_C(-5));
+    QVERIFY(last.context().file == nullptr);
+    QCOMPARE(last.lineNumber(), -1);
+
+    PatternLayout pattern(QStringLiteral("%p %c [%t] %F:%L - %m%n"));
+    QCOMPARE(pattern.format(decoded), pattern.format(first));
+}
+
+void Log4QtTest::BinaryLayout_definitionsOutOfOrder()
+{
+    // Readers do not rely on Define records preceding the events that use
+    // them
+    BinaryLayout layout;
+    const LoggingEvent event(test_logger(), Level::INFO_INT, QStringLiteral("message"),
+                             QString(), {}, QStringLiteral("worker"), Q_INT64_C(1000),
+                             MessageContext("a.cpp", 1, "f()"), QString());
+    QByteArray data;
+    layout.formatHeaderTo(data, false);
+    QByteArray referring;
+    layout.formatTo(event, referring);
+    layout.formatTo(event, referring);
+    QByteArray defining;
+    qsizetype written = 0;
+    layout.formatPendingTo(defining, written);
+    data += referring + defining;
+
+    // A later run appending to the file starts a session with its own ids
+    BinaryLayout next;
+    const LoggingEvent other(Logger::logger("Test::Other"), Level::ERROR_INT, QStringLiteral("again"),
+                             QString(), {}, QStringLiteral("gui"), Q_INT64_C(2000),
+                             MessageContext("b.cpp", 2, "g()"), QString());
+    next.formatHeaderTo(data, true);
+    QByteArray record;
+    next.formatTo(other, record);
+    qsizetype nextWritten = 0;
+    next.formatPendingTo(data, nextWritten);
+    data += record;
+
+    BinaryLogReader reader;
+    QVERIFY2(reader.read(data), qPrintable(reader.errorString()));
+    QCOMPARE(reader.events().size(), 3);
+    for (int i = 0; i < 2; ++i)
+    {
+        QCOMPARE(reader.events().at(i).threadName(), QStringLiteral("worker"));
+        QCOMPARE(reader.events().at(i).fileName(), QStringLiteral("a.cpp"));
+    }
+    QCOMPARE(reader.events().at(2).loggername(), QStringLiteral("Test::Other"));
+    QCOMPARE(reader.events().at(2).threadName(), QStringLiteral("gui"));
+    QCOMPARE(reader.events().at(2).functionName(), QStringLiteral("g()"));
+}
+
+void Log4QtTest::BinaryLayout_definitionsPerFile()
+{
+    // The event that adds a string to the dictionary may be dropped, or
+    // written after a rollover; every file still defines what it uses
+    BinaryLayout layout;
+    const LoggingEvent event(test_logger(), Level::INFO_INT, QStringLiteral("message"),
+                             QString(), {{QStringLiteral("user"), QStringLiteral("alice")}},
+                             QStringLiteral("worker"), Q_INT64_C(1000),
+                             MessageContext("a.cpp", 1, "f()"), QString());
+    QByteArray dropped;
+    layout.formatTo(event, dropped);
+
+    for (int file = 0; file < 2; ++file)
+    {
+        QByteArray data;
+        qsizetype written = 0;
+        layout.formatHeaderTo(data, false);
+        QByteArray record;
+        layout.formatTo(event, record);
+        layout.formatPendingTo(data, written);
+        data += record;
+
+        BinaryLogReader reader;
+        QVERIFY2(reader.read(data), qPrintable(reader.errorString()));
+        QCOMPARE(reader.events().size(), 1);
+        QCOMPARE(reader.events().at(0).threadName(), QStringLiteral("worker"));
+        QCOMPARE(reader.events().at(0).fileName(), QStringLiteral("a.cpp"));
+        QCOMPARE(reader.events().at(0).properties(), event.properties());
+    }
+
+    // Through the appender, which calls formatPendingTo() under its lock
+    const QString fileName = mTemporaryDirectory.path() + u"/BinaryLayout/definitionsPerFile.l4qb"_s;
+    RandomAccessFileAppender appender(LayoutSharedPtr(new BinaryLayout()), fileName);
+    appender.activateOptions();
+    appender.doAppend(event);
+    appender.doAppend(event);
+    appender.close();
+
+    QFile file(fileName);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    BinaryLogReader reader;
+    QVERIFY2(reader.read(file.readAll()), qPrintable(reader.errorString()));
+    QCOMPARE(reader.events().size(), 2);
+    QCOMPARE(reader.events().at(1).threadName(), QStringLiteral("worker"));
+}
+
+void Log4QtTest::BinaryLayout_missingDefinition()
+{
+    BinaryLayout layout;
+    const LoggingEvent event(test_logger(), Level::INFO_INT, QStringLiteral("message"),
+                             QString(), {}, QStringLiteral("worker"), Q_INT64_C(1000),
+                             MessageContext("a.cpp", 1, "f()"), QString());
+    QByteArray records;
+    layout.formatTo(event, records);
+    layout.formatTo(event, records);
+    QByteArray data;
+    layout.formatHeaderTo(data, false);
+    // Skip the Define records of the logger and thread names, ids 1 and 2
+    qsizetype written = 2;
+    layout.formatPendingTo(data, written);
+    data += records;
+
+    BinaryLogReader reader;
+    QVERIFY2(reader.read(data), qPrintable(reader.errorString()));
+    QCOMPARE(reader.events().size(), 2);
+    QCOMPARE(reader.unknownIdCount(), qsizetype(4));
+    for (const LoggingEvent &decoded : reader.events())
+    {
+        QCOMPARE(decoded.loggername(), QStringLiteral("<unknown #1>"));
+        QCOMPARE(decoded.threadName(), QStringLiteral("<unknown #2>"));
+        QCOMPARE(decoded.fileName(), QStringLiteral("a.cpp"));
+        QCOMPARE(decoded.message(), QStringLiteral("message"));
+    }
+}
+
+void Log4QtTest::BinaryLayout_damagedData()
+{
+    BinaryLayout layout;
+    const LoggingEvent event(test_logger(), Level::INFO_INT, QStringLiteral("complete"),
+                             QString(), {}, QStringLiteral("main"), Q_INT64_C(1000));
+    QByteArray records;
+    layout.formatTo(event, records);
+    layout.formatTo(event, records);
+    QByteArray data;
+    qsizetype written = 0;
+    layout.formatHeaderTo(data, false);
+    layout.formatPendingTo(data, written);
+    data += records;
+    data.chop(3);
+
+    BinaryLogReader reader;
+    QVERIFY(!reader.read(data));
+    QVERIFY2(reader.errorString().startsWith(u"Truncated record"_s), qPrintable(reader.errorString()));
+    QCOMPARE(reader.events().size(), 1);
+    QCOMPARE(reader.events().at(0).message(), QStringLiteral("complete"));
+
+    // A level that is no Level::Value is rejected, not passed on to Level
+    BinaryLayout levelLayout;
+    const LoggingEvent badLevel(test_logger(), Level(static_cast<Level::Value>(100)), QStringLiteral("bad"),
+                                QString(), {}, QStringLiteral("main"), Q_INT64_C(1000));
+    QByteArray badRecords;
+    levelLayout.formatTo(event, badRecords);
+    levelLayout.formatTo(badLevel, badRecords);
+    QByteArray badData;
+    written = 0;
+    levelLayout.formatHeaderTo(badData, false);
+    levelLayout.formatPendingTo(badData, written);
+    badData += badRecords;
+    BinaryLogReader levelReader;
+    QVERIFY(!levelReader.read(badData));
+    QVERIFY2(levelReader.errorString().startsWith(u"Corrupt event"_s), qPrintable(levelReader.errorString()));
+    QCOMPARE(levelReader.events().size(), 1);
+
+    BinaryLogReader text;
+    QVERIFY(!text.read(QByteArrayLiteral("INFO - not binary\n")));
+    QVERIFY(text.events().isEmpty());
+}
+
 
 void Log4QtTest::BasicConfigurator()
 {
@@ -1797,6 +2780,129 @@ void Log4QtTest::LoggingEvent_stream()
     QCOMPARE(loggingEvents()->list().count(), 0);
 }
 
+void Log4QtTest::LoggingEvent_sharesDiagnosticContext()
+{
+    MDC::put(QStringLiteral("request"), QStringLiteral("r1"));
+    MDC::put(QStringLiteral("user"), QStringLiteral("u1"));
+    NDC::push(QStringLiteral("outer"));
+
+    // Events take a reference to the thread's context, not a copy
+    const LoggingEvent first(test_logger(), Level::INFO_INT, QStringLiteral("first"));
+    const LoggingEvent second(test_logger(), Level::INFO_INT, QStringLiteral("second"));
+    QVERIFY(first.mdc().isSharedWith(second.mdc()));
+    QVERIFY(first.mdc().isSharedWith(MDC::context()));
+
+    // Unchanged values and unknown keys leave the snapshot shared
+    MDC::put(QStringLiteral("user"), QStringLiteral("u1"));
+    MDC::remove(QStringLiteral("unknown"));
+    QVERIFY(first.mdc().isSharedWith(MDC::context()));
+
+    // A change copies the context; earlier events keep what they captured
+    MDC::put(QStringLiteral("request"), QStringLiteral("r2"));
+    NDC::push(QStringLiteral("inner"));
+    const LoggingEvent third(test_logger(), Level::INFO_INT, QStringLiteral("third"));
+    QVERIFY(!first.mdc().isSharedWith(third.mdc()));
+    QCOMPARE(first.mdc().value(QStringLiteral("request")), QStringLiteral("r1"));
+    QCOMPARE(third.mdc().value(QStringLiteral("request")), QStringLiteral("r2"));
+    QCOMPARE(first.ndc(), QStringLiteral("outer"));
+    QCOMPARE(third.ndc(), QStringLiteral("inner"));
+
+    MDC::remove(QStringLiteral("request"));
+    MDC::remove(QStringLiteral("user"));
+    NDC::clear();
+    QVERIFY(MDC::context().isEmpty());
+    QCOMPARE(NDC::depth(), 0);
+}
+
+// Regression test: the per-thread MDC hash and NDC stack were thread_local
+// objects, so a thread_local destructor that ran after theirs and logged
+// used a destroyed container.
+void Log4QtTest::LoggingEvent_diagnosticContextAtThreadExit()
+{
+    struct LogsOnExit
+    {
+        ~LogsOnExit()
+        {
+            MDC::put(QStringLiteral("stage"), QStringLiteral("exit"));
+            NDC::push(QStringLiteral("exit"));
+            *mdc = MDC::context();
+            *ndc = NDC::peek();
+        }
+        QHash<QString, QString> *mdc = nullptr;
+        QString *ndc = nullptr;
+    };
+
+    QHash<QString, QString> mdc;
+    QString ndc;
+    std::unique_ptr<QThread> thread(QThread::create([&mdc, &ndc]() {
+        // Constructed before the context, so destroyed after it
+        static thread_local LogsOnExit logsOnExit;
+        logsOnExit.mdc = &mdc;
+        logsOnExit.ndc = &ndc;
+        MDC::put(QStringLiteral("stage"), QStringLiteral("run"));
+        NDC::push(QStringLiteral("run"));
+    }));
+    thread->start();
+    QVERIFY(thread->wait());
+
+    QCOMPARE(mdc, (QHash<QString, QString>{{QStringLiteral("stage"), QStringLiteral("exit")}}));
+    QCOMPARE(ndc, QStringLiteral("exit"));
+}
+
+void Log4QtTest::LoggingEvent_sequenceNumbers_data()
+{
+    QTest::addColumn<bool>("global");
+
+    QTest::newRow("thread blocks") << false;
+    QTest::newRow("global") << true;
+}
+
+void Log4QtTest::LoggingEvent_sequenceNumbers()
+{
+    QFETCH(bool, global);
+
+    const auto previousMode = LoggingEvent::sequenceNumberMode();
+    LoggingEvent::setSequenceNumberMode(global ? LoggingEvent::SequenceNumberMode::Global
+                                               : LoggingEvent::SequenceNumberMode::ThreadBlocks);
+
+    const int threadCount = 4;
+    const int perThread = 1000;
+    QList<QList<qint64>> numbers(threadCount);
+    QList<QThread *> threads;
+    for (int t = 0; t < threadCount; ++t)
+    {
+        threads << QThread::create([&numbers, t, perThread]() {
+            for (int i = 0; i < perThread; ++i)
+                numbers[t].append(LoggingEvent(test_logger(), Level::INFO_INT, QString()).sequenceNumber());
+        });
+        threads.last()->start();
+    }
+    for (auto *thread : std::as_const(threads))
+    {
+        thread->wait();
+        delete thread;
+    }
+    LoggingEvent::setSequenceNumberMode(previousMode);
+
+    // Unique across threads and increasing within each thread
+    QSet<qint64> seen;
+    for (const auto &perThreadNumbers : std::as_const(numbers))
+    {
+        QCOMPARE(perThreadNumbers.size(), perThread);
+        QVERIFY(std::is_sorted(perThreadNumbers.cbegin(), perThreadNumbers.cend()));
+        for (qint64 number : perThreadNumbers)
+            seen.insert(number);
+    }
+    QCOMPARE(seen.size(), threadCount * perThread);
+
+    // The global counter hands out one contiguous range
+    if (global)
+    {
+        const auto [min, max] = std::minmax_element(seen.cbegin(), seen.cend());
+        QCOMPARE(*max - *min + 1, qint64(threadCount * perThread));
+    }
+}
+
 void Log4QtTest::LoggingEvent_threadName()
 {
     // Verify that a named thread produces the thread name
@@ -58,6 +58,9 @@ private Q_SLOTS:
 
     void DateTime_milliseconds_data();
     void DateTime_milliseconds();
+    void DateTimeFormatter_data();
+    void DateTimeFormatter();
+    void DateTimeFormatter_providerTimeZone();
     void PatternFormatter_data();
     void PatternFormatter();
     void PatternFormatter_propertySource();
@@ -103,23 +106,56 @@ private Q_SLOTS:
     void StringMatchFilter();
     void StringMatchFilterCaseInsensitive_data();
     void StringMatchFilterCaseInsensitive();
+    void MultiStringMatchFilter_data();
+    void MultiStringMatchFilter();
+    void MultiStringMatchFilter_splitStrings();
+    void RegexFilter_data();
+    void RegexFilter();
+    void RegexFilter_invalidRegex();
+    void MdcMatchFilter_data();
+    void MdcMatchFilter();
 
     // log4qt
     void AppenderSkeleton_threshold();
     void AppenderSkeleton_filter_data();
     void AppenderSkeleton_filter();
     void AppenderSkeleton_clearFilters();
+    void AppenderSkeleton_settersRepublishConfiguration();
     void AppenderSkeleton_internalErrorsReachOtherAppenders();
     void AppenderSkeleton_recursionGuardBlocksSelfOnly();
     void Logger_logWithLocationHonoursLevel();
+    void Logger_effectiveLevelFollowsHierarchyChanges();
+    void Logger_dispatchPlanFollowsAppenderChanges();
+    void Logger_formatString();
+    void Logger_abbreviatedName_data();
+    void Logger_abbreviatedName();
+    void LogStream_reusedStreamsStartClean();
+    void Logger_deferredFormatting();
+    void CallSite_modeOverridesLoggerLevel();
+    void CallSite_preEncodedLocation();
     void Hierarchy_signalSlotsMayQueryRepositoryDuringReset();
+    void Hierarchy_lookupAcceptsEverySpelling();
+    void LogManager_qtMessagesUseCategoryLoggers();
     void PatternLayout_patternEndingInOptionCharacter();
+    void PatternLayout_nonAsciiLocation();
+    void StaticPatternLayout_matchesPatternLayout();
+    void XMLLayout_format();
+    void XMLLayout_escaping();
+    void BinaryLayout_roundTrip();
+    void BinaryLayout_definitionsOutOfOrder();
+    void BinaryLayout_definitionsPerFile();
+    void BinaryLayout_missingDefinition();
+    void BinaryLayout_damagedData();
     void BasicConfigurator();
     void FileAppender();
     void RollingFileAppender_dateSuffix();
     void LoggingEvent_stream_data();
     void LoggingEvent_stream();
     void LoggingEvent_threadName();
+    void LoggingEvent_sharesDiagnosticContext();
+    void LoggingEvent_diagnosticContextAtThreadExit();
+    void LoggingEvent_sequenceNumbers_data();
+    void LoggingEvent_sequenceNumbers();
     void LoggingEvent_threadNameReactive();
     void LoggingEvent_workerThreadDeleteLater();
     void MessageContext_source_location();
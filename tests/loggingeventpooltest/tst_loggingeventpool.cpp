@@ -0,0 +1,171 @@
+/******************************************************************************
+ *
+ * This file is part of Log4Qt library.
+ *
+ * Copyright (C) 2007 - 2026 Log4Qt contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+#include <QTest>
+#include <QSemaphore>
+#include <QThread>
+
+#include <atomic>
+#include <cstdlib>
+#include <functional>
+#include <new>
+#include <vector>
+
+#include "log4qt/logger.h"
+#include "log4qt/loggingevent.h"
+#include "log4qt/logmanager.h"
+
+using namespace Log4Qt;
+
+// Counts every global allocation while gCounting is set. The replacement
+// is process wide on ELF and Mach-O platforms, so allocations made inside
+// the log4qt library are seen as well.
+static std::atomic<bool> gCounting{false};
+static std::atomic<qint64> gAllocations{0};
+
+void *operator new(std::size_t size)
+{
+    if (gCounting.load(std::memory_order_relaxed))
+        gAllocations.fetch_add(1, std::memory_order_relaxed);
+    if (void *ptr = std::malloc(size ? size : 1))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void operator delete(void *ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+class LoggingEventPoolTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void steadyStateDoesNotAllocate();
+    void crossThreadReleaseDoesNotAllocate();
+
+private:
+    static qint64 countAllocations(const std::function<void()> &function);
+
+    Logger *mLogger = nullptr;
+    QString mMessage;
+};
+
+void LoggingEventPoolTest::initTestCase()
+{
+#ifdef Q_OS_WIN
+    QSKIP("Replacing operator new does not reach into the log4qt DLL");
+#endif
+    mLogger = LogManager::logger(QStringLiteral("Test::LoggingEventPool"));
+    mMessage = QStringLiteral("pooled event");
+}
+
+qint64 LoggingEventPoolTest::countAllocations(const std::function<void()> &function)
+{
+    gAllocations.store(0);
+    gCounting.store(true);
+    function();
+    gCounting.store(false);
+    return gAllocations.load();
+}
+
+void LoggingEventPoolTest::steadyStateDoesNotAllocate()
+{
+    constexpr int eventCount = 64;
+    std::vector<LoggingEvent> events;
+    events.reserve(eventCount);
+
+    auto logRound = [&]()
+    {
+        for (int i = 0; i < eventCount; ++i)
+            events.emplace_back(mLogger, Level::INFO_INT, mMessage);
+        events.clear();
+    };
+
+    // Fills the pool and the per-thread caches (thread name, ...)
+    logRound();
+    logRound();
+
+    QCOMPARE(countAllocations([&]()
+    {
+        for (int round = 0; round < 100; ++round)
+            logRound();
+    }), qint64(0));
+}
+
+void LoggingEventPoolTest::crossThreadReleaseDoesNotAllocate()
+{
+    // Events are created here and released on the consumer thread, the way
+    // an AsyncAppender worker releases them.
+    constexpr int eventCount = 64;
+    constexpr int rounds = 100;
+    std::vector<LoggingEvent> events;
+    events.reserve(eventCount);
+
+    QSemaphore produced;
+    QSemaphore consumed;
+    std::atomic<bool> stop{false};
+    QThread *consumer = QThread::create([&]()
+    {
+        for (;;)
+        {
+            produced.acquire();
+            if (stop.load())
+                return;
+            events.clear();
+            consumed.release();
+        }
+    });
+    consumer->start();
+
+    auto logRound = [&]()
+    {
+        for (int i = 0; i < eventCount; ++i)
+            events.emplace_back(mLogger, Level::INFO_INT, mMessage);
+        produced.release();
+        consumed.acquire();
+    };
+
+    logRound();
+    logRound();
+
+    const qint64 allocations = countAllocations([&]()
+    {
+        for (int round = 0; round < rounds; ++round)
+            logRound();
+    });
+
+    stop.store(true);
+    produced.release();
+    consumer->wait();
+    delete consumer;
+
+    QCOMPARE(allocations, qint64(0));
+}
+
+QTEST_MAIN(LoggingEventPoolTest)
+#include "tst_loggingeventpool.moc"
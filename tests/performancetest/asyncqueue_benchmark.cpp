@@ -0,0 +1,149 @@
+/******************************************************************************
+ *
+ * This file is part of Log4Qt library.
+ *
+ * Copyright (C) 2007 - 2026 Log4Qt contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+/*
+ * Contention benchmark for AsyncAppender producers.
+ *
+ * N producer threads log a fixed total of LoggingEvents through
+ * AsyncAppender::doAppend() — filters, dispatch and enqueue, as a logger
+ * does — while the appender's worker delivers them to a counting appender.
+ * Compares the mutex-based BoundedBlockingQueue with the lock-free
+ * MpscRingQueue for 1 to 64 producers. The total is fixed, so the reported
+ * time per iteration is directly comparable across rows: flat means
+ * producers scale, rising means they serialise on the appender.
+ */
+
+#include <QtTest>
+#include <QThread>
+
+#include "log4qt/appenderskeleton.h"
+#include "log4qt/asyncappender.h"
+#include "log4qt/level.h"
+#include "log4qt/logger.h"
+#include "log4qt/loggingevent.h"
+
+#include <atomic>
+#include <memory>
+
+using namespace Log4Qt;
+
+namespace
+{
+constexpr int TotalEvents = 64 * 1024;
+constexpr int QueueCapacity = 1024;
+
+// Counts the events the worker delivers, so the benchmark measures the
+// producer side rather than a layout or a device.
+class CountingAppender : public AppenderSkeleton
+{
+public:
+    bool requiresLayout() const override { return false; }
+    int count() const { return mCount.load(std::memory_order_relaxed); }
+
+protected:
+    void append(const LoggingEvent & /*event*/) override
+    {
+        mCount.fetch_add(1, std::memory_order_relaxed);
+    }
+
+private:
+    std::atomic<int> mCount{0};
+};
+}
+
+class AsyncQueueBenchmark : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void producerContention_data();
+    void producerContention();
+
+private:
+    std::unique_ptr<LoggingEvent> mEvent;
+};
+
+void AsyncQueueBenchmark::initTestCase()
+{
+    mEvent = std::make_unique<LoggingEvent>(
+        Logger::logger(QStringLiteral("benchmark.async.Queue")), Level::INFO_INT,
+        QStringLiteral("Processing request 12345 for user alice took 42ms"));
+}
+
+void AsyncQueueBenchmark::producerContention_data()
+{
+    QTest::addColumn<AsyncAppender::QueueImplementation>("implementation");
+    QTest::addColumn<int>("producers");
+
+    for (int producers : {1, 2, 4, 8, 16, 32, 64})
+    {
+        QTest::addRow("Blocking, %d producers", producers) << AsyncAppender::QueueImplementation::Blocking << producers;
+        QTest::addRow("LockFree, %d producers", producers) << AsyncAppender::QueueImplementation::LockFree << producers;
+    }
+}
+
+void AsyncQueueBenchmark::producerContention()
+{
+    QFETCH(AsyncAppender::QueueImplementation, implementation);
+    QFETCH(int, producers);
+
+    const int perProducer = TotalEvents / producers;
+    const int expected = perProducer * producers;
+    const LoggingEvent &event = *mEvent;
+    int delivered = 0;
+
+    QBENCHMARK {
+        auto *counter = new CountingAppender;
+        AppenderSharedPtr counterRef(counter);
+        AppenderSharedPtr appender(new AsyncAppender);
+        auto *async = static_cast<AsyncAppender *>(appender.data());
+        async->setBufferSize(QueueCapacity);
+        async->setQueueImplementation(implementation);
+        async->addAppender(counterRef);
+        async->activateOptions();
+
+        QList<QThread *> threads;
+        for (int p = 0; p < producers; ++p)
+        {
+            threads << QThread::create([async, &event, perProducer]() {
+                for (int i = 0; i < perProducer; ++i)
+                    async->doAppend(event);
+            });
+            threads.last()->start();
+        }
+
+        for (auto *thread : std::as_const(threads))
+        {
+            thread->wait();
+            delete thread;
+        }
+        // close() drains the queue before it returns
+        async->close();
+        delivered = counter->count();
+    }
+
+    QCOMPARE(delivered, expected);
+}
+
+QTEST_MAIN(AsyncQueueBenchmark)
+
+#include "asyncqueue_benchmark.moc"
@@ -26,11 +26,14 @@
 #include "log4qt/logger.h"
 #include "log4qt/logmanager.h"
 #include "log4qt/fileappender.h"
+#include "log4qt/jsonlayout.h"
 #include "log4qt/randomaccessfileappender.h"
 #include "log4qt/patternlayout.h"
 #include "log4qt/simplelayout.h"
 #include "log4qt/varia/nullappender.h"
 #include "log4qt/varia/levelmatchfilter.h"
+#include "log4qt/varia/multistringmatchfilter.h"
+#include "log4qt/varia/stringmatchfilter.h"
 #include "log4qt/helpers/datetime.h"
 #include <QDir>
 #include <QFile>
@@ -345,6 +348,80 @@ void PerformanceTest::testFilteringPerformance()
     logger->removeAllAppenders();
 }
 
+void PerformanceTest::testStringMatchFilters_data()
+{
+    QTest::addColumn<int>("stringCount");
+    QTest::addColumn<bool>("multi");
+    QTest::addColumn<int>("iterations");
+
+    for (int count : {1, 5, 20, 50})
+    {
+        QTest::addRow("%d chained StringMatchFilters", count) << count << false << 10000;
+        QTest::addRow("MultiStringMatchFilter, %d strings", count) << count << true << 10000;
+    }
+}
+
+void PerformanceTest::testStringMatchFilters()
+{
+    QFETCH(int, stringCount);
+    QFETCH(bool, multi);
+    QFETCH(int, iterations);
+
+    // Noise strings that do not occur in the message: the worst case, every
+    // filter has to scan the whole message.
+    QStringList strings;
+    for (int i = 0; i < stringCount; ++i)
+        strings << QStringLiteral("noisy component %1 status").arg(i);
+
+    Log4Qt::FilterSharedPtr head;
+    if (multi)
+    {
+        auto *filter = new Log4Qt::MultiStringMatchFilter();
+        filter->setDenyStringList(strings);
+        head = Log4Qt::FilterSharedPtr(filter);
+    }
+    else
+    {
+        Log4Qt::FilterSharedPtr tail;
+        for (const auto &string : std::as_const(strings))
+        {
+            Log4Qt::FilterSharedPtr filter(new Log4Qt::StringMatchFilter());
+            auto *stringMatch = static_cast<Log4Qt::StringMatchFilter *>(filter.data());
+            stringMatch->setStringToMatch(string);
+            stringMatch->setAcceptOnMatch(false);
+            if (tail)
+                tail->setNext(filter);
+            else
+                head = filter;
+            tail = filter;
+        }
+    }
+
+    const Log4Qt::LoggingEvent event(Log4Qt::Logger::rootLogger(), Log4Qt::Level::INFO_INT,
+                                     QStringLiteral("Request 4711 from client 10.0.0.17 completed in 12 ms "
+                                                    "with status 200 and 5321 bytes of payload"));
+    int denied = 0;
+    QBENCHMARK
+    {
+        for (int i = 0; i < iterations; ++i)
+        {
+            // Walk the chain as AppenderSkeleton does
+            for (auto filter = head; filter; filter = filter->next())
+            {
+                const auto decision = filter->decide(event);
+                if (decision == Log4Qt::Filter::Deny)
+                {
+                    ++denied;
+                    break;
+                }
+                if (decision == Log4Qt::Filter::Accept)
+                    break;
+            }
+        }
+    }
+    QCOMPARE(denied, 0);
+}
+
 void PerformanceTest::testTimestampCacheWindowPerformance_data()
 {
     QTest::addColumn<int>("cacheWindowMs");
@@ -492,16 +569,92 @@ void PerformanceTest::testPatternFormatterOptimization()
     logger->removeAllAppenders();
 }
 
+void PerformanceTest::testPatternLayoutFormatTo_data()
+{
+    QTest::addColumn<QString>("pattern");
+    QTest::addColumn<bool>("direct");
+    QTest::addColumn<int>("iterations");
+
+    const QString pattern = u"%d{ISO8601} [%t] %-5p %c - %m%n"_s;
+    QTest::newRow("format().toUtf8(), 100000 iter") << pattern << false << 100000;
+    QTest::newRow("formatTo(), 100000 iter") << pattern << true << 100000;
+}
+
+void PerformanceTest::testPatternLayoutFormatTo()
+{
+    QFETCH(QString, pattern);
+    QFETCH(bool, direct);
+    QFETCH(int, iterations);
+
+    // What RandomAccessFileAppender::preAppend() does per event
+    Log4Qt::PatternLayout layout(pattern);
+    const Log4Qt::LoggingEvent event(Log4Qt::Logger::logger(u"Perf::Component"_s), Log4Qt::Level::INFO_INT,
+                                     QStringLiteral("Request 4711 from client 10.0.0.17 completed in 12 ms"));
+    QByteArray buffer;
+    QBENCHMARK
+    {
+        for (int i = 0; i < iterations; ++i)
+        {
+            buffer.clear();
+            if (direct)
+                layout.formatTo(event, buffer);
+            else
+                buffer = layout.format(event).toUtf8();
+        }
+    }
+    QVERIFY(buffer.endsWith("12 ms\n"));
+}
+
+void PerformanceTest::testJsonLayoutFormatTo_data()
+{
+    QTest::addColumn<bool>("direct");
+    QTest::addColumn<int>("iterations");
+
+    QTest::newRow("format().toUtf8(), 100000 iter") << false << 100000;
+    QTest::newRow("formatTo(), 100000 iter") << true << 100000;
+}
+
+void PerformanceTest::testJsonLayoutFormatTo()
+{
+    QFETCH(bool, direct);
+    QFETCH(int, iterations);
+
+    Log4Qt::JsonLayout layout;
+    layout.setIncludeMdc(true);
+    const QHash<QString, QString> mdc{{u"requestId"_s, u"4711"_s}};
+    const Log4Qt::LoggingEvent event(Log4Qt::Logger::logger(u"Perf::Component"_s), Log4Qt::Level::INFO_INT,
+                                     QStringLiteral("Request 4711 from client \"10.0.0.17\" completed in 12 ms"),
+                                     QString(), mdc, u"worker-1"_s, QDateTime::currentMSecsSinceEpoch());
+    QByteArray buffer;
+    QBENCHMARK
+    {
+        for (int i = 0; i < iterations; ++i)
+        {
+            buffer.clear();
+            if (direct)
+                layout.formatTo(event, buffer);
+            else
+                buffer = layout.format(event).toUtf8();
+        }
+    }
+    QVERIFY(buffer.endsWith("}\n"));
+}
+
 void PerformanceTest::testLogStreamLazyInit_data()
 {
     QTest::addColumn<QString>("level");
     QTest::addColumn<bool>("enabled");
     QTest::addColumn<int>("iterations");
+    QTest::addColumn<int>("extraInserts");
 
-    QTest::newRow("DEBUG enabled, 100000 msgs") << "DEBUG" << true << 100000;
-    QTest::newRow("DEBUG disabled, 100000 msgs") << "DEBUG" << false << 100000;
-    QTest::newRow("INFO enabled, 100000 msgs") << "INFO" << true << 100000;
-    QTest::newRow("INFO disabled, 100000 msgs") << "INFO" << false << 100000;
+    QTest::newRow("DEBUG enabled, 100000 msgs") << "DEBUG" << true << 100000 << 0;
+    QTest::newRow("DEBUG disabled, 100000 msgs") << "DEBUG" << false << 100000 << 0;
+    QTest::newRow("INFO enabled, 100000 msgs") << "INFO" << true << 100000 << 0;
+    QTest::newRow("INFO disabled, 100000 msgs") << "INFO" << false << 100000 << 0;
+    // Enabled path with longer statements: exercises the reused stream
+    // buffers growing and being reset
+    QTest::newRow("INFO enabled, 8 extra inserts, 100000 msgs") << "INFO" << true << 100000 << 8;
+    QTest::newRow("INFO enabled, 32 extra inserts, 100000 msgs") << "INFO" << true << 100000 << 32;
 }
 
 void PerformanceTest::testLogStreamLazyInit()
@@ -509,6 +662,7 @@ void PerformanceTest::testLogStreamLazyInit()
     QFETCH(QString, level);
     QFETCH(bool, enabled);
     QFETCH(int, iterations);
+    QFETCH(int, extraInserts);
 
     // Setup logger
     auto logger = Log4Qt::Logger::rootLogger();
@@ -536,10 +690,10 @@ void PerformanceTest::testLogStreamLazyInit()
     {
         for (int i = 0; i < iterations; ++i)
         {
-            if (level == "DEBUG")
-                logger->debug() << "LogStream benchmark message " << i;
-            else
-                logger->info() << "LogStream benchmark message " << i;
+            Log4Qt::LogStream stream = level == "DEBUG" ? logger->debug() : logger->info();
+            stream << "LogStream benchmark message " << i;
+            for (int j = 0; j < extraInserts; ++j)
+                stream << ", field " << j;
         }
     }
 
@@ -815,6 +969,8 @@ void PerformanceTest::testISO8601FormattingPerformance_data()
     QTest::newRow("ISO8601, unique ms (cache miss), 100000") << "ISO8601_unique" << 100000;
     QTest::newRow("ABSOLUTE, same ms (cache hit), 100000")   << "ABSOLUTE"       << 100000;
     QTest::newRow("custom format, 10000")                    << "hh:mm:ss"       << 10000;
+    QTest::newRow("custom ISO with T, unique ms, 100000")
+        << "yyyy-MM-dd'T'HH:mm:ss.zzzttt_unique" << 100000;
 }
 
 void PerformanceTest::testISO8601FormattingPerformance()
@@ -57,6 +57,9 @@ private slots:
     
     void testFilteringPerformance();
     void testFilteringPerformance_data();
+
+    void testStringMatchFilters();
+    void testStringMatchFilters_data();
     
     void testTimestampCacheWindowPerformance();
     void testTimestampCacheWindowPerformance_data();
@@ -77,6 +80,11 @@ private slots:
     void testPatternFormatterOptimization();
     void testPatternFormatterOptimization_data();
 
+    void testPatternLayoutFormatTo();
+    void testPatternLayoutFormatTo_data();
+    void testJsonLayoutFormatTo();
+    void testJsonLayoutFormatTo_data();
+
     // LogStream tests
     void testLogStreamLazyInit();
     void testLogStreamLazyInit_data();
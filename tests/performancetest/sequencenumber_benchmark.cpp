@@ -0,0 +1,111 @@
+/******************************************************************************
+ *
+ * This file is part of Log4Qt library.
+ *
+ * Copyright (C) 2007 - 2026 Log4Qt contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+/*
+ * Scaling benchmark for LoggingEvent sequence number allocation.
+ *
+ * N threads construct a fixed total of LoggingEvents, once with every event
+ * incrementing the shared counter (SequenceNumberMode::Global) and once with
+ * each thread numbering from its own block (SequenceNumberMode::ThreadBlocks).
+ * The total is fixed, so the reported time per iteration is comparable
+ * across rows: the gap between the modes is the cost of the counter's cache
+ * line bouncing between cores.
+ */
+
+#include <QtTest>
+#include <QThread>
+
+#include "log4qt/level.h"
+#include "log4qt/logger.h"
+#include "log4qt/loggingevent.h"
+
+using namespace Log4Qt;
+
+namespace
+{
+constexpr int TotalEvents = 256 * 1024;
+}
+
+Q_DECLARE_METATYPE(LoggingEvent::SequenceNumberMode)
+
+class SequenceNumberBenchmark : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void cleanupTestCase();
+
+    void eventConstruction_data();
+    void eventConstruction();
+};
+
+void SequenceNumberBenchmark::cleanupTestCase()
+{
+    LoggingEvent::setSequenceNumberMode(LoggingEvent::SequenceNumberMode::ThreadBlocks);
+}
+
+void SequenceNumberBenchmark::eventConstruction_data()
+{
+    QTest::addColumn<LoggingEvent::SequenceNumberMode>("mode");
+    QTest::addColumn<int>("threads");
+
+    for (int threads : {1, 2, 4, 8, 16, 32, 64})
+    {
+        QTest::addRow("Global, %d threads", threads)
+            << LoggingEvent::SequenceNumberMode::Global << threads;
+        QTest::addRow("ThreadBlocks, %d threads", threads)
+            << LoggingEvent::SequenceNumberMode::ThreadBlocks << threads;
+    }
+}
+
+void SequenceNumberBenchmark::eventConstruction()
+{
+    QFETCH(LoggingEvent::SequenceNumberMode, mode);
+    QFETCH(int, threads);
+
+    LoggingEvent::setSequenceNumberMode(mode);
+    const Logger *logger = Logger::logger(QStringLiteral("benchmark.sequence.Number"));
+    const QString message = QStringLiteral("Processing request 12345 for user alice took 42ms");
+    const int perThread = TotalEvents / threads;
+
+    QBENCHMARK {
+        QList<QThread *> workers;
+        for (int t = 0; t < threads; ++t)
+        {
+            workers << QThread::create([logger, &message, perThread]() {
+                qint64 last = 0;
+                for (int i = 0; i < perThread; ++i)
+                    last = LoggingEvent(logger, Level::INFO_INT, message).sequenceNumber();
+                Q_UNUSED(last)
+            });
+            workers.last()->start();
+        }
+
+        for (auto *worker : std::as_const(workers))
+        {
+            worker->wait();
+            delete worker;
+        }
+    }
+}
+
+QTEST_MAIN(SequenceNumberBenchmark)
+
+#include "sequencenumber_benchmark.moc"
@@ -38,6 +38,9 @@
 #include "log4qt/spi/headerfooterprovider.h"
 #include "log4qt/ttcclayout.h"
 #include "log4qt/varia/levelmatchfilter.h"
+#include "log4qt/varia/mdcmatchfilter.h"
+#include "log4qt/varia/multistringmatchfilter.h"
+#include "log4qt/varia/regexfilter.h"
 #include "log4qt/varia/stringmatchfilter.h"
 #include "log4qt/loggerrepository.h"
 
@@ -85,6 +88,8 @@ private Q_SLOTS:
     void testCircularSubstitution();
     void testSubstitutionWithLiteralClosingBrace();
     void testEnumPropertyFromConfig();
+    void testMultiStringMatchFilterFromConfig();
+    void testRegexAndMdcMatchFilterFromConfig();
     void testPropertiesLineContinuation();
     // HeaderFooterProvider configuration tests
     void testGlobalHeaderFooterProvider();
@@ -818,6 +823,68 @@ void PropertyConfiguratorTest::testEnumPropertyFromConfig()
     QCOMPARE(stringMatch->caseSensitivity(), Qt::CaseInsensitive);
 }
 
+void PropertyConfiguratorTest::testMultiStringMatchFilterFromConfig()
+{
+    Properties props;
+    props.setProperty(u"appender.console.type"_s, u"Console"_s);
+    props.setProperty(u"appender.console.layout.type"_s, u"SimpleLayout"_s);
+    props.setProperty(u"appender.console.filter.f1.type"_s, u"MultiStringMatch"_s);
+    props.setProperty(u"appender.console.filter.f1.denyStrings"_s, u"heartbeat|a\\|b"_s);
+    props.setProperty(u"appender.console.filter.f1.acceptStrings"_s, u"error"_s);
+    props.setProperty(u"appender.console.filter.f1.caseSensitivity"_s,
+                      u"CaseInsensitive"_s);
+    props.setProperty(u"rootLogger.level"_s, u"ALL"_s);
+    props.setProperty(u"rootLogger.appenderRef.0.ref"_s, u"console"_s);
+
+    QVERIFY(PropertyConfigurator::configure(props));
+
+    Logger *root = LogManager::rootLogger();
+    auto *consoleApp = qobject_cast<ConsoleAppender *>(root->appenders().first().data());
+    QVERIFY(consoleApp);
+
+    auto *multiMatch =
+        qobject_cast<MultiStringMatchFilter *>(consoleApp->filter().data());
+    QVERIFY(multiMatch);
+    QCOMPARE(multiMatch->denyStringList(), QStringList({u"heartbeat"_s, u"a|b"_s}));
+    QCOMPARE(multiMatch->acceptStringList(), QStringList({u"error"_s}));
+    QCOMPARE(multiMatch->caseSensitivity(), Qt::CaseInsensitive);
+}
+
+void PropertyConfiguratorTest::testRegexAndMdcMatchFilterFromConfig()
+{
+    Properties props;
+    props.setProperty(u"appender.console.type"_s, u"Console"_s);
+    props.setProperty(u"appender.console.layout.type"_s, u"SimpleLayout"_s);
+    props.setProperty(u"appender.console.filter.f1.type"_s, u"Regex"_s);
+    props.setProperty(u"appender.console.filter.f1.regex"_s, u"^eu-"_s);
+    props.setProperty(u"appender.console.filter.f1.target"_s, u"MDC:region"_s);
+    props.setProperty(u"appender.console.filter.f1.acceptOnMatch"_s, u"false"_s);
+    props.setProperty(u"appender.console.filter.f2.type"_s, u"MdcMatch"_s);
+    props.setProperty(u"appender.console.filter.f2.predicates"_s, u"user=alice|tenant=acme"_s);
+    props.setProperty(u"appender.console.filter.f2.matchAll"_s, u"false"_s);
+    props.setProperty(u"rootLogger.level"_s, u"ALL"_s);
+    props.setProperty(u"rootLogger.appenderRef.0.ref"_s, u"console"_s);
+
+    QVERIFY(PropertyConfigurator::configure(props));
+
+    Logger *root = LogManager::rootLogger();
+    auto *consoleApp = qobject_cast<ConsoleAppender *>(root->appenders().first().data());
+    QVERIFY(consoleApp);
+
+    auto *regex = qobject_cast<RegexFilter *>(consoleApp->filter().data());
+    QVERIFY(regex);
+    QVERIFY(regex->isValid());
+    QCOMPARE(regex->regex(), u"^eu-"_s);
+    QCOMPARE(regex->target(), u"MDC:region"_s);
+    QVERIFY(!regex->acceptOnMatch());
+
+    auto *mdcMatch = qobject_cast<MdcMatchFilter *>(regex->next().data());
+    QVERIFY(mdcMatch);
+    QCOMPARE(mdcMatch->predicateList().size(), 2);
+    QCOMPARE(mdcMatch->predicates(), u"user=alice|tenant=acme"_s);
+    QVERIFY(!mdcMatch->matchAll());
+}
+
 // Regression test: the line-continuation check treated ANY line ending in a
 // backslash as continued — a value ending in an escaped backslash swallowed
 // the next property line, and a comment ending in '\' absorbed the following
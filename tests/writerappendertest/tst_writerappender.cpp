@@ -23,6 +23,7 @@
 #include <QTextStream>
 
 #include <atomic>
+#include <vector>
 
 #include "log4qt/writerappender.h"
 #include "log4qt/loggingevent.h"
@@ -66,6 +67,8 @@ private Q_SLOTS:
 
     void WriterAppender_basicAppend();
     void WriterAppender_writerRemovedBetweenPhasesIsSafe();
+    void WriterAppender_appendBatch();
+    void WriterAppender_writerRemovedDuringBatchIsSafe();
 };
 
 void WriterAppenderTest::cleanup()
@@ -125,5 +128,56 @@ void WriterAppenderTest::WriterAppender_writerRemovedBetweenPhasesIsSafe()
     QVERIFY(!buffer.data().contains("after removal"));
 }
 
+void WriterAppenderTest::WriterAppender_appendBatch()
+{
+    QBuffer buffer;
+    QVERIFY(buffer.open(QIODevice::WriteOnly));
+    QTextStream stream(&buffer);
+
+    WriterAppender appender;
+    appender.setName(QStringLiteral("Writer"));
+    appender.setLayout(LayoutSharedPtr(new SimpleLayout));
+    appender.setWriter(&stream);
+    appender.setThreshold(Level::INFO_INT);
+    appender.activateOptions();
+
+    const std::vector<LoggingEvent> events {
+        LoggingEvent(test_logger(), Level::INFO_INT, QStringLiteral("batch one")),
+        LoggingEvent(test_logger(), Level::DEBUG_INT, QStringLiteral("below threshold")),
+        LoggingEvent(test_logger(), Level::WARN_INT, QStringLiteral("batch two")),
+    };
+    appender.doAppendBatch(events);
+    appender.setWriter(nullptr); // detach before the local stream dies
+
+    const QByteArray written = buffer.data();
+    QVERIFY(written.contains("batch one"));
+    QVERIFY(!written.contains("below threshold"));
+    QVERIFY(written.indexOf("batch one") < written.indexOf("batch two"));
+}
+
+// The batch path re-validates the entry conditions per event as well.
+void WriterAppenderTest::WriterAppender_writerRemovedDuringBatchIsSafe()
+{
+    QBuffer buffer;
+    QVERIFY(buffer.open(QIODevice::WriteOnly));
+    QTextStream stream(&buffer);
+
+    WriterRemovingAppender appender;
+    appender.setName(QStringLiteral("Writer"));
+    appender.setLayout(LayoutSharedPtr(new SimpleLayout));
+    appender.setWriter(&stream);
+    appender.activateOptions();
+
+    appender.removeWriterOnNextAppend();
+    const std::vector<LoggingEvent> events {
+        LoggingEvent(test_logger(), Level::INFO_INT, QStringLiteral("during removal")),
+        LoggingEvent(test_logger(), Level::INFO_INT, QStringLiteral("after removal")),
+    };
+    appender.doAppendBatch(events);
+
+    QVERIFY(!buffer.data().contains("during removal"));
+    QVERIFY(!buffer.data().contains("after removal"));
+}
+
 QTEST_MAIN(WriterAppenderTest)
 #include "tst_writerappender.moc"
@@ -0,0 +1,162 @@
+/******************************************************************************
+ *
+ * This file is part of Log4Qt library.
+ *
+ * Copyright (C) 2007 - 2026 Log4Qt contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+// Turns files written with Log4Qt::BinaryLayout back into text:
+//
+//   log4qt-decode [--pattern <pattern> | --json [--pretty]] [-o <file>] <file>...
+//
+// --json writes JSON Lines, one compact object per event. With --pretty the
+// objects are indented and written as one JSON array instead.
+
+#include "log4qt/binarylayout.h"
+#include "log4qt/jsonlayout.h"
+#include "log4qt/patternlayout.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QFile>
+
+#include <cstdio>
+#include <memory>
+
+using namespace Qt::StringLiterals;
+
+int main(int argc, char *argv[])
+{
+    // Decoding creates the loggers named in the files; keep the default
+    // initialisation from picking up a configuration of the current directory
+    qputenv("LOG4QT_DEFAULTINITOVERRIDE", "true");
+
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName(u"log4qt-decode"_s);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(u"Converts files written with Log4Qt's BinaryLayout to text."_s);
+    parser.addHelpOption();
+    const QCommandLineOption patternOption(u"pattern"_s,
+                                           u"Formats the events with a PatternLayout conversion pattern."_s,
+                                           u"pattern"_s,
+                                           u"%d{ISO8601} [%t] %-5p %c %x - %m%n"_s);
+    const QCommandLineOption jsonOption(u"json"_s, u"Formats the events as JSON Lines."_s);
+    const QCommandLineOption prettyOption(u"pretty"_s,
+                                          u"With --json, writes one indented JSON array instead of JSON Lines."_s);
+    const QCommandLineOption outputOption({u"o"_s, u"output"_s},
+                                          u"Writes to <file> instead of standard output."_s,
+                                          u"file"_s);
+    parser.addOptions({patternOption, jsonOption, prettyOption, outputOption});
+    parser.addPositionalArgument(u"files"_s, u"The binary log files to decode."_s, u"<file>..."_s);
+    parser.process(app);
+
+    const QStringList files = parser.positionalArguments();
+    if (files.isEmpty())
+        parser.showHelp(1);
+    if (parser.isSet(jsonOption) && parser.isSet(patternOption))
+    {
+        std::fprintf(stderr, "--json and --pattern cannot be combined\n");
+        return 1;
+    }
+    if (parser.isSet(prettyOption) && !parser.isSet(jsonOption))
+    {
+        std::fprintf(stderr, "--pretty requires --json\n");
+        return 1;
+    }
+    const bool array = parser.isSet(prettyOption);
+
+    std::unique_ptr<Log4Qt::AbstractStringLayout> layout;
+    if (parser.isSet(jsonOption))
+    {
+        auto json = std::make_unique<Log4Qt::JsonLayout>();
+        json->setIncludeNdc(true);
+        json->setIncludeMdc(true);
+        json->setIncludeLocation(true);
+        json->setPrettyPrint(parser.isSet(prettyOption));
+        layout = std::move(json);
+    }
+    else
+    {
+        layout = std::make_unique<Log4Qt::PatternLayout>(parser.value(patternOption));
+    }
+    layout->activateOptions();
+
+    QFile output;
+    bool opened;
+    if (parser.isSet(outputOption))
+    {
+        output.setFileName(parser.value(outputOption));
+        opened = output.open(QIODevice::WriteOnly | QIODevice::Truncate);
+    }
+    else
+    {
+        opened = output.open(stdout, QIODevice::WriteOnly);
+    }
+    if (!opened)
+    {
+        std::fprintf(stderr, "Cannot open output: %s\n", qPrintable(output.errorString()));
+        return 1;
+    }
+
+    const QByteArray endOfLine = Log4Qt::AbstractLayout::endOfLine().toUtf8();
+    if (array)
+        output.write("[" + endOfLine);
+
+    int result = 0;
+    bool first = true;
+    QByteArray text;
+    for (const QString &fileName : files)
+    {
+        QFile file(fileName);
+        if (!file.open(QIODevice::ReadOnly))
+        {
+            std::fprintf(stderr, "%s: %s\n", qPrintable(fileName), qPrintable(file.errorString()));
+            result = 1;
+            continue;
+        }
+
+        Log4Qt::BinaryLogReader reader;
+        if (!reader.read(file.readAll()))
+        {
+            // Decode what precedes the damage, e.g. the output of a process
+            // that crashed while writing
+            std::fprintf(stderr, "%s: %s\n", qPrintable(fileName), qPrintable(reader.errorString()));
+            result = 1;
+        }
+        if (reader.unknownIdCount())
+        {
+            std::fprintf(stderr, "%s: %lld strings without definition, written as <unknown #id>\n",
+                         qPrintable(fileName), static_cast<long long>(reader.unknownIdCount()));
+            result = 1;
+        }
+        for (const Log4Qt::LoggingEvent &event : reader.events())
+        {
+            text.clear();
+            if (array && !first)
+                text += "," + endOfLine;
+            layout->formatTo(event, text);
+            // The separator goes right behind the object, not on its own line
+            if (array && text.endsWith(endOfLine))
+                text.chop(endOfLine.size());
+            output.write(text);
+            first = false;
+        }
+    }
+    if (array)
+        output.write((first ? QByteArray() : endOfLine) + "]" + endOfLine);
+    return result;
+}